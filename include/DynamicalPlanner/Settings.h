@@ -219,6 +219,9 @@ namespace DynamicalPlanner {
         bool useCostsHessianRegularization;
         double costsHessianRegularization;
 
+        //Hessians
+        bool useExactHessians; //If false, the Hessian expressions are never built and Ipopt approximates the Hessians with a limited-memory quasi-Newton method. False is supported only with IpoptInterface
+
     } SettingsStruct;
 }
 
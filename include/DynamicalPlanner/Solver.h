@@ -11,13 +11,26 @@
 #include <DynamicalPlanner/Settings.h>
 #include <DynamicalPlanner/State.h>
 #include <DynamicalPlanner/Control.h>
+#include <DynamicalPlanner/TrajectoryView.h>
 
 #include <iDynTree/Optimizer.h>
 #include <iDynTree/Integrator.h>
 
+#include <chrono>
+#include <future>
 #include <memory>
 
 namespace DynamicalPlanner {
+
+    enum class SolutionStatus {
+        NotSolved,
+        Solved,
+        Cancelled, //the last iterate is returned if the optimizer provides it, otherwise the previous solution is kept
+        DeadlineReached, //the last iterate is returned if the optimizer provides it, otherwise the previous solution is kept
+        IterationsLimitReached, //the last iterate is returned (real-time iterations mode). It is finite and satisfies the constraints within acceptable_constr_viol_tol
+        Failed
+    };
+
     class Solver;
 }
 
@@ -32,22 +45,52 @@ public:
 
     ~Solver();
 
-    bool specifySettings(const Settings& settings);
+    bool specifySettings(const Settings& settings); //Calling it again with the same model and floating base reuses the kinematic expressions derived by this object
+
+    bool updateSettings(const Settings& settings); //Patches the existing problem when only references, weights, tolerances or bounds changed, otherwise it calls specifySettings
 
     bool setInitialState(const State& initialState);
 
     bool setGuesses(std::shared_ptr<TimeVaryingState> stateGuesses, std::shared_ptr<TimeVaryingControl> controlGuesses);
 
+    bool setGuessesFromPreviousSolution(double elapsedTime); //Use the last solution, shifted by elapsedTime, as guess for the next solve. The tail of the horizon keeps the last value.
+
     bool setOptimizer(std::shared_ptr<iDynTree::optimization::Optimizer> optimizer);
 
     bool setIntegrator(std::shared_ptr<iDynTree::optimalcontrol::integrators::Integrator> integrationMethod);
 
     bool solve(std::vector<State>& optimalStates, std::vector<Control>& optimalControls);
 
-    const std::vector<State>& optimalStates() const; //Call these methods also to allocate memory at configuration time
+    bool solve(); //The solution is not converted. Access it through the views below, or through optimalStates() and optimalControls().
+
+    //The solution is available through optimalStates() and optimalControls() once the future is ready.
+    //Until then, do not read the solution. The methods modifying the problem fail, and a second call returns a future with SolutionStatus::Failed.
+    //As with std::async, the destructor of the returned future blocks until the solve ends.
+    //The Solver is expected to outlive the future. If it does not, the Solver destructor cancels the solve and waits for it.
+    std::future<SolutionStatus> solveAsync(const std::chrono::steady_clock::time_point& deadline = std::chrono::steady_clock::time_point::max());
+
+    void cancel(); //The optimizer stops at the next iteration, and the last iterate is returned
+
+    SolutionStatus lastSolutionStatus() const;
+
+    //Warm start the optimizer also with the multipliers of the last solve (only IpoptInterface for the time being).
+    //The multipliers are used only after setGuessesFromPreviousSolution without time shift, since they cannot be shifted.
+    //The solver sets the Ipopt option warm_start_init_point before every solve, so it should not be set by hand.
+    void usePrimalDualWarmStart(bool useIt);
+
+    //Perform only the specified number of iterations per solve (0 to disable), starting from the multipliers of the last solve if there is no time shift.
+    //Use it together with setGuessesFromPreviousSolution. Only IpoptInterface for the time being.
+    bool setRealTimeIterations(unsigned int iterationsPerSolve);
+
+    const std::vector<State>& optimalStates() const; //Empty until a solution is available. The memory is allocated in specifySettings
 
     const std::vector<Control>& optimalControls() const;
 
+    //Views on the solution stored in the solver. No copies nor allocations. They are valid until the next call to solve or specifySettings.
+    const StateTrajectoryView& optimalStatesView() const;
+
+    const ControlTrajectoryView& optimalControlsView() const;
+
 };
 
 #endif // DPLANNER_SOLVER_H
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+#ifndef DPLANNER_TRAJECTORY_H
+#define DPLANNER_TRAJECTORY_H
+
+#include <DynamicalPlanner/State.h>
+#include <DynamicalPlanner/Control.h>
+
+#include <iDynTree/Core/Span.h>
+#include <vector>
+
+namespace DynamicalPlanner {
+    class TrajectoryBuffer;
+    class StateTrajectory;
+    class ControlTrajectory;
+}
+
+/**
+ * Single buffer shared by StateTrajectory and ControlTrajectory. Each quantity is contiguous over time,
+ * i.e. the values of a quantity at knot k+1 follow those at knot k.
+ * The per-knot methods return the values of a quantity at a given knot, the "OverTime" methods
+ * return the values at all the knots. The spans are valid until the next resize.
+ */
+class DynamicalPlanner::TrajectoryBuffer {
+
+protected:
+
+    typedef struct {
+        size_t offset, dimension;
+    } Quantity;
+
+    std::vector<double> m_buffer;
+    size_t m_numberOfKnots, m_numberOfDofs, m_numberOfPoints;
+    Quantity m_time;
+
+    TrajectoryBuffer();
+
+    ~TrajectoryBuffer();
+
+    void setDimensions(size_t numberOfKnots, size_t numberOfDofs, size_t numberOfPoints);
+
+    Quantity addQuantity(size_t dimension, size_t& offset) const; //offset is moved after the new quantity
+
+    void addPointsQuantities(size_t& offset, std::vector<Quantity>& first, std::vector<Quantity>& second) const; //two 3D quantities per point
+
+    void allocate(size_t& offset); //adds the time as last quantity and zeroes the buffer
+
+    iDynTree::Span<double> knotSpan(const Quantity& quantity, size_t knot);
+
+    iDynTree::Span<const double> knotSpan(const Quantity& quantity, size_t knot) const;
+
+    iDynTree::Span<const double> overTimeSpan(const Quantity& quantity) const;
+
+public:
+
+    void zero();
+
+    size_t size() const;
+
+    size_t numberOfDofs() const;
+
+    size_t numberOfPoints() const;
+
+    double& time(size_t knot);
+
+    double time(size_t knot) const;
+
+    iDynTree::Span<const double> timeOverTime() const; //size() elements
+};
+
+/**
+ * States over time, stored in a single buffer.
+ */
+class DynamicalPlanner::StateTrajectory : public DynamicalPlanner::TrajectoryBuffer {
+
+    std::vector<Quantity> m_leftPositions, m_leftForces, m_rightPositions, m_rightForces;
+    Quantity m_momentum, m_comPosition, m_basePosition, m_baseQuaternion, m_joints;
+
+public:
+
+    StateTrajectory();
+
+    StateTrajectory(size_t numberOfKnots, size_t numberOfDofs, size_t numberOfPoints);
+
+    void resize(size_t numberOfKnots, size_t numberOfDofs, size_t numberOfPoints); //Single allocation. The content is not preserved.
+
+    iDynTree::Span<double> leftPointPosition(size_t knot, size_t point);
+
+    iDynTree::Span<const double> leftPointPosition(size_t knot, size_t point) const;
+
+    iDynTree::Span<double> leftPointForce(size_t knot, size_t point);
+
+    iDynTree::Span<const double> leftPointForce(size_t knot, size_t point) const;
+
+    iDynTree::Span<double> rightPointPosition(size_t knot, size_t point);
+
+    iDynTree::Span<const double> rightPointPosition(size_t knot, size_t point) const;
+
+    iDynTree::Span<double> rightPointForce(size_t knot, size_t point);
+
+    iDynTree::Span<const double> rightPointForce(size_t knot, size_t point) const;
+
+    iDynTree::Span<double> momentumInCoM(size_t knot);
+
+    iDynTree::Span<const double> momentumInCoM(size_t knot) const;
+
+    iDynTree::Span<double> comPosition(size_t knot);
+
+    iDynTree::Span<const double> comPosition(size_t knot) const;
+
+    iDynTree::Span<double> basePosition(size_t knot);
+
+    iDynTree::Span<const double> basePosition(size_t knot) const;
+
+    iDynTree::Span<double> baseQuaternion(size_t knot);
+
+    iDynTree::Span<const double> baseQuaternion(size_t knot) const;
+
+    iDynTree::Span<double> jointsConfiguration(size_t knot);
+
+    iDynTree::Span<const double> jointsConfiguration(size_t knot) const;
+
+    iDynTree::Span<const double> leftPointPositionOverTime(size_t point) const; //3 * size() elements
+
+    iDynTree::Span<const double> leftPointForceOverTime(size_t point) const;
+
+    iDynTree::Span<const double> rightPointPositionOverTime(size_t point) const;
+
+    iDynTree::Span<const double> rightPointForceOverTime(size_t point) const;
+
+    iDynTree::Span<const double> momentumInCoMOverTime() const; //6 * size() elements
+
+    iDynTree::Span<const double> comPositionOverTime() const;
+
+    iDynTree::Span<const double> basePositionOverTime() const;
+
+    iDynTree::Span<const double> baseQuaternionOverTime() const; //4 * size() elements
+
+    iDynTree::Span<const double> jointsConfigurationOverTime() const; //numberOfDofs() * size() elements
+
+    bool setState(size_t knot, const State& input);
+
+    void getState(size_t knot, State& output) const; //No allocation if output has already the correct size
+
+    bool fromStates(const std::vector<State>& states); //All the states are expected to have the same size
+
+    void toStates(std::vector<State>& states) const; //No allocation if states has already the correct size
+};
+
+/**
+ * Controls over time, stored in a single buffer.
+ */
+class DynamicalPlanner::ControlTrajectory : public DynamicalPlanner::TrajectoryBuffer {
+
+    std::vector<Quantity> m_leftForceControls, m_leftVelocityControls, m_rightForceControls, m_rightVelocityControls;
+    Quantity m_baseLinearVelocity, m_baseQuaternionDerivative, m_jointsVelocity;
+
+public:
+
+    ControlTrajectory();
+
+    ControlTrajectory(size_t numberOfKnots, size_t numberOfDofs, size_t numberOfPoints);
+
+    void resize(size_t numberOfKnots, size_t numberOfDofs, size_t numberOfPoints); //Single allocation. The content is not preserved.
+
+    iDynTree::Span<double> leftPointForceControl(size_t knot, size_t point);
+
+    iDynTree::Span<const double> leftPointForceControl(size_t knot, size_t point) const;
+
+    iDynTree::Span<double> leftPointVelocityControl(size_t knot, size_t point);
+
+    iDynTree::Span<const double> leftPointVelocityControl(size_t knot, size_t point) const;
+
+    iDynTree::Span<double> rightPointForceControl(size_t knot, size_t point);
+
+    iDynTree::Span<const double> rightPointForceControl(size_t knot, size_t point) const;
+
+    iDynTree::Span<double> rightPointVelocityControl(size_t knot, size_t point);
+
+    iDynTree::Span<const double> rightPointVelocityControl(size_t knot, size_t point) const;
+
+    iDynTree::Span<double> baseLinearVelocity(size_t knot);
+
+    iDynTree::Span<const double> baseLinearVelocity(size_t knot) const;
+
+    iDynTree::Span<double> baseQuaternionDerivative(size_t knot);
+
+    iDynTree::Span<const double> baseQuaternionDerivative(size_t knot) const;
+
+    iDynTree::Span<double> jointsVelocity(size_t knot);
+
+    iDynTree::Span<const double> jointsVelocity(size_t knot) const;
+
+    iDynTree::Span<const double> leftPointForceControlOverTime(size_t point) const; //3 * size() elements
+
+    iDynTree::Span<const double> leftPointVelocityControlOverTime(size_t point) const;
+
+    iDynTree::Span<const double> rightPointForceControlOverTime(size_t point) const;
+
+    iDynTree::Span<const double> rightPointVelocityControlOverTime(size_t point) const;
+
+    iDynTree::Span<const double> baseLinearVelocityOverTime() const;
+
+    iDynTree::Span<const double> baseQuaternionDerivativeOverTime() const; //4 * size() elements
+
+    iDynTree::Span<const double> jointsVelocityOverTime() const; //numberOfDofs() * size() elements
+
+    bool setControl(size_t knot, const Control& input);
+
+    void getControl(size_t knot, Control& output) const; //No allocation if output has already the correct size
+
+    bool fromControls(const std::vector<Control>& controls); //All the controls are expected to have the same size
+
+    void toControls(std::vector<Control>& controls) const; //No allocation if controls has already the correct size
+};
+
+#endif // DPLANNER_TRAJECTORY_H
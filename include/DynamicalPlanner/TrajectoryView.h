@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+#ifndef DPLANNER_TRAJECTORYVIEW_H
+#define DPLANNER_TRAJECTORYVIEW_H
+
+#include <DynamicalPlanner/State.h>
+#include <DynamicalPlanner/Control.h>
+
+#include <iDynTree/Core/Utils.h>
+#include <iDynTree/Core/Span.h>
+#include <iDynTree/Core/VectorDynSize.h>
+#include <vector>
+
+namespace DynamicalPlanner {
+
+    namespace Private {
+        struct VariablesRanges; //Layout of the solver variables, defined in a private header
+    }
+
+    class StateTrajectoryView;
+    class ControlTrajectoryView;
+}
+
+/**
+ * Read-only view on the optimal states, as stored in the solver (one vector per knot).
+ * It does not copy nor allocate. It is valid until the next call to Solver::solve or Solver::specifySettings.
+ */
+class DynamicalPlanner::StateTrajectoryView {
+
+    const std::vector<iDynTree::VectorDynSize>* m_knots;
+    const std::vector<double>* m_timings;
+    const Private::VariablesRanges* m_ranges;
+
+    iDynTree::Span<const double> segment(size_t knot, const iDynTree::IndexRange& range) const;
+
+public:
+
+    StateTrajectoryView();
+
+    StateTrajectoryView(const std::vector<iDynTree::VectorDynSize>& knots, const std::vector<double>& timings, const Private::VariablesRanges& ranges);
+
+    size_t size() const;
+
+    double time(size_t knot) const;
+
+    const iDynTree::VectorDynSize& rawKnot(size_t knot) const;
+
+    iDynTree::Span<const double> leftPointPosition(size_t knot, size_t point) const;
+
+    iDynTree::Span<const double> leftPointForce(size_t knot, size_t point) const;
+
+    iDynTree::Span<const double> rightPointPosition(size_t knot, size_t point) const;
+
+    iDynTree::Span<const double> rightPointForce(size_t knot, size_t point) const;
+
+    iDynTree::Span<const double> momentumInCoM(size_t knot) const;
+
+    iDynTree::Span<const double> comPosition(size_t knot) const;
+
+    iDynTree::Span<const double> basePosition(size_t knot) const;
+
+    iDynTree::Span<const double> baseQuaternion(size_t knot) const; //Not normalized
+
+    iDynTree::Span<const double> jointsConfiguration(size_t knot) const;
+
+    void toState(size_t knot, State& output) const; //No allocation if output has already the correct size
+};
+
+/**
+ * Read-only view on the optimal controls, as stored in the solver (one vector per knot).
+ * It does not copy nor allocate. It is valid until the next call to Solver::solve or Solver::specifySettings.
+ */
+class DynamicalPlanner::ControlTrajectoryView {
+
+    const std::vector<iDynTree::VectorDynSize>* m_knots;
+    const std::vector<double>* m_timings;
+    const Private::VariablesRanges* m_ranges;
+
+    iDynTree::Span<const double> segment(size_t knot, const iDynTree::IndexRange& range) const;
+
+public:
+
+    ControlTrajectoryView();
+
+    ControlTrajectoryView(const std::vector<iDynTree::VectorDynSize>& knots, const std::vector<double>& timings, const Private::VariablesRanges& ranges);
+
+    size_t size() const;
+
+    double time(size_t knot) const;
+
+    const iDynTree::VectorDynSize& rawKnot(size_t knot) const;
+
+    iDynTree::Span<const double> leftPointForceControl(size_t knot, size_t point) const;
+
+    iDynTree::Span<const double> leftPointVelocityControl(size_t knot, size_t point) const;
+
+    iDynTree::Span<const double> rightPointForceControl(size_t knot, size_t point) const;
+
+    iDynTree::Span<const double> rightPointVelocityControl(size_t knot, size_t point) const;
+
+    iDynTree::Span<const double> baseLinearVelocity(size_t knot) const;
+
+    iDynTree::Span<const double> baseQuaternionDerivative(size_t knot) const;
+
+    iDynTree::Span<const double> jointsVelocity(size_t knot) const;
+
+    void toControl(size_t knot, Control& output) const; //No allocation if output has already the correct size
+};
+
+#endif // DPLANNER_TRAJECTORYVIEW_H
@@ -10,7 +10,9 @@
 #include <DynamicalPlannerPrivate/Constraints/CentroidalMomentumConstraint.h>
 #include <DynamicalPlannerPrivate/Constraints/CoMPositionConstraint.h>
 #include <DynamicalPlannerPrivate/Constraints/ContactForceControlConstraints.h>
+#include <DynamicalPlannerPrivate/Constraints/FootContactForceControlConstraints.h>
 #include <DynamicalPlannerPrivate/Constraints/ContactFrictionConstraint.h>
+#include <DynamicalPlannerPrivate/Constraints/FootContactFrictionConstraints.h>
 #include <DynamicalPlannerPrivate/Constraints/ContactPositionConsistencyConstraint.h>
 #include <DynamicalPlannerPrivate/Constraints/NormalVelocityControlConstraints.h>
 #include <DynamicalPlannerPrivate/Constraints/PlanarVelocityControlConstraints.h>
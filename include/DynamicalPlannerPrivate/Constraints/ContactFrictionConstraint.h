@@ -10,6 +10,7 @@
 #include <iDynTree/Constraint.h>
 #include <iDynTree/SparsityStructure.h>
 #include <DynamicalPlannerPrivate/Utilities/VariablesLabeller.h>
+#include <DynamicalPlannerPrivate/Utilities/VariablesLayout.h>
 #include <iDynTree/Core/Position.h>
 #include <memory>
 #include <string>
@@ -28,7 +29,7 @@ class DynamicalPlanner::Private::ContactFrictionConstraint : public iDynTree::op
 public:
 
     ContactFrictionConstraint(const VariablesLabeller& stateVariables, const VariablesLabeller& controlVariables,
-                              const std::string &footName, size_t contactIndex);
+                              const FootRanges& footRanges, const std::string &footName, size_t contactIndex);
 
     ~ContactFrictionConstraint() override;
 
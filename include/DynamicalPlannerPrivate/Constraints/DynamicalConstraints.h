@@ -11,10 +11,12 @@
 #include <iDynTree/Core/VectorDynSize.h>
 #include <iDynTree/Core/Position.h>
 #include <DynamicalPlannerPrivate/Utilities/VariablesLabeller.h>
+#include <DynamicalPlannerPrivate/Utilities/VariablesLayout.h>
 #include <DynamicalPlannerPrivate/Utilities/TimelySharedKinDynComputations.h>
 #include <DynamicalPlannerPrivate/Utilities/ExpressionsServer.h>
 #include <DynamicalPlannerPrivate/Utilities/HyperbolicTangent.h>
 #include <DynamicalPlannerPrivate/Utilities/HyperbolicSecant.h>
+#include <DynamicalPlannerPrivate/Utilities/SolverInterruption.h>
 #include <iDynTree/SparsityStructure.h>
 #include <memory>
 
@@ -31,7 +33,7 @@ class DynamicalPlanner::Private::DynamicalConstraints : public iDynTree::optimal
 
 public:
 
-    DynamicalConstraints(const VariablesLabeller& stateVariables, const VariablesLabeller& controlVariables,
+    DynamicalConstraints(const VariablesLabeller& stateVariables, const VariablesLabeller& controlVariables, const VariablesRanges& ranges,
                          std::shared_ptr<TimelySharedKinDynComputations> timelySharedKinDyn,
                          std::shared_ptr<ExpressionsServer> expressionsServer,
                          const DynamicalPlanner::Private::HyperbolicTangent &planarVelocityActivation,
@@ -39,6 +41,8 @@ public:
 
     ~DynamicalConstraints() override;
 
+    void setInterruption(std::shared_ptr<const SolverInterruption> interruption);
+
     virtual bool dynamics(const iDynTree::VectorDynSize& state, double time,
                           iDynTree::VectorDynSize& stateDynamics) override;
 
@@ -11,6 +11,7 @@
 #include <iDynTree/Core/VectorDynSize.h>
 #include <iDynTree/Core/MatrixDynSize.h>
 #include <DynamicalPlannerPrivate/Utilities/VariablesLabeller.h>
+#include <DynamicalPlannerPrivate/Utilities/VariablesLayout.h>
 #include <DynamicalPlannerPrivate/Utilities/TimelySharedKinDynComputations.h>
 #include <memory>
 
@@ -27,7 +28,7 @@ class DynamicalPlanner::Private::StaticTorquesCost : public iDynTree::optimalcon
 
 public:
 
-    StaticTorquesCost(const VariablesLabeller& stateVariables, const VariablesLabeller& controlVariables,
+    StaticTorquesCost(const VariablesLabeller& stateVariables, const VariablesLabeller& controlVariables, const VariablesRanges& ranges,
                       std::shared_ptr<TimelySharedKinDynComputations> timelySharedKinDyn, const iDynTree::FrameIndex &leftFootFrame,
                       const iDynTree::FrameIndex &rightFootFrame, const std::vector<iDynTree::Position> &positionsInLeftFoot,
                       const std::vector<iDynTree::Position> &positionsInRightFoot);
@@ -9,8 +9,10 @@
 
 #include <levi/ForwardDeclarations.h>
 #include <DynamicalPlannerPrivate/Utilities/TimelySharedKinDynComputations.h>
+#include <DynamicalPlannerPrivate/Utilities/VectorsStamp.h>
 #include <DynamicalPlannerPrivate/Utilities/levi/TransformExpression.h>
 #include <memory>
+#include <vector>
 
 namespace DynamicalPlanner {
     namespace Private {
@@ -28,6 +30,17 @@ public:
 
     ~ExpressionsServer();
 
+    //Hash of the model structure, inertias, frames and floating base, i.e. of everything the expressions depend on.
+    static VariablesStamp modelStamp(const iDynTree::Model& model, const std::string& floatingBase);
+
+    //Keeps the expressions derived so far, in memory, for a new object with the same model stamp. It fails otherwise.
+    bool setTimelySharedKinDyn(std::shared_ptr<DynamicalPlanner::Private::TimelySharedKinDynComputations> timelySharedKinDyn);
+
+    //If false, the constraints and costs do not build their Hessian expressions, and their Hessian methods fail. True by default.
+    void enableHessians(bool enabled);
+
+    bool hessiansEnabled() const;
+
     bool updateRobotState(double time, const RobotState &currentState);
 
     bool updateRobotState(double time);
@@ -67,43 +80,81 @@ public:
     levi::Expression adjointTransform(const std::string& baseFrame,
                                        const std::string &targetFrame);
 
+    levi::Expression adjointTransform(iDynTree::FrameIndex baseFrame,
+                                      iDynTree::FrameIndex targetFrame);
+
     levi::Expression adjointTransformJointsDerivative(const std::string& baseFrame,
                                                       const std::string &targetFrame,
                                                       long column);
 
+    levi::Expression adjointTransformJointsDerivative(iDynTree::FrameIndex baseFrame,
+                                                      iDynTree::FrameIndex targetFrame,
+                                                      long column);
+
     levi::Expression adjointTransformWrench(const std::string& baseFrame,
                                              const std::string &targetFrame);
 
+    levi::Expression adjointTransformWrench(iDynTree::FrameIndex baseFrame,
+                                            iDynTree::FrameIndex targetFrame);
+
     levi::Expression adjointTransformWrenchJointsDerivative(const std::string& baseFrame,
                                                             const std::string &targetFrame,
                                                             long column);
 
+    levi::Expression adjointTransformWrenchJointsDerivative(iDynTree::FrameIndex baseFrame,
+                                                            iDynTree::FrameIndex targetFrame,
+                                                            long column);
+
     levi::Expression relativePosition(const std::string& baseFrame,
                                        const std::string &targetFrame);
 
+    levi::Expression relativePosition(iDynTree::FrameIndex baseFrame,
+                                      iDynTree::FrameIndex targetFrame);
+
     levi::Expression relativeQuaternion(const std::string& baseFrame,
                                          const std::string &targetFrame);
 
+    levi::Expression relativeQuaternion(iDynTree::FrameIndex baseFrame,
+                                        iDynTree::FrameIndex targetFrame);
+
     levi::Expression relativeRotation(const std::string& baseFrame,
                                        const std::string &targetFrame);
 
+    levi::Expression relativeRotation(iDynTree::FrameIndex baseFrame,
+                                      iDynTree::FrameIndex targetFrame);
+
     TransformExpression relativeTransform(const std::string& baseFrame,
                                            const std::string &targetFrame);
 
+    TransformExpression relativeTransform(iDynTree::FrameIndex baseFrame,
+                                          iDynTree::FrameIndex targetFrame);
+
     levi::Expression relativeLeftJacobian(const std::string& baseFrame,
                                            const std::string &targetFrame);
 
+    levi::Expression relativeLeftJacobian(iDynTree::FrameIndex baseFrame,
+                                          iDynTree::FrameIndex targetFrame);
+
     levi::Expression relativeVelocity(const std::string& baseFrame,
                                        const std::string &targetFrame);
 
+    levi::Expression relativeVelocity(iDynTree::FrameIndex baseFrame,
+                                      iDynTree::FrameIndex targetFrame);
+
     levi::Expression absoluteVelocity(const std::string &targetFrame,
                                       const levi::Variable &baseTwist);
 
+    levi::Expression absoluteVelocity(iDynTree::FrameIndex targetFrame,
+                                      const levi::Variable &baseTwist);
+
     levi::Expression absoluteVelocity(const std::string &targetFrame);
 
     levi::Expression absoluteVelocityJointsDerivative(const std::string &targetFrame,
                                                       const levi::Variable &baseTwist);
 
+    levi::Expression absoluteVelocityJointsDerivative(iDynTree::FrameIndex targetFrame,
+                                                      const levi::Variable &baseTwist);
+
 
     levi::Expression quaternionError(const std::string &desiredFrame,
                                       const levi::Variable& desiredQuaternion);
@@ -123,6 +174,13 @@ public:
 
     levi::Expression momentumInBaseJointsDoubleDerivative(const levi::Variable& baseTwist, long column);
 
+    //Sorted indices of the joints moving targetFrame with respect to baseFrame. The derivatives with respect to the other joints are structurally zero.
+    const std::vector<size_t>& chainJoints(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame);
+
+    //Returns an expression evaluating the input as a flat list of operations with preallocated buffers
+    //(the input itself if DPLANNER_SQUEEZE_EXPRESSIONS is not defined). To be used on the expressions evaluated at every iteration.
+    levi::Expression flatten(const levi::Expression& expression, const std::string& name);
+
 };
 
 #endif // DPLANNER_EXPRESSIONSSERVER_H
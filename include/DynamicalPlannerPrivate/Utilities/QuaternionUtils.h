@@ -10,6 +10,7 @@
 #include <iDynTree/Core/MatrixFixSize.h>
 #include <iDynTree/Core/VectorFixSize.h>
 #include <iDynTree/Core/Rotation.h>
+#include <iDynTree/Core/Span.h>
 
 namespace DynamicalPlanner {
     namespace Private {
@@ -26,6 +27,8 @@ namespace DynamicalPlanner {
 
         iDynTree::Vector4 NormalizedQuaternion(const iDynTree::Vector4& quaternion);
 
+        void NormalizedQuaternionOrIdentity(iDynTree::Span<const double> quaternion, iDynTree::Vector4& normalized); //A zero quaternion, e.g. a solution not computed yet, is mapped to the identity
+
         double QuaternionNorm(const iDynTree::Vector4 &quaternion);
 
         double QuaternionSquaredNorm(const iDynTree::Vector4& quaternion);
@@ -17,6 +17,7 @@
 #include <iDynTree/Model/LinkState.h>
 #include <iDynTree/Model/FreeFloatingState.h>
 #include <levi/ForwardDeclarations.h>
+#include <cstdint>
 #include <mutex>
 #include <vector>
 #include <memory>
@@ -26,6 +27,26 @@ namespace DynamicalPlanner {
         class SharedKinDynComputations;
         typedef std::shared_ptr<SharedKinDynComputations> SharedKinDynComputationsPointer;
 
+        //Version of a RobotState, set by SharedKinDynComputations::updateRobotState. It is not copied: a copy of a state is unversioned (0)
+        //and can be edited freely. A state edited in place after the update has to be updated again before being used in the queries.
+        class RobotStateVersion {
+            uint64_t m_value = 0;
+            friend class SharedKinDynComputations;
+        public:
+            RobotStateVersion() = default;
+
+            RobotStateVersion(const RobotStateVersion&) { }
+
+            RobotStateVersion& operator=(const RobotStateVersion&) {
+                m_value = 0;
+                return *this;
+            }
+
+            uint64_t value() const {
+                return m_value;
+            }
+        };
+
         typedef struct {
             iDynTree::Vector3 base_position;
             iDynTree::Vector4 base_quaternion;
@@ -33,6 +54,7 @@ namespace DynamicalPlanner {
             iDynTree::Vector3 base_linearVelocity;
             iDynTree::Vector4 base_quaternionVelocity;
             iDynTree::VectorDynSize s_dot;
+            RobotStateVersion version;
         } RobotState;
 
         typedef struct {
@@ -49,15 +71,20 @@ namespace DynamicalPlanner {
 
 class DynamicalPlanner::Private::SharedKinDynComputations {
 
+    class ModelData;
     class Data;
     std::unique_ptr<Data> m_data;
 
+    void resizeBuffers();
+
     void fillJointsInfo();
 
     void updateChildBuffersForMomentumDerivative();
 
     void computeChildStaticForceDerivative(const iDynTree::LinkWrenches &linkStaticForces);
 
+    void updateDirtyProperAccelerations(const iDynTree::VectorDynSize &jointsPosition);
+
     bool computeStaticForces(const RobotState &currentState, const iDynTree::LinkNetExternalWrenches &linkExtForces);
 
     bool sameStatePrivate(const RobotState& other) const;
@@ -69,7 +96,7 @@ public:
 
     SharedKinDynComputations();
 
-    SharedKinDynComputations(const SharedKinDynComputations& other);
+    SharedKinDynComputations(const SharedKinDynComputations& other); //The copy shares the model traversal and the joints topology with other
 
     SharedKinDynComputations(const SharedKinDynComputations&& other) = delete;
 
@@ -101,7 +128,9 @@ public:
 
     bool sameState(const RobotState& other) const;
 
-    bool updateRobotState(const RobotState &currentState);
+    bool updateRobotState(RobotState &currentState); //On success, currentState gets the version of the stored state, so that the queries with it need a single comparison
+
+    uint64_t stateVersion() const; //Increased at every update of the stored state. Versions are unique among all the SharedKinDynComputations objects.
 
     const RobotState &currentState() const;
 
@@ -112,7 +141,7 @@ public:
                                  iDynTree::FrameVelocityRepresentation trivialization =
                                     iDynTree::FrameVelocityRepresentation::MIXED_REPRESENTATION);
 
-    iDynTree::Transform getWorldTransform(const RobotState &currentState, std::string frameName);
+    iDynTree::Transform getWorldTransform(const RobotState &currentState, const std::string &frameName);
 
     iDynTree::Transform getWorldTransform(const RobotState &currentState, const iDynTree::FrameIndex frameIndex);
 
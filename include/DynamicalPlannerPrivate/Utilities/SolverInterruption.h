@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+#ifndef DPLANNER_SOLVERINTERRUPTION_H
+#define DPLANNER_SOLVERINTERRUPTION_H
+
+#include <atomic>
+#include <chrono>
+
+namespace DynamicalPlanner {
+    namespace Private {
+        class SolverInterruption;
+    }
+}
+
+class DynamicalPlanner::Private::SolverInterruption {
+
+    std::atomic<bool> m_cancelRequested;
+    std::atomic<std::chrono::steady_clock::rep> m_deadline;
+
+public:
+
+    SolverInterruption();
+
+    ~SolverInterruption();
+
+    void reset(); //removes both the cancellation request and the deadline
+
+    void setDeadline(const std::chrono::steady_clock::time_point& deadline);
+
+    void cancel(); //can be called from any thread
+
+    bool cancelRequested() const;
+
+    bool deadlineReached() const;
+
+    bool isInterrupted() const;
+};
+
+#endif // DPLANNER_SOLVERINTERRUPTION_H
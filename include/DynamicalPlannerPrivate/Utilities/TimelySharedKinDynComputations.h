@@ -26,12 +26,27 @@ class DynamicalPlanner::Private::TimelySharedKinDynComputations {
     SharedKinDynComputationsPointer m_sharedTemplate;
     std::vector<TimedSharedKinDyn> m_pointerContainer;
     bool m_timingsSet;
-    size_t m_previousIndex;
 
-    size_t getClosestIndex(double time);
+    //Uniform grid over the time table. Each bucket stores the index of the last knot whose time is not greater than the bucket start.
+    std::vector<size_t> m_buckets;
+    double m_bucketsOrigin;
+    double m_inverseBucketWidth;
+
+    void buildBuckets();
+
+    size_t getLowerIndex(double time) const; //index of the last knot with time not greater than the input (time inside the table)
+
+    size_t getClosestIndex(size_t lowerIndex, double time) const;
+
+    size_t getClosestIndex(double time) const;
 
 public:
 
+    class Cursor { //Caller-held hint. Consecutive queries falling in the same interval do not need the table lookup.
+        size_t m_lowerIndex = 0;
+        friend class TimelySharedKinDynComputations;
+    };
+
     TimelySharedKinDynComputations();
 
     ~TimelySharedKinDynComputations();
@@ -56,7 +71,9 @@ public:
 
     bool setTimings(const std::vector<double> &timings);
 
-    SharedKinDynComputationsPointer get(double time);
+    SharedKinDynComputationsPointer get(double time) const; //Reentrant. Different threads can query different times concurrently.
+
+    SharedKinDynComputationsPointer get(double time, Cursor& cursor) const; //The cursor should not be shared among threads.
 };
 
 
@@ -21,17 +21,26 @@ namespace DynamicalPlanner {
 }
 class DynamicalPlanner::Private::VariablesLabeller {
     iDynTree::VectorDynSize m_fullVector;
+    const double* m_wrappedData; //if not null, the values are read from here instead of m_fullVector. Set only by ScopedWrap
     std::vector<std::string> m_labelsList;
 
     typedef std::unordered_map<std::string, iDynTree::IndexRange> LabelMap;
     LabelMap m_labelMap;
 
+    const double* data() const;
+
 
 public:
+     class ScopedWrap;
+
      VariablesLabeller();
 
+     VariablesLabeller(const VariablesLabeller& other); //the copy stores the values it reads, it does not wrap
+
      ~VariablesLabeller();
 
+     VariablesLabeller& operator=(const VariablesLabeller& other);
+
      bool addLabel(const std::string& name, size_t dimension);
 
      iDynTree::IndexRange addLabelAndGetIndexRange(const std::string& name, size_t dimension);
@@ -58,6 +67,8 @@ public:
 
      DynamicalPlanner::Private::VariablesLabeller& operator=(const iDynTree::VectorDynSize& iDynVector);
 
+     bool isWrapping() const;
+
      iDynTree::IndexRange getIndexRange(const std::string& labelName) const;
 
      size_t numberOfLabels() const;
@@ -68,4 +79,25 @@ public:
 
 };
 
+/**
+ * Lets a VariablesLabeller read the values of vector without copying them, until the end of the scope.
+ * Meanwhile, the labeller can only be read, through the ScopedWrap or the const accessors. The non-const ones assert.
+ */
+class DynamicalPlanner::Private::VariablesLabeller::ScopedWrap {
+    VariablesLabeller& m_labeller;
+
+public:
+    ScopedWrap(VariablesLabeller& labeller, const iDynTree::VectorDynSize& vector);
+
+    ScopedWrap(const ScopedWrap& other) = delete;
+
+    ScopedWrap& operator=(const ScopedWrap& other) = delete;
+
+    ~ScopedWrap();
+
+    iDynTree::Span<const double> operator()(const iDynTree::IndexRange& indexRange) const;
+
+    iDynTree::Span<const double> operator()(const std::string& labelName) const;
+};
+
 #endif // DPLANNER_VARIABLESLABELLER_H
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+#ifndef DPLANNER_VARIABLESLAYOUT_H
+#define DPLANNER_VARIABLESLAYOUT_H
+
+#include <DynamicalPlannerPrivate/Utilities/VariablesLabeller.h>
+#include <iDynTree/Core/Utils.h>
+#include <string>
+#include <vector>
+
+namespace DynamicalPlanner {
+    namespace Private {
+
+        struct FootRanges {
+            std::vector<iDynTree::IndexRange> positionPoints, forcePoints, velocityControlPoints, forceControlPoints;
+        };
+
+        struct VariablesRanges {
+            FootRanges left, right;
+            iDynTree::IndexRange momentum, comPosition, basePosition;
+            iDynTree::IndexRange baseQuaternion, jointsPosition, baseLinearVelocity, baseQuaternionDerivative, jointsVelocity;
+        };
+
+        //Adds all the planner variables to the (empty) labellers and stores their ranges. The feet variables come first, one point after the other.
+        bool AddVariablesLayout(size_t numberOfDofs, size_t numberOfPoints, VariablesLabeller& stateVariables,
+                                VariablesLabeller& controlVariables, VariablesRanges& ranges);
+
+        //Number of contact points of the foot (footName is "Left" or "Right") available among the state variables
+        size_t NumberOfFootPoints(const VariablesLabeller& stateVariables, const std::string& footName);
+
+        bool GetFootRanges(const VariablesLabeller& stateVariables, const VariablesLabeller& controlVariables,
+                           const std::string& footName, FootRanges& foot);
+
+        //Recovers the ranges from labellers filled label by label, as in the tests. The solver passes to the constraints and costs
+        //the ranges computed by AddVariablesLayout instead, so that they use the integer offsets directly.
+        bool GetVariablesLayout(const VariablesLabeller& stateVariables, const VariablesLabeller& controlVariables, VariablesRanges& ranges);
+
+    }
+}
+
+#endif // DPLANNER_VARIABLESLAYOUT_H
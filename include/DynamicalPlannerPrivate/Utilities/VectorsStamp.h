@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+#ifndef DPLANNER_VECTORSSTAMP_H
+#define DPLANNER_VECTORSSTAMP_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace DynamicalPlanner {
+    namespace Private {
+
+        typedef uint64_t VariablesStamp; //0 means "not stamped"
+
+        inline VariablesStamp MixStamp(VariablesStamp seed, uint64_t value) {
+            uint64_t z = seed ^ (value + 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        template<typename VectorType>
+        VariablesStamp AddToStamp(VariablesStamp seed, const VectorType& vector) {
+            uint64_t bits;
+            for (unsigned int i = 0; i < vector.size(); ++i) {
+                double value = vector(i);
+                std::memcpy(&bits, &value, sizeof(double));
+                seed = MixStamp(seed, bits);
+            }
+            return MixStamp(seed, static_cast<uint64_t>(vector.size()));
+        }
+
+        inline VariablesStamp AddToStamp(VariablesStamp seed, double value) {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(double));
+            return MixStamp(seed, bits);
+        }
+
+        inline VariablesStamp AddToStamp(VariablesStamp seed) {
+            return seed;
+        }
+
+        template<typename VectorType, typename... OtherVectors>
+        VariablesStamp AddToStamp(VariablesStamp seed, const VectorType& vector, const OtherVectors&... others) {
+            return AddToStamp(AddToStamp(seed, vector), others...);
+        }
+
+        //Hash of the bit patterns of the inputs (vectors or doubles). Equal stamps mean (up to hash collisions) bitwise equal inputs.
+        template<typename... Vectors>
+        VariablesStamp VectorsStamp(const Vectors&... vectors) {
+            VariablesStamp stamp = AddToStamp(0, vectors...);
+            return (stamp != 0) ? stamp : 1;
+        }
+
+    }
+}
+
+#endif // DPLANNER_VECTORSSTAMP_H
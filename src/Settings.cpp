@@ -411,6 +411,8 @@ SettingsStruct Settings::Defaults(const iDynTree::Model &newModel)
     defaults.useCostsHessianRegularization = false;
     defaults.costsHessianRegularization = 0.0;
 
+    defaults.useExactHessians = true;
+
     //Left foot yaw cost
     defaults.leftFootYawCostActive = true;
     defaults.leftFootYawCostOverallWeight = 1.0;
@@ -12,19 +12,26 @@
 #include <DynamicalPlannerPrivate/Constraints.h>
 #include <DynamicalPlannerPrivate/Constraints/DynamicalConstraints.h>
 #include <DynamicalPlannerPrivate/Utilities/VariablesLabeller.h>
+#include <DynamicalPlannerPrivate/Utilities/VariablesLayout.h>
 #include <DynamicalPlannerPrivate/Utilities/TimelySharedKinDynComputations.h>
 #include <DynamicalPlannerPrivate/Utilities/ExpressionsServer.h>
 #include <DynamicalPlannerPrivate/Utilities/QuaternionUtils.h>
+#include <DynamicalPlannerPrivate/Utilities/SolverInterruption.h>
 
 #include <iDynTree/OptimalControlProblem.h>
+#include <iDynTree/OptimizationProblem.h>
 #include <iDynTree/OCSolvers/MultipleShootingSolver.h>
 #include <iDynTree/Integrators/ImplicitTrapezoidal.h>
 #include <iDynTree/Optimizers/IpoptInterface.h>
 #include <iDynTree/Core/EigenHelpers.h>
 #include <iDynTree/Core/Span.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
 
 using namespace DynamicalPlanner;
 using namespace DynamicalPlanner::Private;
@@ -35,10 +42,10 @@ typedef struct {
     std::shared_ptr<CoMPositionConstraint> comPosition;
     std::vector<std::shared_ptr<NormalVelocityControlConstraints>> leftNormalVelocityControl, rightNormalVelocityControl;
     std::vector<std::shared_ptr<PlanarVelocityControlConstraints>> leftPlanarVelocityControl, rightPlanarVelocityControl;
-    std::vector<std::shared_ptr<ContactForceControlConstraints>> leftContactsForceControl, rightContactsForceControl;
+    std::shared_ptr<FootContactForceControlConstraints> leftContactsForceControl, rightContactsForceControl; //all the points of a foot at once
     std::vector<std::shared_ptr<DynamicalComplementarityConstraint>> leftDynamicalComplementarity, rightDynamicalComplementarity;
     std::vector<std::shared_ptr<ClassicalComplementarityConstraint>> leftClassicalComplementarity, rightClassicalComplementarity;
-    std::vector<std::shared_ptr<ContactFrictionConstraint>> leftContactsFriction, rightContactsFriction;
+    std::shared_ptr<FootContactFrictionConstraints> leftContactsFriction, rightContactsFriction; //all the points of a foot at once
     std::vector<std::shared_ptr<ContactPositionConsistencyConstraint>> leftContactsPosition, rightContactsPosition;
     std::shared_ptr<FeetLateralDistanceConstraint> feetLateralDistance;
     std::shared_ptr<QuaternionNormConstraint> quaternionNorm;
@@ -68,16 +75,6 @@ typedef struct {
     std::shared_ptr<FrameAngularVelocityCost> frameAngularVelocity;
 } CostsSet;
 
-typedef struct {
-    std::vector<iDynTree::IndexRange> positionPoints, forcePoints, velocityControlPoints, forceControlPoints;
-} FootRanges;
-
-typedef struct {
-    FootRanges left, right;
-    iDynTree::IndexRange momentum, comPosition, basePosition;
-    iDynTree::IndexRange baseQuaternion, jointsPosition, baseLinearVelocity, baseQuaternionDerivative, jointsVelocity;
-} VariablesRanges;
-
 class StateGuesses : public iDynTree::optimalcontrol::TimeVaryingVector {
     std::shared_ptr<TimeVaryingState> m_originalGuesses;
     iDynTree::VectorDynSize m_buffer;
@@ -98,6 +95,10 @@ public:
 
     ~StateGuesses() override;
 
+    void setOriginalGuess(std::shared_ptr<TimeVaryingState> originalGuess) {
+        m_originalGuesses = originalGuess;
+    }
+
     const iDynTree::VectorDynSize &get(double time, bool &isValid) override {
 
         const State &desiredState = m_originalGuesses->get(time, isValid);
@@ -159,6 +160,10 @@ public:
 
     ~ControlGuesses() override;
 
+    void setOriginalGuess(std::shared_ptr<TimeVaryingControl> originalGuess) {
+        m_originalGuesses = originalGuess;
+    }
+
     const iDynTree::VectorDynSize &get(double time, bool &isValid) override {
 
         const Control &desiredControl = m_originalGuesses->get(time, isValid);
@@ -197,6 +202,67 @@ public:
 };
 ControlGuesses::~ControlGuesses() { }
 
+class PreviousSolutionGuesses : public iDynTree::optimalcontrol::TimeVaryingVector {
+    const std::vector<double>& m_timings;
+    const std::vector<iDynTree::VectorDynSize>& m_solution;
+    iDynTree::IndexRange m_quaternionRange;
+    iDynTree::VectorDynSize m_buffer;
+    double m_timeShift;
+
+public:
+
+    PreviousSolutionGuesses(const std::vector<double>& timings, const std::vector<iDynTree::VectorDynSize>& solution,
+                            const iDynTree::IndexRange& quaternionRange)
+        : m_timings(timings)
+        , m_solution(solution)
+        , m_quaternionRange(quaternionRange)
+        , m_timeShift(0.0)
+    { }
+
+    ~PreviousSolutionGuesses() override;
+
+    void setTimeShift(double timeShift) {
+        m_timeShift = timeShift;
+    }
+
+    const iDynTree::VectorDynSize &get(double time, bool &isValid) override {
+
+        if (m_timings.empty() || (m_timings.size() != m_solution.size())) {
+            std::cerr << "[ERROR][PreviousSolutionGuesses::get] No previous solution available." << std::endl;
+            isValid = false;
+            m_buffer.zero();
+            return m_buffer;
+        }
+
+        isValid = true;
+
+        double previousTime = time + m_timeShift;
+
+        if (previousTime <= m_timings.front()) {
+            return m_solution.front();
+        }
+
+        if (previousTime >= m_timings.back()) { //the tail is extrapolated by keeping the last value
+            return m_solution.back();
+        }
+
+        size_t next = static_cast<size_t>(std::upper_bound(m_timings.begin(), m_timings.end(), previousTime) - m_timings.begin());
+        size_t previous = next - 1;
+        double interval = m_timings[next] - m_timings[previous];
+        double alpha = (interval > 0) ? (previousTime - m_timings[previous]) / interval : 0.0;
+
+        m_buffer.resize(m_solution[previous].size());
+        iDynTree::toEigen(m_buffer) = (1.0 - alpha) * iDynTree::toEigen(m_solution[previous]) + alpha * iDynTree::toEigen(m_solution[next]);
+
+        if (m_quaternionRange.isValid()) {
+            iDynTree::toEigen(m_buffer).segment(m_quaternionRange.offset, m_quaternionRange.size).normalize();
+        }
+
+        return m_buffer;
+    }
+};
+PreviousSolutionGuesses::~PreviousSolutionGuesses() { }
+
 class VariableBound : public iDynTree::optimalcontrol::TimeVaryingVector {
     iDynTree::VectorDynSize m_firstBounds;
     iDynTree::VectorDynSize m_secondBounds;
@@ -270,6 +336,76 @@ public:
 };
 VariableBound::~VariableBound(){}
 
+template<typename VectorA, typename VectorB>
+bool sameVector(const VectorA& a, const VectorB& b) {
+    return (a.size() == b.size()) && (iDynTree::toEigen(a) == iDynTree::toEigen(b));
+}
+
+bool samePositions(const std::vector<iDynTree::Position>& a, const std::vector<iDynTree::Position>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!sameVector(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sameRange(const iDynTree::optimalcontrol::TimeRange& a, const iDynTree::optimalcontrol::TimeRange& b) {
+    return (a.initTime() == b.initTime()) && (a.endTime() == b.endTime());
+}
+
+bool sameModel(const iDynTree::Model& a, const iDynTree::Model& b) {
+    if ((a.getNrOfLinks() != b.getNrOfLinks()) || (a.getNrOfJoints() != b.getNrOfJoints()) ||
+        (a.getNrOfDOFs() != b.getNrOfDOFs()) || (a.getNrOfFrames() != b.getNrOfFrames())) {
+        return false;
+    }
+
+    for (iDynTree::LinkIndex l = 0; l < static_cast<iDynTree::LinkIndex>(a.getNrOfLinks()); ++l) {
+        if ((a.getLinkName(l) != b.getLinkName(l)) ||
+            (iDynTree::toEigen(a.getLink(l)->getInertia().asMatrix()) != iDynTree::toEigen(b.getLink(l)->getInertia().asMatrix()))) {
+            return false;
+        }
+    }
+
+    for (iDynTree::JointIndex j = 0; j < static_cast<iDynTree::JointIndex>(a.getNrOfJoints()); ++j) {
+        iDynTree::IJointConstPtr jointA = a.getJoint(j);
+        iDynTree::IJointConstPtr jointB = b.getJoint(j);
+        if ((a.getJointName(j) != b.getJointName(j)) || (jointA->getNrOfDOFs() != jointB->getNrOfDOFs()) ||
+            (jointA->getFirstAttachedLink() != jointB->getFirstAttachedLink()) ||
+            (jointA->getSecondAttachedLink() != jointB->getSecondAttachedLink())) {
+            return false;
+        }
+
+        iDynTree::Transform restA = jointA->getRestTransform(jointA->getFirstAttachedLink(), jointA->getSecondAttachedLink());
+        iDynTree::Transform restB = jointB->getRestTransform(jointB->getFirstAttachedLink(), jointB->getSecondAttachedLink());
+        if (iDynTree::toEigen(restA.asHomogeneousTransform()) != iDynTree::toEigen(restB.asHomogeneousTransform())) {
+            return false;
+        }
+
+        for (unsigned int dof = 0; dof < jointA->getNrOfDOFs(); ++dof) {
+            if (iDynTree::toEigen(jointA->getMotionSubspaceVector(dof, jointA->getSecondAttachedLink(), jointA->getFirstAttachedLink())) !=
+                iDynTree::toEigen(jointB->getMotionSubspaceVector(dof, jointB->getSecondAttachedLink(), jointB->getFirstAttachedLink()))) {
+                return false;
+            }
+        }
+    }
+
+    for (iDynTree::FrameIndex f = static_cast<iDynTree::FrameIndex>(a.getNrOfLinks());
+         f < static_cast<iDynTree::FrameIndex>(a.getNrOfFrames()); ++f) {
+        if ((a.getFrameName(f) != b.getFrameName(f)) || (a.getFrameLink(f) != b.getFrameLink(f)) ||
+            (iDynTree::toEigen(a.getFrameTransform(f).asHomogeneousTransform()) !=
+             iDynTree::toEigen(b.getFrameTransform(f).asHomogeneousTransform()))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 class Solver::Implementation {
 public:
     SettingsStruct settings;
@@ -287,9 +423,6 @@ public:
     VariablesLabeller stateStructure, controlStructure;
 
     VariablesRanges ranges;
-    iDynTree::Position basePositionBuffer;
-    iDynTree::Rotation baseRotationBuffer;
-    iDynTree::Vector4 baseQuaternion;
 
     iDynTree::VectorDynSize stateLowerBound, stateUpperBound, controlLowerBound, controlUpperBound, initialStateVector;
     iDynTree::VectorDynSize secondStateLowerBound, secondStateUpperBound, secondControlLowerBound, secondControlUpperBound;
@@ -298,68 +431,399 @@ public:
     State initialState;
     std::vector<State> optimalStates;
     std::vector<Control> optimalControls;
+    const std::vector<State> noStates; //returned before the first solve, when the stored solution is not meaningful yet
+    const std::vector<Control> noControls;
     std::vector<iDynTree::VectorDynSize> unstructuredOptimalStates;
     std::vector<iDynTree::VectorDynSize> unstructuredOptimalControl;
     std::vector<double> stateTimings;
     std::vector<double> controlTimings;
-
-    std::shared_ptr<StateGuesses> stateGuess;
-    std::shared_ptr<ControlGuesses> controlGuess;
+    StateTrajectoryView optimalStatesView;
+    ControlTrajectoryView optimalControlsView;
+    bool solutionVectorsUpdated;
+
+    std::shared_ptr<StateGuesses> stateGuess, stateGuessBuffer;
+    std::shared_ptr<ControlGuesses> controlGuess, controlGuessBuffer;
+
+    std::shared_ptr<PreviousSolutionGuesses> previousStateSolution;
+    std::shared_ptr<PreviousSolutionGuesses> previousControlSolution;
+    bool previousSolutionAvailable;
+    bool usePreviousSolution;
+    double previousSolutionElapsedTime;
+    double previousInitialTime;
+
+    bool multipliersAvailable; //IpoptInterface keeps the multipliers of its last solve, here we only track whether they refer to the current problem
+    bool usePrimalDualWarmStart;
+
+    unsigned int realTimeIterations;
+    int maximumIterationsBackup;
+    iDynTree::VectorDynSize lastIterate, lastConstraints, constraintsLowerBounds, constraintsUpperBounds; //to check the iterate of a real-time iteration
+    std::vector<iDynTree::VectorDynSize> iterateStates, iterateControls; //solution returned after a failed solve, stored only if it is the last iterate
+    std::vector<double> iterateStateTimings, iterateControlTimings;
+    std::vector<double> sortedIterate, sortedSolution;
+
+    std::shared_ptr<SolverInterruption> interruption;
+    std::atomic<SolutionStatus> solutionStatus;
+    std::atomic<bool> running; //true from the call to solve or solveAsync until the solution has been stored
+    std::mutex runningMutex;
+    std::condition_variable runningCondition; //notified when running is set to false
+    bool hessiansApproximationForced; //the Hessian approximation has been enabled in the optimizer because useExactHessians is false
 
     bool prepared;
 
+    bool notRunning(const std::string& methodName) const {
+        if (running) {
+            std::cerr << "[ERROR][Solver::" << methodName << "] The solver is running. Wait for the future returned by solveAsync first." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool startRunning(const std::string& methodName) {
+        bool expected = false;
+        if (!running.compare_exchange_strong(expected, true)) {
+            std::cerr << "[ERROR][Solver::" << methodName << "] The solver is running. Wait for the future returned by solveAsync first." << std::endl;
+            return false;
+        }
+        return true;
+    }
 
-    bool setVariablesStructure(size_t numberOfDofs, size_t numberOfPoints) {
+    void stopRunning() {
+        std::lock_guard<std::mutex> lock(runningMutex);
+        running = false;
+        runningCondition.notify_all(); //notified with the lock held, the destructor cannot free the condition variable before the call returns
+    }
 
-        stateStructure.clear();
-        controlStructure.clear();
+    void waitUntilStopped() {
+        std::unique_lock<std::mutex> lock(runningMutex);
+        runningCondition.wait(lock, [this](){ return !running; });
+    }
 
-        setFootVariables("Left", numberOfPoints, ranges.left);
-        setFootVariables("Right", numberOfPoints, ranges.right);
 
-        ranges.momentum = stateStructure.addLabelAndGetIndexRange("Momentum", 6);
-        if (!ranges.momentum.isValid()) {
-            return false;
+    bool needsNewStructure(const SettingsStruct& st) const { //true if the new settings cannot be applied to the existing costs and constraints
+        const SettingsStruct& old = settings;
+
+        //Timings
+        if ((old.minimumDt != st.minimumDt) || (old.maximumDt != st.maximumDt) || (old.controlPeriod != st.controlPeriod) ||
+            (old.horizon != st.horizon) || (old.activeControlPercentage != st.activeControlPercentage)) {
+            return true;
+        }
+
+        //Robot and contact points
+        if (!sameModel(old.robotModel, st.robotModel) || !sameVector(old.gravity, st.gravity) || (old.updateTolerance != st.updateTolerance) ||
+            (old.floatingBaseName != st.floatingBaseName) || !samePositions(old.leftPointsPosition, st.leftPointsPosition) ||
+            !samePositions(old.rightPointsPosition, st.rightPointsPosition) || (old.leftFrameName != st.leftFrameName) ||
+            (old.rightFrameName != st.rightFrameName)) {
+            return true;
+        }
+
+        //Parameters passed to the constraints at construction time
+        if ((old.complementarity != st.complementarity) || !sameVector(old.forceMaximumDerivative, st.forceMaximumDerivative) ||
+            (old.normalForceDissipationRatio != st.normalForceDissipationRatio) ||
+            (old.normalForceHyperbolicSecantScaling != st.normalForceHyperbolicSecantScaling) ||
+            (old.complementarityDissipation != st.complementarityDissipation) ||
+            (old.dynamicComplementarityUpperBound != st.dynamicComplementarityUpperBound) ||
+            (old.classicalComplementarityTolerance != st.classicalComplementarityTolerance) ||
+            !sameVector(old.velocityMaximumDerivative, st.velocityMaximumDerivative) ||
+            (old.planarVelocityHyperbolicTangentScaling != st.planarVelocityHyperbolicTangentScaling) ||
+            (old.normalVelocityHyperbolicSecantScaling != st.normalVelocityHyperbolicSecantScaling) ||
+            (old.contactVelocityControlConstraintsAsSeparateConstraints != st.contactVelocityControlConstraintsAsSeparateConstraints) ||
+            (old.indexOfLateralDirection != st.indexOfLateralDirection) ||
+            (old.referenceFrameNameForFeetDistance != st.referenceFrameNameForFeetDistance) ||
+            (old.otherFrameNameForFeetDistance != st.otherFrameNameForFeetDistance) ||
+            (old.feetMaximumRelativeHeight != st.feetMaximumRelativeHeight)) {
+            return true;
+        }
+
+        //Costs activation, overall weights and active ranges are stored in the optimal control problem
+        if ((old.comCostActive != st.comCostActive) || (old.comCostOverallWeight != st.comCostOverallWeight) ||
+            !sameRange(old.comCostActiveRange, st.comCostActiveRange) ||
+            (old.comVelocityCostActive != st.comVelocityCostActive) || (old.comVelocityCostOverallWeight != st.comVelocityCostOverallWeight) ||
+            !sameRange(old.comVelocityCostActiveRange, st.comVelocityCostActiveRange) ||
+            (old.frameCostActive != st.frameCostActive) || (old.frameCostOverallWeight != st.frameCostOverallWeight) ||
+            (old.frameForOrientationCost != st.frameForOrientationCost) ||
+            (old.forceMeanCostActive != st.forceMeanCostActive) || (old.forceMeanCostOverallWeight != st.forceMeanCostOverallWeight) ||
+            (old.forceRatioCostActive != st.forceRatioCostActive) ||
+            (old.jointsRegularizationCostActive != st.jointsRegularizationCostActive) ||
+            (old.jointsRegularizationCostOverallWeight != st.jointsRegularizationCostOverallWeight) ||
+            (old.jointsVelocityCostActive != st.jointsVelocityCostActive) ||
+            (old.jointsVelocityCostOverallWeight != st.jointsVelocityCostOverallWeight) ||
+            (old.staticTorquesCostActive != st.staticTorquesCostActive) ||
+            (old.staticTorquesCostOverallWeight != st.staticTorquesCostOverallWeight) ||
+            (old.forceDerivativeCostActive != st.forceDerivativeCostActive) ||
+            (old.forceDerivativesCostOverallWeight != st.forceDerivativesCostOverallWeight) ||
+            (old.pointAccelerationCostActive != st.pointAccelerationCostActive) ||
+            (old.pointAccelerationCostOverallWeight != st.pointAccelerationCostOverallWeight) ||
+            (old.swingCostActive != st.swingCostActive) || (old.swingCostOverallWeight != st.swingCostOverallWeight) ||
+            (old.desiredSwingHeight != st.desiredSwingHeight) || !sameVector(old.swingCostWeights, st.swingCostWeights) ||
+            (old.phantomForcesCostActive != st.phantomForcesCostActive) ||
+            (old.phantomForcesCostOverallWeight != st.phantomForcesCostOverallWeight) ||
+            (old.meanPointPositionCostActive != st.meanPointPositionCostActive) ||
+            (old.meanPointPositionCostOverallWeight != st.meanPointPositionCostOverallWeight) ||
+            !sameRange(old.meanPointPositionCostActiveRange, st.meanPointPositionCostActiveRange) ||
+            (old.leftFootYawCostActive != st.leftFootYawCostActive) || (old.leftFootYawCostOverallWeight != st.leftFootYawCostOverallWeight) ||
+            (old.rightFootYawCostActive != st.rightFootYawCostActive) ||
+            (old.rightFootYawCostOverallWeight != st.rightFootYawCostOverallWeight) ||
+            (old.feetDistanceCostActive != st.feetDistanceCostActive) || (old.feetDistanceCostOverallWeight != st.feetDistanceCostOverallWeight) ||
+            (old.jointsVelocityForPosturalCostActive != st.jointsVelocityForPosturalCostActive) ||
+            (old.jointsVelocityForPosturalCostOverallWeight != st.jointsVelocityForPosturalCostOverallWeight) ||
+            (old.complementarityCostActive != st.complementarityCostActive) ||
+            (old.complementarityCostOverallWeight != st.complementarityCostOverallWeight) ||
+            (old.basePositionCostActive != st.basePositionCostActive) ||
+            (old.basePositionCostOverallWeight != st.basePositionCostOverallWeight) ||
+            !sameRange(old.basePositionCostActiveRange, st.basePositionCostActiveRange) ||
+            (old.baseQuaternionCostActive != st.baseQuaternionCostActive) ||
+            (old.baseQuaternionCostOverallWeight != st.baseQuaternionCostOverallWeight) ||
+            (old.frameAngularVelocityCostActive != st.frameAngularVelocityCostActive) ||
+            (old.frameAngularVelocityCostOverallWeight != st.frameAngularVelocityCostOverallWeight) ||
+            (old.rotationalPIDgain != st.rotationalPIDgain)) {
+            return true;
+        }
+
+        //JointsVelocityForPosturalCost copies weights and references at construction time
+        if (st.jointsVelocityForPosturalCostActive &&
+            (!sameVector(old.jointsVelocityCostWeights, st.jointsVelocityCostWeights) ||
+             !sameVector(old.jointsRegularizationWeights, st.jointsRegularizationWeights) ||
+             (old.desiredJointsTrajectory != st.desiredJointsTrajectory))) {
+            return true;
         }
 
-        ranges.comPosition = stateStructure.addLabelAndGetIndexRange("CoMPosition", 3);
-        if (!ranges.comPosition.isValid()) {
+        return false;
+    }
+
+    bool updateCostsAndConstraints(const SettingsStruct& st) {
+        bool ok = true;
+
+        if (st.comCostActive) {
+            ok = ok && costs.comPosition->setStateWeight(st.comWeights);
+            ok = ok && costs.comPosition->setStateDesiredTrajectory(st.desiredCoMTrajectory);
+        }
+
+        if (st.comVelocityCostActive) {
+            ok = ok && costs.comVelocity->setStateWeight(st.comVelocityWeights);
+            costs.comVelocity->setLinearVelocityReference(st.desiredCoMVelocityTrajectory);
+        }
+
+        if (st.frameCostActive) {
+            ok = ok && costs.frameOrientation->setDesiredRotationTrajectory(st.desiredRotationTrajectory);
+        }
+
+        if (st.forceRatioCostActive) {
+            for (size_t i = 0; i < costs.leftForceRatios.size(); ++i) {
+                costs.leftForceRatios[i]->setDesiredRatio(st.desiredLeftRatios[i]);
+            }
+            for (size_t i = 0; i < costs.rightForceRatios.size(); ++i) {
+                costs.rightForceRatios[i]->setDesiredRatio(st.desiredRightRatios[i]);
+            }
+        }
+
+        if (st.jointsRegularizationCostActive) {
+            ok = ok && costs.jointsRegularization->setStateWeight(st.jointsRegularizationWeights);
+            ok = ok && costs.jointsRegularization->setStateDesiredTrajectory(st.desiredJointsTrajectory);
+        }
+
+        if (st.jointsVelocityCostActive) {
+            ok = ok && costs.jointsVelocity->setControlWeight(st.jointsVelocityCostWeights);
+            ok = ok && costs.jointsVelocity->setControlDesiredTrajectory(st.desiredJointsVelocityTrajectory);
+        }
+
+        if (st.staticTorquesCostActive) {
+            ok = ok && costs.staticTorques->setWeights(st.staticTorquesCostWeights);
+        }
+
+        if (st.forceDerivativeCostActive) {
+            for (auto& cost : costs.leftPointsForceDerivative) {
+                ok = ok && cost->setControlWeight(st.forceDerivativeWeights);
+                ok = ok && cost->setControlDesiredTrajectory(st.desiredForceDerivativeTrajectory);
+            }
+            for (auto& cost : costs.rightPointsForceDerivative) {
+                ok = ok && cost->setControlWeight(st.forceDerivativeWeights);
+                ok = ok && cost->setControlDesiredTrajectory(st.desiredForceDerivativeTrajectory);
+            }
+        }
+
+        if (st.pointAccelerationCostActive) {
+            for (auto& cost : costs.leftPointsAcceleration) {
+                ok = ok && cost->setControlWeight(st.pointAccelerationWeights);
+                ok = ok && cost->setControlDesiredTrajectory(st.desiredPointAccelerationTrajectory);
+            }
+            for (auto& cost : costs.rightPointsAcceleration) {
+                ok = ok && cost->setControlWeight(st.pointAccelerationWeights);
+                ok = ok && cost->setControlDesiredTrajectory(st.desiredPointAccelerationTrajectory);
+            }
+        }
+
+        if (st.meanPointPositionCostActive) {
+            ok = ok && costs.meanPositionCost->setDesiredPositionTrajectory(st.desiredMeanPointPosition);
+            costs.meanPositionCost->setTimeVaryingWeight(st.meanPointPositionCostTimeVaryingWeight);
+        }
+
+        if (st.leftFootYawCostActive) {
+            costs.leftYaw->setDesiredYawTrajectory(st.desiredLeftFootYaw);
+        }
+
+        if (st.rightFootYawCostActive) {
+            costs.rightYaw->setDesiredYawTrajectory(st.desiredRightFootYaw);
+        }
+
+        if (st.basePositionCostActive) {
+            ok = ok && costs.basePosition->setStateWeight(st.basePositionCostWeights);
+            ok = ok && costs.basePosition->setStateDesiredTrajectory(st.desiredBasePositionTrajectory);
+        }
+
+        if (st.baseQuaternionCostActive) {
+            ok = ok && costs.baseQuaternion->setStateDesiredTrajectory(st.desiredBaseQuaternionTrajectory);
+        }
+
+        if (st.frameAngularVelocityCostActive) {
+            ok = ok && costs.frameAngularVelocity->setDesiredRotationTrajectory(st.desiredRotationTrajectory);
+        }
+
+        if (!ok) {
             return false;
         }
 
-        ranges.basePosition = stateStructure.addLabelAndGetIndexRange("BasePosition", 3);
-        if (!ranges.basePosition.isValid()) {
+        constraints.centroidalMomentum->setEqualityTolerance(st.centroidalMomentumConstraintTolerance);
+        constraints.comPosition->setEqualityTolerance(st.comPositionConstraintTolerance);
+        constraints.quaternionNorm->setEqualityTolerance(st.quaternionModulusConstraintTolerance);
+
+        ok = constraints.feetLateralDistance->setMinimumDistance(st.minimumFeetDistance);
+        if (!ok) {
             return false;
         }
 
-        ranges.baseQuaternion = stateStructure.addLabelAndGetIndexRange("BaseQuaternion", 4);
-        if (!ranges.baseQuaternion.isValid()) {
+        ok = ok && constraints.leftContactsFriction->setFrictionCoefficient(st.frictionCoefficient);
+
+        ok = ok && constraints.rightContactsFriction->setFrictionCoefficient(st.frictionCoefficient);
+
+        for (auto& position : constraints.leftContactsPosition) {
+            position->setEqualityTolerance(st.pointPositionConstraintTolerance);
+        }
+
+        for (auto& position : constraints.rightContactsPosition) {
+            position->setEqualityTolerance(st.pointPositionConstraintTolerance);
+        }
+
+        return ok;
+    }
+
+    void setHessianRegularizations(const SettingsStruct& st) {
+        if (st.useCostsHessianRegularization) {
+            multipleShootingSolver->addCostsHessianRegularization(st.costsHessianRegularization);
+        } else {
+            multipleShootingSolver->disableCostsHessianRegularization();
+        }
+
+        if (st.useConstraintsHessianRegularization) {
+            multipleShootingSolver->addConstraintsHessianRegularization(st.constraintsHessianRegularization);
+        } else {
+            multipleShootingSolver->disableConstraintsHessianRegularization();
+        }
+    }
+
+    void setWarmStartOption(bool useMultipliers) {
+        auto ipoptInterface = std::dynamic_pointer_cast<iDynTree::optimization::IpoptInterface>(optimizer);
+        if (ipoptInterface && !ipoptInterface->setIpoptOption("warm_start_init_point", useMultipliers ? "yes" : "no")) {
+            std::cerr << "[WARNING][Solver::setWarmStartOption] Failed to set the warm start option." << std::endl;
+        }
+    }
+
+    //Ipopt does not report why it stopped. The last iterate is considered a valid real-time iteration step only if
+    //it is finite and the constraints are satisfied within acceptable_constr_viol_tol, as after hitting the iterations limit.
+    //Infeasible problems, restoration failures and failed evaluations do not pass these checks.
+    bool lastIterateIsUsable() {
+        auto ipoptInterface = std::dynamic_pointer_cast<iDynTree::optimization::IpoptInterface>(optimizer);
+        std::shared_ptr<iDynTree::optimization::OptimizationProblem> problem = optimizer->problem().lock();
+
+        if (!ipoptInterface || !problem) {
             return false;
         }
 
-        ranges.jointsPosition = stateStructure.addLabelAndGetIndexRange("JointsPosition", numberOfDofs);
-        if (!ranges.jointsPosition.isValid()) {
+        if (!optimizer->getPrimalVariables(lastIterate) || !iDynTree::toEigen(lastIterate).allFinite()) {
             return false;
         }
 
-        ranges.baseLinearVelocity = controlStructure.addLabelAndGetIndexRange("BaseLinearVelocity", 3);
-        if (!ranges.baseLinearVelocity.isValid()) {
+        if (!optimizer->getOptimalConstraintsValues(lastConstraints) || !iDynTree::toEigen(lastConstraints).allFinite()) {
             return false;
         }
 
-        ranges.baseQuaternionDerivative = controlStructure.addLabelAndGetIndexRange("BaseQuaternionDerivative", 4);
-        if (!ranges.baseQuaternionDerivative.isValid()) {
+        if (!problem->getConstraintsInfo(constraintsLowerBounds, constraintsUpperBounds) ||
+            (constraintsLowerBounds.size() != lastConstraints.size()) || (constraintsUpperBounds.size() != lastConstraints.size())) {
             return false;
         }
 
-        ranges.jointsVelocity = controlStructure.addLabelAndGetIndexRange("JointsVelocity", numberOfDofs);
-        if (!ranges.jointsVelocity.isValid()) {
+        if (lastConstraints.size() == 0) {
+            return true;
+        }
+
+        double tolerance = 1e-2; //Ipopt default
+        ipoptInterface->getIpoptOption("acceptable_constr_viol_tol", tolerance);
+
+        double violation = std::max((iDynTree::toEigen(constraintsLowerBounds) - iDynTree::toEigen(lastConstraints)).maxCoeff(),
+                                    (iDynTree::toEigen(lastConstraints) - iDynTree::toEigen(constraintsUpperBounds)).maxCoeff());
+
+        return violation <= tolerance;
+    }
+
+    bool solutionIsLastIterate() {
+        //MultipleShootingSolver may return the solution of the previous successful solve when the optimizer fails. The layout of the
+        //optimization variables is not exposed, hence the returned solution is compared with the optimizer iterate through the sorted values.
+        if (!optimizer->getPrimalVariables(lastIterate) || !iDynTree::toEigen(lastIterate).allFinite()) {
             return false;
         }
 
+        sortedIterate.assign(lastIterate.data(), lastIterate.data() + lastIterate.size());
+        sortedSolution.clear();
+        for (const iDynTree::VectorDynSize& state : iterateStates) {
+            sortedSolution.insert(sortedSolution.end(), state.data(), state.data() + state.size());
+        }
+        for (const iDynTree::VectorDynSize& control : iterateControls) {
+            sortedSolution.insert(sortedSolution.end(), control.data(), control.data() + control.size());
+        }
+
+        if ((sortedSolution.size() != sortedIterate.size()) && (sortedSolution.size() != sortedIterate.size() + stateStructure.size())) {
+            return false; //the initial state may be part of the solution without being an optimization variable
+        }
+
+        std::sort(sortedIterate.begin(), sortedIterate.end());
+        std::sort(sortedSolution.begin(), sortedSolution.end());
+
+        return std::includes(sortedSolution.begin(), sortedSolution.end(), sortedIterate.begin(), sortedIterate.end());
+    }
+
+    bool hessiansModeSupported(const SettingsStruct& st, std::shared_ptr<iDynTree::optimization::Optimizer> newOptimizer,
+                               const std::string& methodName) const {
+        if (!st.useExactHessians && newOptimizer && !std::dynamic_pointer_cast<iDynTree::optimization::IpoptInterface>(newOptimizer)) {
+            std::cerr << "[ERROR][Solver::" << methodName << "] Disabling the exact Hessians is supported only with IpoptInterface." << std::endl;
+            return false;
+        }
         return true;
     }
 
+    void setHessiansMode(const SettingsStruct& st) {
+        expressionsServer->enableHessians(st.useExactHessians);
+
+        auto ipoptInterface = std::dynamic_pointer_cast<iDynTree::optimization::IpoptInterface>(optimizer);
+        if (!ipoptInterface) {
+            return;
+        }
+
+        if (!st.useExactHessians) {
+            ipoptInterface->useApproximatedHessians(true);
+            hessiansApproximationForced = true;
+        } else if (hessiansApproximationForced) { //otherwise keep the choice of the user
+            ipoptInterface->useApproximatedHessians(false);
+            hessiansApproximationForced = false;
+        }
+    }
+
+    bool setVariablesStructure(size_t numberOfDofs, size_t numberOfPoints) {
+
+        stateStructure.clear();
+        controlStructure.clear();
+
+        return AddVariablesLayout(numberOfDofs, numberOfPoints, stateStructure, controlStructure, ranges);
+    }
+
     bool setCosts(const SettingsStruct& st, const std::shared_ptr<iDynTree::optimalcontrol::OptimalControlProblem> ocp) {
         bool ok = false;
 
@@ -501,7 +965,7 @@ public:
         }
 
         if (st.staticTorquesCostActive) {
-            costs.staticTorques = std::make_shared<StaticTorquesCost>(stateStructure, controlStructure, timelySharedKinDyn,
+            costs.staticTorques = std::make_shared<StaticTorquesCost>(stateStructure, controlStructure, ranges, timelySharedKinDyn,
                                                                       st.robotModel.getFrameIndex(st.leftFrameName),
                                                                       st.robotModel.getFrameIndex(st.rightFrameName),
                                                                       st.leftPointsPosition, st.rightPointsPosition);
@@ -803,18 +1267,14 @@ public:
 
         constraints.leftNormalVelocityControl.resize(st.leftPointsPosition.size());
         constraints.leftPlanarVelocityControl.resize(st.leftPointsPosition.size());
-        constraints.leftContactsForceControl.resize(st.leftPointsPosition.size());
         constraints.leftDynamicalComplementarity.resize(st.leftPointsPosition.size());
         constraints.leftClassicalComplementarity.resize(st.leftPointsPosition.size());
-        constraints.leftContactsFriction.resize(st.leftPointsPosition.size());
         constraints.leftContactsPosition.resize(st.leftPointsPosition.size());
 
         constraints.rightNormalVelocityControl.resize(st.rightPointsPosition.size());
         constraints.rightPlanarVelocityControl.resize(st.rightPointsPosition.size());
-        constraints.rightContactsForceControl.resize(st.rightPointsPosition.size());
         constraints.rightDynamicalComplementarity.resize(st.rightPointsPosition.size());
         constraints.rightClassicalComplementarity.resize(st.rightPointsPosition.size());
-        constraints.rightContactsFriction.resize(st.rightPointsPosition.size());
         constraints.rightContactsPosition.resize(st.rightPointsPosition.size());
 
         iDynTree::FrameIndex leftFrame = st.robotModel.getFrameIndex(st.leftFrameName);
@@ -866,6 +1326,50 @@ public:
             return false;
         }
 
+        constraints.leftContactsFriction = std::make_shared<FootContactFrictionConstraints>(stateStructure, controlStructure, ranges.left, "Left");
+
+        ok = constraints.leftContactsFriction->setFrictionCoefficient(st.frictionCoefficient);
+        if (!ok) {
+            return false;
+        }
+
+        ok = ocp->addConstraint(constraints.leftContactsFriction);
+        if (!ok) {
+            return false;
+        }
+
+        constraints.rightContactsFriction = std::make_shared<FootContactFrictionConstraints>(stateStructure, controlStructure, ranges.right, "Right");
+
+        ok = constraints.rightContactsFriction->setFrictionCoefficient(st.frictionCoefficient);
+        if (!ok) {
+            return false;
+        }
+
+        ok = ocp->addConstraint(constraints.rightContactsFriction);
+        if (!ok) {
+            return false;
+        }
+
+        if (st.complementarity == ComplementarityType::HyperbolicSecantInequality) {
+            constraints.leftContactsForceControl = std::make_shared<FootContactForceControlConstraints>(stateStructure, controlStructure, ranges.left,
+                                                                                                        "Left", forceActivation,
+                                                                                                        st.forceMaximumDerivative(2),
+                                                                                                        st.normalForceDissipationRatio);
+            ok = ocp->addConstraint(constraints.leftContactsForceControl);
+            if (!ok) {
+                return false;
+            }
+
+            constraints.rightContactsForceControl = std::make_shared<FootContactForceControlConstraints>(stateStructure, controlStructure, ranges.right,
+                                                                                                         "Right", forceActivation,
+                                                                                                         st.forceMaximumDerivative(2),
+                                                                                                         st.normalForceDissipationRatio);
+            ok = ocp->addConstraint(constraints.rightContactsForceControl);
+            if (!ok) {
+                return false;
+            }
+        }
+
         for (size_t i = 0; i < st.leftPointsPosition.size(); ++i) {
 
             if (st.contactVelocityControlConstraintsAsSeparateConstraints) {
@@ -897,17 +1401,6 @@ public:
                 }
             }
 
-            if (st.complementarity == ComplementarityType::HyperbolicSecantInequality) {
-                constraints.leftContactsForceControl[i] = std::make_shared<ContactForceControlConstraints>(stateStructure, controlStructure, "Left",
-                                                                                                           i, forceActivation,
-                                                                                                           st.forceMaximumDerivative(2),
-                                                                                                           st.normalForceDissipationRatio);
-                ok = ocp->addConstraint(constraints.leftContactsForceControl[i]);
-                if (!ok) {
-                    return false;
-                }
-            }
-
             if (st.complementarity == ComplementarityType::Classical) {
                 constraints.leftClassicalComplementarity[i] = std::make_shared<ClassicalComplementarityConstraint>(stateStructure, controlStructure,
                                                                                                                    "Left", i, st.classicalComplementarityTolerance);
@@ -917,18 +1410,6 @@ public:
                 }
             }
 
-            constraints.leftContactsFriction[i] = std::make_shared<ContactFrictionConstraint>(stateStructure, controlStructure, "Left", i);
-
-            ok = constraints.leftContactsFriction[i]->setFrictionCoefficient(st.frictionCoefficient);
-            if (!ok) {
-                return false;
-            }
-
-            ok = ocp->addConstraint(constraints.leftContactsFriction[i]);
-            if (!ok) {
-                return false;
-            }
-
             constraints.leftContactsPosition[i] = std::make_shared<ContactPositionConsistencyConstraint>(stateStructure, controlStructure,
                                                                                                          timelySharedKinDyn, expressionsServer,
                                                                                                          leftFrame, "Left",
@@ -982,29 +1463,6 @@ public:
                 }
             }
 
-            if (st.complementarity == ComplementarityType::HyperbolicSecantInequality) {
-                constraints.rightContactsForceControl[i] = std::make_shared<ContactForceControlConstraints>(stateStructure, controlStructure, "Right",
-                                                                                                            i, forceActivation,
-                                                                                                            st.forceMaximumDerivative(2),
-                                                                                                            st.normalForceDissipationRatio);
-                ok = ocp->addConstraint(constraints.rightContactsForceControl[i]);
-                if (!ok) {
-                    return false;
-                }
-            }
-
-            constraints.rightContactsFriction[i] = std::make_shared<ContactFrictionConstraint>(stateStructure, controlStructure, "Right", i);
-
-            ok = constraints.rightContactsFriction[i]->setFrictionCoefficient(st.frictionCoefficient);
-            if (!ok) {
-                return false;
-            }
-
-            ok = ocp->addConstraint(constraints.rightContactsFriction[i]);
-            if (!ok) {
-                return false;
-            }
-
             constraints.rightContactsPosition[i] = std::make_shared<ContactPositionConsistencyConstraint>(stateStructure, controlStructure,
                                                                                                           timelySharedKinDyn, expressionsServer,
                                                                                                           rightFrame, "Right",
@@ -1150,23 +1608,38 @@ public:
 
         optimalStates.resize(stateTimings.size(), State(numberOfDofs, numberOfPoints));
         optimalControls.resize(controlTimings.size(), Control(numberOfDofs, numberOfPoints));
+
+        optimalStatesView = StateTrajectoryView(unstructuredOptimalStates, stateTimings, ranges);
+        optimalControlsView = ControlTrajectoryView(unstructuredOptimalControl, controlTimings, ranges);
+        solutionVectorsUpdated = false;
     }
 
 
-    void fillSolutionVectors() {
+    void fillSolutionVectors() { //the conversion is performed only when the structured solution is requested
+        if (solutionVectorsUpdated) {
+            return;
+        }
+
         size_t numberOfDofs = settings.robotModel.getNrOfDOFs();
         size_t numberOfPoints = settings.leftPointsPosition.size();
 
-        optimalStates.resize(stateTimings.size(), State(numberOfDofs, numberOfPoints));
-        optimalControls.resize(controlTimings.size(), Control(numberOfDofs, numberOfPoints));
+        if (optimalStates.size() != stateTimings.size()) { //the default element is built only when needed, since it allocates memory
+            optimalStates.resize(stateTimings.size(), State(numberOfDofs, numberOfPoints));
+        }
+
+        if (optimalControls.size() != controlTimings.size()) {
+            optimalControls.resize(controlTimings.size(), Control(numberOfDofs, numberOfPoints));
+        }
 
-        for (size_t i = 0; i < stateTimings.size(); ++i) {
-            setStateFromVariables(unstructuredOptimalStates[i], stateTimings[i], optimalStates[i]);
+        for (size_t i = 0; i < optimalStatesView.size(); ++i) {
+            optimalStatesView.toState(i, optimalStates[i]);
         }
 
-        for (size_t i = 0; i < controlTimings.size(); ++i) {
-            setControlFromVariables(unstructuredOptimalControl[i], controlTimings[i], optimalControls[i]);
+        for (size_t i = 0; i < optimalControlsView.size(); ++i) {
+            optimalControlsView.toControl(i, optimalControls[i]);
         }
+
+        solutionVectorsUpdated = true;
     }
 
     void fillInitialState() {
@@ -1189,90 +1662,157 @@ public:
         setSegment(ranges.jointsPosition, initialState.jointsConfiguration, initialStateVector);
     }
 
-private:
+    bool solveProblem() {
+        solutionStatus = SolutionStatus::Failed;
+
+        if (!prepared) {
+            std::cerr << "[ERROR][Solver::solve] First you have to specify the settings." << std::endl;
+            return false;
+        }
 
-    bool setFootVariables(const std::string& footName, size_t numberOfPoints, FootRanges& footRanges) {
-        footRanges.forcePoints.resize(numberOfPoints);
-        footRanges.positionPoints.resize(numberOfPoints);
-        footRanges.velocityControlPoints.resize(numberOfPoints);
-        footRanges.forceControlPoints.resize(numberOfPoints);
+        if (!initialState.checkSize(settings.robotModel.getNrOfDOFs(), settings.leftPointsPosition.size())) {
+            std::cerr <<"[ERROR][Solver::solve] The specified initial dimensions do not match those of the problem." << std::endl;
+            return false;
+        }
 
-        for (size_t i = 0; i < numberOfPoints; ++i) {
-            footRanges.forcePoints[i] = stateStructure.addLabelAndGetIndexRange(footName + "ForcePoint" + std::to_string(i), 3);
-            if (!footRanges.forcePoints[i].isValid()) {
-                return false;
-            }
-            footRanges.positionPoints[i] = stateStructure.addLabelAndGetIndexRange(footName + "PositionPoint" + std::to_string(i), 3);
-            if (!footRanges.positionPoints[i].isValid()) {
+        fillInitialState();
+
+        bool ok = false;
+
+        ok = multipleShootingSolver->setInitialState(initialStateVector);
+
+        if (!ok) {
+            std::cerr << "[ERROR][Solver::solve] Failed to set the initial state." << std::endl;
+            return false;
+        }
+
+        ok = ocProblem->setTimeHorizon(initialState.time, initialState.time + settings.horizon);
+
+        if (!ok) {
+            std::cerr << "[ERROR][Solver::solve] Failed to set the time horizon." << std::endl;
+            return false;
+        }
+
+        bool multipliersMatchGuess = false; //the multipliers are not shifted, they match only the previous solution as it is
+
+        if (stateGuess && controlGuess) {
+            ok = multipleShootingSolver->setGuesses(stateGuess, controlGuess);
+            if (!ok) {
+                std::cerr << "[ERROR][Solver::solve] Failed to set guesses." << std::endl;
                 return false;
             }
-            footRanges.velocityControlPoints[i] = controlStructure.addLabelAndGetIndexRange(footName + "VelocityControlPoint" + std::to_string(i), 3);
-            if (!footRanges.velocityControlPoints[i].isValid()) {
+        } else if (usePreviousSolution) {
+            double timeShift = previousInitialTime + previousSolutionElapsedTime - initialState.time;
+            previousStateSolution->setTimeShift(timeShift);
+            previousControlSolution->setTimeShift(timeShift);
+            ok = multipleShootingSolver->setGuesses(previousStateSolution, previousControlSolution);
+            if (!ok) {
+                std::cerr << "[ERROR][Solver::solve] Failed to set the guesses from the previous solution." << std::endl;
                 return false;
             }
-            footRanges.forceControlPoints[i] = controlStructure.addLabelAndGetIndexRange(footName + "ForceControlPoint" + std::to_string(i), 3);
-            if (!footRanges.forceControlPoints[i].isValid()) {
+            multipliersMatchGuess = (timeShift == 0.0);
+        }
+
+        setWarmStartOption((usePrimalDualWarmStart || (realTimeIterations > 0)) && multipliersAvailable && multipliersMatchGuess);
+
+        ok = multipleShootingSolver->solve();
+
+        SolutionStatus status = SolutionStatus::Solved;
+
+        if (ok) {
+            multipliersAvailable = true;
+        } else {
+            multipliersAvailable = false;
+
+            if (interruption->cancelRequested()) {
+                status = SolutionStatus::Cancelled;
+            } else if (interruption->deadlineReached()) {
+                status = SolutionStatus::DeadlineReached;
+            } else if ((realTimeIterations > 0) && lastIterateIsUsable()) { //the optimizer reports a failure also when it hits the iterations limit
+                status = SolutionStatus::IterationsLimitReached;
+                multipliersAvailable = true; //the next real-time iteration continues from here
+            } else {
+                std::cerr << "[ERROR][Solver::solve] Failed to solve the optimization problem." << std::endl;
                 return false;
             }
+
+            return storeLastIterate(status);
         }
 
-        return true;
-    }
+        previousSolutionAvailable = false; //the stored solution is going to be overwritten
 
-    iDynTree::Span<const double> segment(const iDynTree::VectorDynSize &fullVector, const iDynTree::IndexRange& indexRange) {
-        return iDynTree::make_span(fullVector).subspan(indexRange.offset, indexRange.size);
-    }
+        ok = multipleShootingSolver->getTimings(stateTimings, controlTimings);
 
-    iDynTree::Span<double> segment(iDynTree::VectorDynSize &fullVector, const iDynTree::IndexRange& indexRange) {
-        return iDynTree::make_span(fullVector).subspan(indexRange.offset, indexRange.size);
-    }
+        if (!ok) {
+            std::cerr << "[ERROR][Solver::solve] Failed to retrieve the timings." << std::endl;
+            return false;
+        }
 
-    template<typename Vector>
-    void setSegment(iDynTree::IndexRange &range, const Vector &original, iDynTree::VectorDynSize& vectorState) {
-        iDynTree::toEigen(vectorState).segment(range.offset, range.size) = iDynTree::toEigen(original);
-    }
+        ok = multipleShootingSolver->getSolution(unstructuredOptimalStates, unstructuredOptimalControl);
 
-    void setStateFromVariables(const iDynTree::VectorDynSize &unstructured, double time, State &stateToFill) {
-        for (size_t i = 0; i < ranges.left.positionPoints.size(); ++i) {
-            stateToFill.leftContactPointsState[i].pointPosition = segment(unstructured, ranges.left.positionPoints[i]);
-            iDynTree::toEigen(stateToFill.leftContactPointsState[i].pointForce) = iDynTree::toEigen(segment(unstructured, ranges.left.forcePoints[i]));
+        if (!ok) {
+            std::cerr << "[ERROR][Solver::solve] Failed to retrieve the optimal solution." << std::endl;
+            return false;
         }
 
-        for (size_t i = 0; i < ranges.right.positionPoints.size(); ++i) {
-            stateToFill.rightContactPointsState[i].pointPosition = segment(unstructured, ranges.right.positionPoints[i]);
-            iDynTree::toEigen(stateToFill.rightContactPointsState[i].pointForce) = iDynTree::toEigen(segment(unstructured, ranges.right.forcePoints[i]));
+        solutionStored(status);
+
+        return true;
+    }
+
+    bool storeLastIterate(SolutionStatus status) {
+        bool ok = multipleShootingSolver->getTimings(iterateStateTimings, iterateControlTimings) &&
+                multipleShootingSolver->getSolution(iterateStates, iterateControls);
+
+        if (!ok || !solutionIsLastIterate()) {
+            if (status == SolutionStatus::IterationsLimitReached) {
+                std::cerr << "[ERROR][Solver::solve] Failed to retrieve the last iterate of the real-time iteration." << std::endl;
+                multipliersAvailable = false;
+                return false;
+            }
+
+            stateGuess = nullptr; //the stored solution, if any, is the one of the last solve whose iterate could be retrieved
+            controlGuess = nullptr;
+            usePreviousSolution = false;
+            solutionStatus = status;
+            return true;
         }
 
-        stateToFill.momentumInCoM = segment(unstructured, ranges.momentum);
-        stateToFill.comPosition = segment(unstructured, ranges.comPosition);
+        stateTimings.swap(iterateStateTimings); //the views and the previous solution guesses point to these vectors
+        controlTimings.swap(iterateControlTimings);
+        unstructuredOptimalStates.swap(iterateStates);
+        unstructuredOptimalControl.swap(iterateControls);
 
-        iDynTree::toEigen(basePositionBuffer) = iDynTree::toEigen(segment(unstructured, ranges.basePosition));
-        baseQuaternion = segment(unstructured, ranges.baseQuaternion);
-        stateToFill.worldToBaseTransform.setPosition(basePositionBuffer);
-        baseRotationBuffer.fromQuaternion(NormalizedQuaternion(baseQuaternion));
-        stateToFill.worldToBaseTransform.setRotation(baseRotationBuffer);
+        solutionStored(status);
 
-        stateToFill.jointsConfiguration = segment(unstructured, ranges.jointsPosition);
+        return true;
+    }
+
+    void solutionStored(SolutionStatus status) {
+        solutionVectorsUpdated = false;
+
+        stateGuess = nullptr;
+        controlGuess = nullptr;
+        usePreviousSolution = false;
+        previousSolutionAvailable = true;
+        previousInitialTime = initialState.time;
 
-        stateToFill.time = time;
+        solutionStatus = status;
     }
 
-    void setControlFromVariables(const iDynTree::VectorDynSize &unstructured, double time, Control &controlToFill) {
+private:
 
-        for (size_t i = 0; i < ranges.left.forceControlPoints.size(); ++i) {
-            controlToFill.leftContactPointsControl[i].pointForceControl = segment(unstructured, ranges.left.forceControlPoints[i]);
-            controlToFill.leftContactPointsControl[i].pointVelocityControl = segment(unstructured, ranges.left.velocityControlPoints[i]);
-        }
+    iDynTree::Span<const double> segment(const iDynTree::VectorDynSize &fullVector, const iDynTree::IndexRange& indexRange) {
+        return iDynTree::make_span(fullVector).subspan(indexRange.offset, indexRange.size);
+    }
 
-        for (size_t i = 0; i < ranges.right.forceControlPoints.size(); ++i) {
-            controlToFill.rightContactPointsControl[i].pointForceControl = segment(unstructured, ranges.right.forceControlPoints[i]);
-            controlToFill.rightContactPointsControl[i].pointVelocityControl = segment(unstructured, ranges.right.velocityControlPoints[i]);
-        }
+    iDynTree::Span<double> segment(iDynTree::VectorDynSize &fullVector, const iDynTree::IndexRange& indexRange) {
+        return iDynTree::make_span(fullVector).subspan(indexRange.offset, indexRange.size);
+    }
 
-        controlToFill.baseLinearVelocity = segment(unstructured, ranges.baseLinearVelocity);
-        controlToFill.baseQuaternionDerivative = segment(unstructured, ranges.baseQuaternionDerivative);
-        controlToFill.jointsVelocity = segment(unstructured, ranges.jointsVelocity);
-        controlToFill.time = time;
+    template<typename Vector>
+    void setSegment(iDynTree::IndexRange &range, const Vector &original, iDynTree::VectorDynSize& vectorState) {
+        iDynTree::toEigen(vectorState).segment(range.offset, range.size) = iDynTree::toEigen(original);
     }
 };
 
@@ -1291,20 +1831,47 @@ Solver::Solver()
         m_pimpl->minusInfinity = ipoptInterface->minusInfinity();
     }
 
+    m_pimpl->previousSolutionAvailable = false;
+    m_pimpl->usePreviousSolution = false;
+    m_pimpl->previousSolutionElapsedTime = 0.0;
+    m_pimpl->previousInitialTime = 0.0;
+    m_pimpl->multipliersAvailable = false;
+    m_pimpl->usePrimalDualWarmStart = false;
+    m_pimpl->realTimeIterations = 0;
+    m_pimpl->maximumIterationsBackup = 3000;
+    m_pimpl->interruption = std::make_shared<SolverInterruption>();
+    m_pimpl->solutionStatus = SolutionStatus::NotSolved;
+    m_pimpl->solutionVectorsUpdated = false;
+    m_pimpl->running = false;
+    m_pimpl->hessiansApproximationForced = false;
+
     m_pimpl->prepared = false;
 
 }
 
 Solver::~Solver()
-{ }
+{
+    if (m_pimpl->running) { //a solveAsync future has been moved away. Stop the optimizer before freeing the memory it uses.
+        m_pimpl->interruption->cancel();
+        m_pimpl->waitUntilStopped();
+    }
+}
 
 bool Solver::specifySettings(const Settings &settings)
 {
+    if (!m_pimpl->notRunning("specifySettings")) {
+        return false;
+    }
+
     if (!settings.isValid()) {
         std::cerr << "[ERROR][Solver::specifySettings] The specified settings are not valid." << std::endl;
         return false;
     }
 
+    if (!m_pimpl->hessiansModeSupported(settings.getSettings(), m_pimpl->optimizer, "specifySettings")) {
+        return false;
+    }
+
     m_pimpl->settings = settings.getSettings();
 
     const SettingsStruct& st = m_pimpl->settings;
@@ -1336,7 +1903,11 @@ bool Solver::specifySettings(const Settings &settings)
         return false;
     }
 
-    m_pimpl->expressionsServer = std::make_shared<ExpressionsServer>(m_pimpl->timelySharedKinDyn);
+    //The derived expressions depend only on the model and on the floating base. When they did not change, keep the server of the previous call,
+    //so that its expressions and their cached derivatives (CRBI sum, adjoints, Jacobians) are not derived again. This is in-process only.
+    if (!m_pimpl->expressionsServer || !m_pimpl->expressionsServer->setTimelySharedKinDyn(m_pimpl->timelySharedKinDyn)) {
+        m_pimpl->expressionsServer = std::make_shared<ExpressionsServer>(m_pimpl->timelySharedKinDyn);
+    }
 
     HyperbolicTangent velocityActivationXY;
     velocityActivationXY.setScaling(st.planarVelocityHyperbolicTangentScaling);
@@ -1352,11 +1923,13 @@ bool Solver::specifySettings(const Settings &settings)
 
     m_pimpl->constraints.dynamical = std::make_shared<DynamicalConstraints>(m_pimpl->stateStructure,
                                                                             m_pimpl->controlStructure,
+                                                                            m_pimpl->ranges,
                                                                             m_pimpl->timelySharedKinDyn,
                                                                             m_pimpl->expressionsServer,
                                                                             velocityActivationXY,
                                                                             forceActivation,
                                                                             st.normalForceDissipationRatio);
+    m_pimpl->constraints.dynamical->setInterruption(m_pimpl->interruption);
 
     m_pimpl->ocProblem = std::make_shared<iDynTree::optimalcontrol::OptimalControlProblem>();
 
@@ -1470,25 +2043,77 @@ bool Solver::specifySettings(const Settings &settings)
 
     m_pimpl->resizeSolutionVector(numberOfDofs, numberOfPoints);
 
-    if (st.useCostsHessianRegularization) {
-        m_pimpl->multipleShootingSolver->addCostsHessianRegularization(st.costsHessianRegularization);
-    } else {
-        m_pimpl->multipleShootingSolver->disableCostsHessianRegularization();
+    m_pimpl->previousStateSolution = std::make_shared<PreviousSolutionGuesses>(m_pimpl->stateTimings, m_pimpl->unstructuredOptimalStates,
+                                                                               m_pimpl->ranges.baseQuaternion);
+    m_pimpl->previousControlSolution = std::make_shared<PreviousSolutionGuesses>(m_pimpl->controlTimings, m_pimpl->unstructuredOptimalControl,
+                                                                                 iDynTree::IndexRange::InvalidRange());
+    m_pimpl->previousSolutionAvailable = false;
+    m_pimpl->usePreviousSolution = false;
+    m_pimpl->multipliersAvailable = false;
+    m_pimpl->stateGuessBuffer = nullptr; //the ranges may have changed
+    m_pimpl->controlGuessBuffer = nullptr;
+
+    m_pimpl->setHessianRegularizations(st);
+
+    m_pimpl->setHessiansMode(st);
+
+    m_pimpl->prepared = true;
+
+    return true;
+}
+
+bool Solver::updateSettings(const Settings &settings)
+{
+    if (!m_pimpl->notRunning("updateSettings")) {
+        return false;
     }
 
-    if (st.useConstraintsHessianRegularization) {
-        m_pimpl->multipleShootingSolver->addConstraintsHessianRegularization(st.constraintsHessianRegularization);
-    } else {
-        m_pimpl->multipleShootingSolver->disableConstraintsHessianRegularization();
+    if (!settings.isValid()) {
+        std::cerr << "[ERROR][Solver::updateSettings] The specified settings are not valid." << std::endl;
+        return false;
     }
 
-    m_pimpl->prepared = true;
+    if (!m_pimpl->hessiansModeSupported(settings.getSettings(), m_pimpl->optimizer, "updateSettings")) {
+        return false;
+    }
+
+    if (!(m_pimpl->prepared) || m_pimpl->needsNewStructure(settings.getSettings())) {
+        return specifySettings(settings);
+    }
+
+    m_pimpl->settings = settings.getSettings();
+
+    const SettingsStruct& st = m_pimpl->settings;
+
+    bool ok = m_pimpl->updateCostsAndConstraints(st);
+
+    if (!ok) {
+        std::cerr << "[ERROR][Solver::updateSettings] Failed to update the costs and the constraints." << std::endl;
+        m_pimpl->prepared = false;
+        return false;
+    }
+
+    ok = m_pimpl->setBounds(st);
+
+    if (!ok) {
+        std::cerr << "[ERROR][Solver::updateSettings] Failed to set the variables bounds." << std::endl;
+        m_pimpl->prepared = false;
+        return false;
+    }
+
+    m_pimpl->setHessianRegularizations(st);
+
+    m_pimpl->setHessiansMode(st);
 
     return true;
 }
 
 bool Solver::setInitialState(const State &initialState)
 {
+    if (!m_pimpl->notRunning("setInitialState")) {
+        return false;
+    }
+
     if (!(m_pimpl->prepared)) {
         std::cerr << "[ERROR][Solver::setInitialCondition] First you have to specify the settings." << std::endl;
         return false;
@@ -1507,6 +2132,10 @@ bool Solver::setInitialState(const State &initialState)
 
 bool Solver::setGuesses(std::shared_ptr<TimeVaryingState> stateGuesses, std::shared_ptr<TimeVaryingControl> controlGuesses)
 {
+    if (!m_pimpl->notRunning("setGuesses")) {
+        return false;
+    }
+
     if (!stateGuesses) {
         std::cerr << "[ERROR][Solver::setGuesses] The stateGuesses pointer is empty."
                   << std::endl;
@@ -1519,20 +2148,74 @@ bool Solver::setGuesses(std::shared_ptr<TimeVaryingState> stateGuesses, std::sha
         return false;
     }
 
-    m_pimpl->stateGuess = std::make_shared<StateGuesses>(stateGuesses, m_pimpl->ranges);
+    if (m_pimpl->stateGuessBuffer) { //reuse the buffers allocated by the previous call
+        m_pimpl->stateGuessBuffer->setOriginalGuess(stateGuesses);
+        m_pimpl->controlGuessBuffer->setOriginalGuess(controlGuesses);
+    } else {
+        m_pimpl->stateGuessBuffer = std::make_shared<StateGuesses>(stateGuesses, m_pimpl->ranges);
+        m_pimpl->controlGuessBuffer = std::make_shared<ControlGuesses>(controlGuesses, m_pimpl->ranges);
+    }
+
+    m_pimpl->stateGuess = m_pimpl->stateGuessBuffer;
+
+    m_pimpl->controlGuess = m_pimpl->controlGuessBuffer;
 
-    m_pimpl->controlGuess = std::make_shared<ControlGuesses>(controlGuesses, m_pimpl->ranges);
+    m_pimpl->usePreviousSolution = false;
+
+    return true;
+}
+
+bool Solver::setGuessesFromPreviousSolution(double elapsedTime)
+{
+    if (!m_pimpl->notRunning("setGuessesFromPreviousSolution")) {
+        return false;
+    }
+
+    if (!(m_pimpl->prepared)) {
+        std::cerr << "[ERROR][Solver::setGuessesFromPreviousSolution] First you have to specify the settings." << std::endl;
+        return false;
+    }
+
+    if (!(m_pimpl->previousSolutionAvailable)) {
+        std::cerr << "[ERROR][Solver::setGuessesFromPreviousSolution] No previous solution available. Call solve first." << std::endl;
+        return false;
+    }
+
+    if (elapsedTime < 0) {
+        std::cerr << "[ERROR][Solver::setGuessesFromPreviousSolution] The elapsed time is expected to be non-negative." << std::endl;
+        return false;
+    }
+
+    m_pimpl->stateGuess = nullptr;
+    m_pimpl->controlGuess = nullptr;
+    m_pimpl->usePreviousSolution = true;
+    m_pimpl->previousSolutionElapsedTime = elapsedTime;
 
     return true;
 }
 
 bool Solver::setOptimizer(std::shared_ptr<iDynTree::optimization::Optimizer> optimizer)
 {
+    if (!m_pimpl->notRunning("setOptimizer")) {
+        return false;
+    }
+
     if (!optimizer) {
         std::cerr << "[ERROR][Solver::setOptimizer] The optimizer pointer is empty." << std::endl;
         return false;
     }
 
+    if (m_pimpl->prepared && !m_pimpl->hessiansModeSupported(m_pimpl->settings, optimizer, "setOptimizer")) {
+        return false;
+    }
+
+    auto outgoingIpopt = std::dynamic_pointer_cast<iDynTree::optimization::IpoptInterface>(m_pimpl->optimizer);
+    if ((m_pimpl->realTimeIterations > 0) && outgoingIpopt && (outgoingIpopt != optimizer) &&
+        !outgoingIpopt->setIpoptOption("max_iter", m_pimpl->maximumIterationsBackup)) {
+        std::cerr << "[ERROR][Solver::setOptimizer] Failed to restore the maximum number of iterations of the previous optimizer." << std::endl;
+        return false;
+    }
+
     if (m_pimpl->prepared){
         if (!(m_pimpl->multipleShootingSolver->setOptimizer(optimizer))) {
             std::cerr << "[ERROR][Solver::setOptimizer] Failed to set the specified optimizer." << std::endl;
@@ -1541,14 +2224,25 @@ bool Solver::setOptimizer(std::shared_ptr<iDynTree::optimization::Optimizer> opt
     }
 
     m_pimpl->optimizer = optimizer;
+    m_pimpl->hessiansApproximationForced = false;
+    m_pimpl->multipliersAvailable = false;
+    m_pimpl->realTimeIterations = 0;
     m_pimpl->plusInfinity = optimizer->plusInfinity();
     m_pimpl->minusInfinity = optimizer->minusInfinity();
 
+    if (m_pimpl->prepared) {
+        m_pimpl->setHessiansMode(m_pimpl->settings);
+    }
+
     return true;
 }
 
 bool Solver::setIntegrator(std::shared_ptr<iDynTree::optimalcontrol::integrators::Integrator> integrationMethod)
 {
+    if (!m_pimpl->notRunning("setIntegrator")) {
+        return false;
+    }
+
     if (!integrationMethod) {
         std::cerr << "[ERROR][Solver::setIntegrator] The integrationMethod pointer is empty." << std::endl;
         return false;
@@ -1568,84 +2262,153 @@ bool Solver::setIntegrator(std::shared_ptr<iDynTree::optimalcontrol::integrators
 
 bool Solver::solve(std::vector<State> &optimalStates, std::vector<Control> &optimalControls)
 {
-    if (!(m_pimpl->prepared)) {
-        std::cerr << "[ERROR][Solver::solve] First you have to specify the settings." << std::endl;
+    if (!m_pimpl->startRunning("solve")) {
         return false;
     }
 
-    if (!m_pimpl->initialState.checkSize(m_pimpl->settings.robotModel.getNrOfDOFs(),
-                                         m_pimpl->settings.leftPointsPosition.size())) {
-        std::cerr <<"[ERROR][Solver::solve] The specified initial dimensions do not match those of the problem." << std::endl;
+    m_pimpl->interruption->reset();
+
+    bool ok = m_pimpl->solveProblem();
+    m_pimpl->stopRunning();
+
+    if (!ok) {
         return false;
     }
 
-    m_pimpl->fillInitialState();
+    m_pimpl->fillSolutionVectors();
+
+    optimalStates = m_pimpl->optimalStates;
 
-    bool ok = false;
+    optimalControls = m_pimpl->optimalControls;
 
-    ok = m_pimpl->multipleShootingSolver->setInitialState(m_pimpl->initialStateVector);
+    return true;
+}
 
-    if (!ok) {
-        std::cerr << "[ERROR][Solver::solve] Failed to set the initial state." << std::endl;
+bool Solver::solve()
+{
+    if (!m_pimpl->startRunning("solve")) {
         return false;
     }
 
-    ok = m_pimpl->ocProblem->setTimeHorizon(m_pimpl->initialState.time, m_pimpl->initialState.time + m_pimpl->settings.horizon);
+    m_pimpl->interruption->reset();
 
-    if (!ok) {
-        std::cerr << "[ERROR][Solver::solve] Failed to set the time horizon." << std::endl;
-        return false;
-    }
+    bool ok = m_pimpl->solveProblem();
+    m_pimpl->stopRunning();
 
-    if (m_pimpl->stateGuess && m_pimpl->controlGuess) {
-        ok = m_pimpl->multipleShootingSolver->setGuesses(m_pimpl->stateGuess, m_pimpl->controlGuess);
-        if (!ok) {
-            std::cerr << "[ERROR][Solver::solve] Failed to set guesses." << std::endl;
-            return false;
-        }
+    return ok;
+}
+
+std::future<SolutionStatus> Solver::solveAsync(const std::chrono::steady_clock::time_point &deadline)
+{
+    if (!m_pimpl->startRunning("solveAsync")) {
+        std::promise<SolutionStatus> rejected;
+        rejected.set_value(SolutionStatus::Failed);
+        return rejected.get_future();
     }
 
-    ok = m_pimpl->multipleShootingSolver->solve();
+    m_pimpl->interruption->reset();
+    m_pimpl->interruption->setDeadline(deadline);
+    m_pimpl->solutionStatus = SolutionStatus::NotSolved;
 
-    if (!ok) {
-        std::cerr << "[ERROR][Solver::solve] Failed to solve the optimization problem." << std::endl;
-        return false;
+    Implementation* pimpl = m_pimpl.get();
+
+    return std::async(std::launch::async, [pimpl]() {
+        pimpl->solveProblem();
+        SolutionStatus status = pimpl->solutionStatus;
+        pimpl->stopRunning(); //from now on the Solver can be destroyed
+        return status;
+    });
+}
+
+void Solver::cancel()
+{
+    m_pimpl->interruption->cancel();
+}
+
+SolutionStatus Solver::lastSolutionStatus() const
+{
+    return m_pimpl->solutionStatus;
+}
+
+void Solver::usePrimalDualWarmStart(bool useIt)
+{
+    if (!m_pimpl->notRunning("usePrimalDualWarmStart")) {
+        return;
     }
 
-    ok = m_pimpl->multipleShootingSolver->getTimings(m_pimpl->stateTimings, m_pimpl->controlTimings);
+    m_pimpl->usePrimalDualWarmStart = useIt;
 
-    if (!ok) {
-        std::cerr << "[ERROR][Solver::solve] Failed to retrieve the timings." << std::endl;
+    if (!useIt && (m_pimpl->realTimeIterations == 0)) {
+        m_pimpl->setWarmStartOption(false);
+    }
+}
+
+bool Solver::setRealTimeIterations(unsigned int iterationsPerSolve)
+{
+    if (!m_pimpl->notRunning("setRealTimeIterations")) {
         return false;
     }
 
-    ok = m_pimpl->multipleShootingSolver->getSolution(m_pimpl->unstructuredOptimalStates,
-                                                      m_pimpl->unstructuredOptimalControl);
+    auto ipoptInterface = std::dynamic_pointer_cast<iDynTree::optimization::IpoptInterface>(m_pimpl->optimizer);
 
-    if (!ok) {
-        std::cerr << "[ERROR][Solver::solve] Failed to retrieve the optimal solution." << std::endl;
+    if (!ipoptInterface) {
+        std::cerr << "[ERROR][Solver::setRealTimeIterations] The real-time iteration mode is available only with IpoptInterface." << std::endl;
         return false;
     }
 
-    m_pimpl->fillSolutionVectors();
-
-    optimalStates = m_pimpl->optimalStates;
+    if (iterationsPerSolve == 0) {
+        if ((m_pimpl->realTimeIterations > 0) && !ipoptInterface->setIpoptOption("max_iter", m_pimpl->maximumIterationsBackup)) {
+            std::cerr << "[ERROR][Solver::setRealTimeIterations] Failed to restore the maximum number of iterations." << std::endl;
+            return false;
+        }
+        m_pimpl->realTimeIterations = 0;
+        m_pimpl->setWarmStartOption(m_pimpl->usePrimalDualWarmStart && m_pimpl->multipliersAvailable);
+        return true;
+    }
 
-    optimalControls = m_pimpl->optimalControls;
+    if (m_pimpl->realTimeIterations == 0) {
+        int maximumIterations;
+        if (ipoptInterface->getIpoptOption("max_iter", maximumIterations)) {
+            m_pimpl->maximumIterationsBackup = maximumIterations;
+        }
+    }
 
-    m_pimpl->stateGuess = nullptr;
-    m_pimpl->controlGuess = nullptr;
+    if (!ipoptInterface->setIpoptOption("max_iter", static_cast<int>(iterationsPerSolve))) {
+        std::cerr << "[ERROR][Solver::setRealTimeIterations] Failed to set the maximum number of iterations." << std::endl;
+        return false;
+    }
 
+    m_pimpl->realTimeIterations = iterationsPerSolve;
 
     return true;
 }
 
 const std::vector<State> &Solver::optimalStates() const
 {
+    if (!m_pimpl->previousSolutionAvailable) {
+        return m_pimpl->noStates;
+    }
+
+    m_pimpl->fillSolutionVectors();
     return m_pimpl->optimalStates;
 }
 
 const std::vector<Control> &Solver::optimalControls() const
 {
+    if (!m_pimpl->previousSolutionAvailable) {
+        return m_pimpl->noControls;
+    }
+
+    m_pimpl->fillSolutionVectors();
     return m_pimpl->optimalControls;
 }
+
+const StateTrajectoryView &Solver::optimalStatesView() const
+{
+    return m_pimpl->optimalStatesView;
+}
+
+const ControlTrajectoryView &Solver::optimalControlsView() const
+{
+    return m_pimpl->optimalControlsView;
+}
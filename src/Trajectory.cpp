@@ -0,0 +1,591 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+
+#include <DynamicalPlanner/Trajectory.h>
+#include <DynamicalPlannerPrivate/Utilities/QuaternionUtils.h>
+#include <iDynTree/Core/EigenHelpers.h>
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+using namespace DynamicalPlanner;
+
+TrajectoryBuffer::TrajectoryBuffer()
+{
+    setDimensions(0, 0, 0);
+    size_t offset = 0;
+    allocate(offset);
+}
+
+TrajectoryBuffer::~TrajectoryBuffer()
+{ }
+
+void TrajectoryBuffer::setDimensions(size_t numberOfKnots, size_t numberOfDofs, size_t numberOfPoints)
+{
+    m_numberOfKnots = numberOfKnots;
+    m_numberOfDofs = numberOfDofs;
+    m_numberOfPoints = numberOfPoints;
+}
+
+TrajectoryBuffer::Quantity TrajectoryBuffer::addQuantity(size_t dimension, size_t &offset) const
+{
+    Quantity newQuantity;
+    newQuantity.offset = offset;
+    newQuantity.dimension = dimension;
+    offset += dimension * m_numberOfKnots;
+    return newQuantity;
+}
+
+void TrajectoryBuffer::addPointsQuantities(size_t &offset, std::vector<Quantity> &first, std::vector<Quantity> &second) const
+{
+    first.resize(m_numberOfPoints);
+    second.resize(m_numberOfPoints);
+    for (size_t i = 0; i < m_numberOfPoints; ++i) {
+        first[i] = addQuantity(3, offset);
+        second[i] = addQuantity(3, offset);
+    }
+}
+
+void TrajectoryBuffer::allocate(size_t &offset)
+{
+    m_time = addQuantity(1, offset);
+    m_buffer.resize(offset);
+    zero();
+}
+
+iDynTree::Span<double> TrajectoryBuffer::knotSpan(const Quantity &quantity, size_t knot)
+{
+    assert(knot < m_numberOfKnots);
+    return iDynTree::Span<double>(m_buffer.data() + quantity.offset + knot * quantity.dimension, static_cast<long>(quantity.dimension));
+}
+
+iDynTree::Span<const double> TrajectoryBuffer::knotSpan(const Quantity &quantity, size_t knot) const
+{
+    assert(knot < m_numberOfKnots);
+    return iDynTree::Span<const double>(m_buffer.data() + quantity.offset + knot * quantity.dimension, static_cast<long>(quantity.dimension));
+}
+
+iDynTree::Span<const double> TrajectoryBuffer::overTimeSpan(const Quantity &quantity) const
+{
+    return iDynTree::Span<const double>(m_buffer.data() + quantity.offset, static_cast<long>(quantity.dimension * m_numberOfKnots));
+}
+
+void TrajectoryBuffer::zero()
+{
+    std::fill(m_buffer.begin(), m_buffer.end(), 0.0);
+}
+
+size_t TrajectoryBuffer::size() const
+{
+    return m_numberOfKnots;
+}
+
+size_t TrajectoryBuffer::numberOfDofs() const
+{
+    return m_numberOfDofs;
+}
+
+size_t TrajectoryBuffer::numberOfPoints() const
+{
+    return m_numberOfPoints;
+}
+
+double &TrajectoryBuffer::time(size_t knot)
+{
+    return knotSpan(m_time, knot)(0);
+}
+
+double TrajectoryBuffer::time(size_t knot) const
+{
+    return knotSpan(m_time, knot)(0);
+}
+
+iDynTree::Span<const double> TrajectoryBuffer::timeOverTime() const
+{
+    return overTimeSpan(m_time);
+}
+
+StateTrajectory::StateTrajectory()
+{
+    resize(0, 0, 0);
+}
+
+StateTrajectory::StateTrajectory(size_t numberOfKnots, size_t numberOfDofs, size_t numberOfPoints)
+{
+    resize(numberOfKnots, numberOfDofs, numberOfPoints);
+}
+
+void StateTrajectory::resize(size_t numberOfKnots, size_t numberOfDofs, size_t numberOfPoints)
+{
+    setDimensions(numberOfKnots, numberOfDofs, numberOfPoints);
+
+    size_t offset = 0;
+    addPointsQuantities(offset, m_leftPositions, m_leftForces);
+    addPointsQuantities(offset, m_rightPositions, m_rightForces);
+    m_momentum = addQuantity(6, offset);
+    m_comPosition = addQuantity(3, offset);
+    m_basePosition = addQuantity(3, offset);
+    m_baseQuaternion = addQuantity(4, offset);
+    m_joints = addQuantity(numberOfDofs, offset);
+
+    allocate(offset);
+}
+
+iDynTree::Span<double> StateTrajectory::leftPointPosition(size_t knot, size_t point)
+{
+    assert(point < m_leftPositions.size());
+    return knotSpan(m_leftPositions[point], knot);
+}
+
+iDynTree::Span<const double> StateTrajectory::leftPointPosition(size_t knot, size_t point) const
+{
+    assert(point < m_leftPositions.size());
+    return knotSpan(m_leftPositions[point], knot);
+}
+
+iDynTree::Span<double> StateTrajectory::leftPointForce(size_t knot, size_t point)
+{
+    assert(point < m_leftForces.size());
+    return knotSpan(m_leftForces[point], knot);
+}
+
+iDynTree::Span<const double> StateTrajectory::leftPointForce(size_t knot, size_t point) const
+{
+    assert(point < m_leftForces.size());
+    return knotSpan(m_leftForces[point], knot);
+}
+
+iDynTree::Span<double> StateTrajectory::rightPointPosition(size_t knot, size_t point)
+{
+    assert(point < m_rightPositions.size());
+    return knotSpan(m_rightPositions[point], knot);
+}
+
+iDynTree::Span<const double> StateTrajectory::rightPointPosition(size_t knot, size_t point) const
+{
+    assert(point < m_rightPositions.size());
+    return knotSpan(m_rightPositions[point], knot);
+}
+
+iDynTree::Span<double> StateTrajectory::rightPointForce(size_t knot, size_t point)
+{
+    assert(point < m_rightForces.size());
+    return knotSpan(m_rightForces[point], knot);
+}
+
+iDynTree::Span<const double> StateTrajectory::rightPointForce(size_t knot, size_t point) const
+{
+    assert(point < m_rightForces.size());
+    return knotSpan(m_rightForces[point], knot);
+}
+
+iDynTree::Span<double> StateTrajectory::momentumInCoM(size_t knot)
+{
+    return knotSpan(m_momentum, knot);
+}
+
+iDynTree::Span<const double> StateTrajectory::momentumInCoM(size_t knot) const
+{
+    return knotSpan(m_momentum, knot);
+}
+
+iDynTree::Span<double> StateTrajectory::comPosition(size_t knot)
+{
+    return knotSpan(m_comPosition, knot);
+}
+
+iDynTree::Span<const double> StateTrajectory::comPosition(size_t knot) const
+{
+    return knotSpan(m_comPosition, knot);
+}
+
+iDynTree::Span<double> StateTrajectory::basePosition(size_t knot)
+{
+    return knotSpan(m_basePosition, knot);
+}
+
+iDynTree::Span<const double> StateTrajectory::basePosition(size_t knot) const
+{
+    return knotSpan(m_basePosition, knot);
+}
+
+iDynTree::Span<double> StateTrajectory::baseQuaternion(size_t knot)
+{
+    return knotSpan(m_baseQuaternion, knot);
+}
+
+iDynTree::Span<const double> StateTrajectory::baseQuaternion(size_t knot) const
+{
+    return knotSpan(m_baseQuaternion, knot);
+}
+
+iDynTree::Span<double> StateTrajectory::jointsConfiguration(size_t knot)
+{
+    return knotSpan(m_joints, knot);
+}
+
+iDynTree::Span<const double> StateTrajectory::jointsConfiguration(size_t knot) const
+{
+    return knotSpan(m_joints, knot);
+}
+
+iDynTree::Span<const double> StateTrajectory::leftPointPositionOverTime(size_t point) const
+{
+    assert(point < m_leftPositions.size());
+    return overTimeSpan(m_leftPositions[point]);
+}
+
+iDynTree::Span<const double> StateTrajectory::leftPointForceOverTime(size_t point) const
+{
+    assert(point < m_leftForces.size());
+    return overTimeSpan(m_leftForces[point]);
+}
+
+iDynTree::Span<const double> StateTrajectory::rightPointPositionOverTime(size_t point) const
+{
+    assert(point < m_rightPositions.size());
+    return overTimeSpan(m_rightPositions[point]);
+}
+
+iDynTree::Span<const double> StateTrajectory::rightPointForceOverTime(size_t point) const
+{
+    assert(point < m_rightForces.size());
+    return overTimeSpan(m_rightForces[point]);
+}
+
+iDynTree::Span<const double> StateTrajectory::momentumInCoMOverTime() const
+{
+    return overTimeSpan(m_momentum);
+}
+
+iDynTree::Span<const double> StateTrajectory::comPositionOverTime() const
+{
+    return overTimeSpan(m_comPosition);
+}
+
+iDynTree::Span<const double> StateTrajectory::basePositionOverTime() const
+{
+    return overTimeSpan(m_basePosition);
+}
+
+iDynTree::Span<const double> StateTrajectory::baseQuaternionOverTime() const
+{
+    return overTimeSpan(m_baseQuaternion);
+}
+
+iDynTree::Span<const double> StateTrajectory::jointsConfigurationOverTime() const
+{
+    return overTimeSpan(m_joints);
+}
+
+bool StateTrajectory::setState(size_t knot, const State &input)
+{
+    if (!input.checkSize(m_numberOfDofs, m_numberOfPoints)) {
+        std::cerr << "[ERROR][StateTrajectory::setState] The input state has not the expected size." << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < m_numberOfPoints; ++i) {
+        iDynTree::toEigen(leftPointPosition(knot, i)) = iDynTree::toEigen(input.leftContactPointsState[i].pointPosition);
+        iDynTree::toEigen(leftPointForce(knot, i)) = iDynTree::toEigen(input.leftContactPointsState[i].pointForce);
+        iDynTree::toEigen(rightPointPosition(knot, i)) = iDynTree::toEigen(input.rightContactPointsState[i].pointPosition);
+        iDynTree::toEigen(rightPointForce(knot, i)) = iDynTree::toEigen(input.rightContactPointsState[i].pointForce);
+    }
+
+    iDynTree::toEigen(momentumInCoM(knot)) = iDynTree::toEigen(input.momentumInCoM);
+    iDynTree::toEigen(comPosition(knot)) = iDynTree::toEigen(input.comPosition);
+    iDynTree::toEigen(basePosition(knot)) = iDynTree::toEigen(input.worldToBaseTransform.getPosition());
+    iDynTree::toEigen(baseQuaternion(knot)) = iDynTree::toEigen(input.worldToBaseTransform.getRotation().asQuaternion());
+    iDynTree::toEigen(jointsConfiguration(knot)) = iDynTree::toEigen(input.jointsConfiguration);
+    time(knot) = input.time;
+
+    return true;
+}
+
+void StateTrajectory::getState(size_t knot, State &output) const
+{
+    if (!output.checkSize(m_numberOfDofs, m_numberOfPoints)) {
+        output.resize(m_numberOfDofs, m_numberOfPoints);
+    }
+
+    for (size_t i = 0; i < m_numberOfPoints; ++i) {
+        iDynTree::toEigen(output.leftContactPointsState[i].pointPosition) = iDynTree::toEigen(leftPointPosition(knot, i));
+        iDynTree::toEigen(output.leftContactPointsState[i].pointForce) = iDynTree::toEigen(leftPointForce(knot, i));
+        iDynTree::toEigen(output.rightContactPointsState[i].pointPosition) = iDynTree::toEigen(rightPointPosition(knot, i));
+        iDynTree::toEigen(output.rightContactPointsState[i].pointForce) = iDynTree::toEigen(rightPointForce(knot, i));
+    }
+
+    iDynTree::toEigen(output.momentumInCoM) = iDynTree::toEigen(momentumInCoM(knot));
+    iDynTree::toEigen(output.comPosition) = iDynTree::toEigen(comPosition(knot));
+
+    iDynTree::Position basePositionBuffer;
+    iDynTree::Vector4 baseQuaternionBuffer;
+    iDynTree::Rotation baseRotationBuffer;
+
+    iDynTree::toEigen(basePositionBuffer) = iDynTree::toEigen(basePosition(knot));
+    Private::NormalizedQuaternionOrIdentity(baseQuaternion(knot), baseQuaternionBuffer);
+    output.worldToBaseTransform.setPosition(basePositionBuffer);
+    baseRotationBuffer.fromQuaternion(baseQuaternionBuffer);
+    output.worldToBaseTransform.setRotation(baseRotationBuffer);
+
+    iDynTree::toEigen(output.jointsConfiguration) = iDynTree::toEigen(jointsConfiguration(knot));
+
+    output.time = time(knot);
+}
+
+bool StateTrajectory::fromStates(const std::vector<State> &states)
+{
+    if (states.empty()) {
+        resize(0, 0, 0);
+        return true;
+    }
+
+    size_t numberOfDofs = states.front().jointsConfiguration.size();
+    size_t numberOfPoints = states.front().leftContactPointsState.size();
+
+    for (auto& state : states) {
+        if (!state.checkSize(numberOfDofs, numberOfPoints)) {
+            std::cerr << "[ERROR][StateTrajectory::fromStates] The states have different sizes." << std::endl;
+            return false;
+        }
+    }
+
+    resize(states.size(), numberOfDofs, numberOfPoints);
+
+    for (size_t knot = 0; knot < states.size(); ++knot) {
+        setState(knot, states[knot]);
+    }
+
+    return true;
+}
+
+void StateTrajectory::toStates(std::vector<State> &states) const
+{
+    states.resize(m_numberOfKnots);
+
+    for (size_t knot = 0; knot < m_numberOfKnots; ++knot) {
+        getState(knot, states[knot]);
+    }
+}
+
+ControlTrajectory::ControlTrajectory()
+{
+    resize(0, 0, 0);
+}
+
+ControlTrajectory::ControlTrajectory(size_t numberOfKnots, size_t numberOfDofs, size_t numberOfPoints)
+{
+    resize(numberOfKnots, numberOfDofs, numberOfPoints);
+}
+
+void ControlTrajectory::resize(size_t numberOfKnots, size_t numberOfDofs, size_t numberOfPoints)
+{
+    setDimensions(numberOfKnots, numberOfDofs, numberOfPoints);
+
+    size_t offset = 0;
+    addPointsQuantities(offset, m_leftForceControls, m_leftVelocityControls);
+    addPointsQuantities(offset, m_rightForceControls, m_rightVelocityControls);
+    m_baseLinearVelocity = addQuantity(3, offset);
+    m_baseQuaternionDerivative = addQuantity(4, offset);
+    m_jointsVelocity = addQuantity(numberOfDofs, offset);
+
+    allocate(offset);
+}
+
+iDynTree::Span<double> ControlTrajectory::leftPointForceControl(size_t knot, size_t point)
+{
+    assert(point < m_leftForceControls.size());
+    return knotSpan(m_leftForceControls[point], knot);
+}
+
+iDynTree::Span<const double> ControlTrajectory::leftPointForceControl(size_t knot, size_t point) const
+{
+    assert(point < m_leftForceControls.size());
+    return knotSpan(m_leftForceControls[point], knot);
+}
+
+iDynTree::Span<double> ControlTrajectory::leftPointVelocityControl(size_t knot, size_t point)
+{
+    assert(point < m_leftVelocityControls.size());
+    return knotSpan(m_leftVelocityControls[point], knot);
+}
+
+iDynTree::Span<const double> ControlTrajectory::leftPointVelocityControl(size_t knot, size_t point) const
+{
+    assert(point < m_leftVelocityControls.size());
+    return knotSpan(m_leftVelocityControls[point], knot);
+}
+
+iDynTree::Span<double> ControlTrajectory::rightPointForceControl(size_t knot, size_t point)
+{
+    assert(point < m_rightForceControls.size());
+    return knotSpan(m_rightForceControls[point], knot);
+}
+
+iDynTree::Span<const double> ControlTrajectory::rightPointForceControl(size_t knot, size_t point) const
+{
+    assert(point < m_rightForceControls.size());
+    return knotSpan(m_rightForceControls[point], knot);
+}
+
+iDynTree::Span<double> ControlTrajectory::rightPointVelocityControl(size_t knot, size_t point)
+{
+    assert(point < m_rightVelocityControls.size());
+    return knotSpan(m_rightVelocityControls[point], knot);
+}
+
+iDynTree::Span<const double> ControlTrajectory::rightPointVelocityControl(size_t knot, size_t point) const
+{
+    assert(point < m_rightVelocityControls.size());
+    return knotSpan(m_rightVelocityControls[point], knot);
+}
+
+iDynTree::Span<double> ControlTrajectory::baseLinearVelocity(size_t knot)
+{
+    return knotSpan(m_baseLinearVelocity, knot);
+}
+
+iDynTree::Span<const double> ControlTrajectory::baseLinearVelocity(size_t knot) const
+{
+    return knotSpan(m_baseLinearVelocity, knot);
+}
+
+iDynTree::Span<double> ControlTrajectory::baseQuaternionDerivative(size_t knot)
+{
+    return knotSpan(m_baseQuaternionDerivative, knot);
+}
+
+iDynTree::Span<const double> ControlTrajectory::baseQuaternionDerivative(size_t knot) const
+{
+    return knotSpan(m_baseQuaternionDerivative, knot);
+}
+
+iDynTree::Span<double> ControlTrajectory::jointsVelocity(size_t knot)
+{
+    return knotSpan(m_jointsVelocity, knot);
+}
+
+iDynTree::Span<const double> ControlTrajectory::jointsVelocity(size_t knot) const
+{
+    return knotSpan(m_jointsVelocity, knot);
+}
+
+iDynTree::Span<const double> ControlTrajectory::leftPointForceControlOverTime(size_t point) const
+{
+    assert(point < m_leftForceControls.size());
+    return overTimeSpan(m_leftForceControls[point]);
+}
+
+iDynTree::Span<const double> ControlTrajectory::leftPointVelocityControlOverTime(size_t point) const
+{
+    assert(point < m_leftVelocityControls.size());
+    return overTimeSpan(m_leftVelocityControls[point]);
+}
+
+iDynTree::Span<const double> ControlTrajectory::rightPointForceControlOverTime(size_t point) const
+{
+    assert(point < m_rightForceControls.size());
+    return overTimeSpan(m_rightForceControls[point]);
+}
+
+iDynTree::Span<const double> ControlTrajectory::rightPointVelocityControlOverTime(size_t point) const
+{
+    assert(point < m_rightVelocityControls.size());
+    return overTimeSpan(m_rightVelocityControls[point]);
+}
+
+iDynTree::Span<const double> ControlTrajectory::baseLinearVelocityOverTime() const
+{
+    return overTimeSpan(m_baseLinearVelocity);
+}
+
+iDynTree::Span<const double> ControlTrajectory::baseQuaternionDerivativeOverTime() const
+{
+    return overTimeSpan(m_baseQuaternionDerivative);
+}
+
+iDynTree::Span<const double> ControlTrajectory::jointsVelocityOverTime() const
+{
+    return overTimeSpan(m_jointsVelocity);
+}
+
+bool ControlTrajectory::setControl(size_t knot, const Control &input)
+{
+    if (!input.checkSize(m_numberOfDofs, m_numberOfPoints)) {
+        std::cerr << "[ERROR][ControlTrajectory::setControl] The input control has not the expected size." << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < m_numberOfPoints; ++i) {
+        iDynTree::toEigen(leftPointForceControl(knot, i)) = iDynTree::toEigen(input.leftContactPointsControl[i].pointForceControl);
+        iDynTree::toEigen(leftPointVelocityControl(knot, i)) = iDynTree::toEigen(input.leftContactPointsControl[i].pointVelocityControl);
+        iDynTree::toEigen(rightPointForceControl(knot, i)) = iDynTree::toEigen(input.rightContactPointsControl[i].pointForceControl);
+        iDynTree::toEigen(rightPointVelocityControl(knot, i)) = iDynTree::toEigen(input.rightContactPointsControl[i].pointVelocityControl);
+    }
+
+    iDynTree::toEigen(baseLinearVelocity(knot)) = iDynTree::toEigen(input.baseLinearVelocity);
+    iDynTree::toEigen(baseQuaternionDerivative(knot)) = iDynTree::toEigen(input.baseQuaternionDerivative);
+    iDynTree::toEigen(jointsVelocity(knot)) = iDynTree::toEigen(input.jointsVelocity);
+    time(knot) = input.time;
+
+    return true;
+}
+
+void ControlTrajectory::getControl(size_t knot, Control &output) const
+{
+    if (!output.checkSize(m_numberOfDofs, m_numberOfPoints)) {
+        output.resize(m_numberOfDofs, m_numberOfPoints);
+    }
+
+    for (size_t i = 0; i < m_numberOfPoints; ++i) {
+        output.leftContactPointsControl[i].pointForceControl = leftPointForceControl(knot, i);
+        output.leftContactPointsControl[i].pointVelocityControl = leftPointVelocityControl(knot, i);
+        output.rightContactPointsControl[i].pointForceControl = rightPointForceControl(knot, i);
+        output.rightContactPointsControl[i].pointVelocityControl = rightPointVelocityControl(knot, i);
+    }
+
+    output.baseLinearVelocity = baseLinearVelocity(knot);
+    output.baseQuaternionDerivative = baseQuaternionDerivative(knot);
+    output.jointsVelocity = jointsVelocity(knot);
+
+    output.time = time(knot);
+}
+
+bool ControlTrajectory::fromControls(const std::vector<Control> &controls)
+{
+    if (controls.empty()) {
+        resize(0, 0, 0);
+        return true;
+    }
+
+    size_t numberOfDofs = controls.front().jointsVelocity.size();
+    size_t numberOfPoints = controls.front().leftContactPointsControl.size();
+
+    for (auto& control : controls) {
+        if (!control.checkSize(numberOfDofs, numberOfPoints)) {
+            std::cerr << "[ERROR][ControlTrajectory::fromControls] The controls have different sizes." << std::endl;
+            return false;
+        }
+    }
+
+    resize(controls.size(), numberOfDofs, numberOfPoints);
+
+    for (size_t knot = 0; knot < controls.size(); ++knot) {
+        setControl(knot, controls[knot]);
+    }
+
+    return true;
+}
+
+void ControlTrajectory::toControls(std::vector<Control> &controls) const
+{
+    controls.resize(m_numberOfKnots);
+
+    for (size_t knot = 0; knot < m_numberOfKnots; ++knot) {
+        getControl(knot, controls[knot]);
+    }
+}
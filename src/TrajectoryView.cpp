@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+
+#include <DynamicalPlanner/TrajectoryView.h>
+#include <DynamicalPlannerPrivate/Utilities/QuaternionUtils.h>
+#include <DynamicalPlannerPrivate/Utilities/VariablesLayout.h>
+#include <iDynTree/Core/EigenHelpers.h>
+#include <cassert>
+
+using namespace DynamicalPlanner;
+
+StateTrajectoryView::StateTrajectoryView()
+    : m_knots(nullptr)
+    , m_timings(nullptr)
+    , m_ranges(nullptr)
+{ }
+
+StateTrajectoryView::StateTrajectoryView(const std::vector<iDynTree::VectorDynSize> &knots, const std::vector<double> &timings,
+                                         const Private::VariablesRanges &ranges)
+    : m_knots(&knots)
+    , m_timings(&timings)
+    , m_ranges(&ranges)
+{ }
+
+iDynTree::Span<const double> StateTrajectoryView::segment(size_t knot, const iDynTree::IndexRange &range) const
+{
+    assert(m_knots && knot < m_knots->size());
+    return iDynTree::make_span((*m_knots)[knot]).subspan(range.offset, range.size);
+}
+
+size_t StateTrajectoryView::size() const
+{
+    return m_timings ? m_timings->size() : 0;
+}
+
+double StateTrajectoryView::time(size_t knot) const
+{
+    assert(m_timings && knot < m_timings->size());
+    return (*m_timings)[knot];
+}
+
+const iDynTree::VectorDynSize &StateTrajectoryView::rawKnot(size_t knot) const
+{
+    assert(m_knots && knot < m_knots->size());
+    return (*m_knots)[knot];
+}
+
+iDynTree::Span<const double> StateTrajectoryView::leftPointPosition(size_t knot, size_t point) const
+{
+    return segment(knot, m_ranges->left.positionPoints[point]);
+}
+
+iDynTree::Span<const double> StateTrajectoryView::leftPointForce(size_t knot, size_t point) const
+{
+    return segment(knot, m_ranges->left.forcePoints[point]);
+}
+
+iDynTree::Span<const double> StateTrajectoryView::rightPointPosition(size_t knot, size_t point) const
+{
+    return segment(knot, m_ranges->right.positionPoints[point]);
+}
+
+iDynTree::Span<const double> StateTrajectoryView::rightPointForce(size_t knot, size_t point) const
+{
+    return segment(knot, m_ranges->right.forcePoints[point]);
+}
+
+iDynTree::Span<const double> StateTrajectoryView::momentumInCoM(size_t knot) const
+{
+    return segment(knot, m_ranges->momentum);
+}
+
+iDynTree::Span<const double> StateTrajectoryView::comPosition(size_t knot) const
+{
+    return segment(knot, m_ranges->comPosition);
+}
+
+iDynTree::Span<const double> StateTrajectoryView::basePosition(size_t knot) const
+{
+    return segment(knot, m_ranges->basePosition);
+}
+
+iDynTree::Span<const double> StateTrajectoryView::baseQuaternion(size_t knot) const
+{
+    return segment(knot, m_ranges->baseQuaternion);
+}
+
+iDynTree::Span<const double> StateTrajectoryView::jointsConfiguration(size_t knot) const
+{
+    return segment(knot, m_ranges->jointsPosition);
+}
+
+void StateTrajectoryView::toState(size_t knot, State &output) const
+{
+    for (size_t i = 0; i < m_ranges->left.positionPoints.size(); ++i) {
+        iDynTree::toEigen(output.leftContactPointsState[i].pointPosition) = iDynTree::toEigen(leftPointPosition(knot, i));
+        iDynTree::toEigen(output.leftContactPointsState[i].pointForce) = iDynTree::toEigen(leftPointForce(knot, i));
+    }
+
+    for (size_t i = 0; i < m_ranges->right.positionPoints.size(); ++i) {
+        iDynTree::toEigen(output.rightContactPointsState[i].pointPosition) = iDynTree::toEigen(rightPointPosition(knot, i));
+        iDynTree::toEigen(output.rightContactPointsState[i].pointForce) = iDynTree::toEigen(rightPointForce(knot, i));
+    }
+
+    iDynTree::toEigen(output.momentumInCoM) = iDynTree::toEigen(momentumInCoM(knot));
+    iDynTree::toEigen(output.comPosition) = iDynTree::toEigen(comPosition(knot));
+
+    iDynTree::Position basePositionBuffer;
+    iDynTree::Vector4 baseQuaternionBuffer;
+    iDynTree::Rotation baseRotationBuffer;
+
+    iDynTree::toEigen(basePositionBuffer) = iDynTree::toEigen(basePosition(knot));
+    Private::NormalizedQuaternionOrIdentity(baseQuaternion(knot), baseQuaternionBuffer);
+    output.worldToBaseTransform.setPosition(basePositionBuffer);
+    baseRotationBuffer.fromQuaternion(baseQuaternionBuffer);
+    output.worldToBaseTransform.setRotation(baseRotationBuffer);
+
+    iDynTree::toEigen(output.jointsConfiguration) = iDynTree::toEigen(jointsConfiguration(knot));
+
+    output.time = time(knot);
+}
+
+ControlTrajectoryView::ControlTrajectoryView()
+    : m_knots(nullptr)
+    , m_timings(nullptr)
+    , m_ranges(nullptr)
+{ }
+
+ControlTrajectoryView::ControlTrajectoryView(const std::vector<iDynTree::VectorDynSize> &knots, const std::vector<double> &timings,
+                                             const Private::VariablesRanges &ranges)
+    : m_knots(&knots)
+    , m_timings(&timings)
+    , m_ranges(&ranges)
+{ }
+
+iDynTree::Span<const double> ControlTrajectoryView::segment(size_t knot, const iDynTree::IndexRange &range) const
+{
+    assert(m_knots && knot < m_knots->size());
+    return iDynTree::make_span((*m_knots)[knot]).subspan(range.offset, range.size);
+}
+
+size_t ControlTrajectoryView::size() const
+{
+    return m_timings ? m_timings->size() : 0;
+}
+
+double ControlTrajectoryView::time(size_t knot) const
+{
+    assert(m_timings && knot < m_timings->size());
+    return (*m_timings)[knot];
+}
+
+const iDynTree::VectorDynSize &ControlTrajectoryView::rawKnot(size_t knot) const
+{
+    assert(m_knots && knot < m_knots->size());
+    return (*m_knots)[knot];
+}
+
+iDynTree::Span<const double> ControlTrajectoryView::leftPointForceControl(size_t knot, size_t point) const
+{
+    return segment(knot, m_ranges->left.forceControlPoints[point]);
+}
+
+iDynTree::Span<const double> ControlTrajectoryView::leftPointVelocityControl(size_t knot, size_t point) const
+{
+    return segment(knot, m_ranges->left.velocityControlPoints[point]);
+}
+
+iDynTree::Span<const double> ControlTrajectoryView::rightPointForceControl(size_t knot, size_t point) const
+{
+    return segment(knot, m_ranges->right.forceControlPoints[point]);
+}
+
+iDynTree::Span<const double> ControlTrajectoryView::rightPointVelocityControl(size_t knot, size_t point) const
+{
+    return segment(knot, m_ranges->right.velocityControlPoints[point]);
+}
+
+iDynTree::Span<const double> ControlTrajectoryView::baseLinearVelocity(size_t knot) const
+{
+    return segment(knot, m_ranges->baseLinearVelocity);
+}
+
+iDynTree::Span<const double> ControlTrajectoryView::baseQuaternionDerivative(size_t knot) const
+{
+    return segment(knot, m_ranges->baseQuaternionDerivative);
+}
+
+iDynTree::Span<const double> ControlTrajectoryView::jointsVelocity(size_t knot) const
+{
+    return segment(knot, m_ranges->jointsVelocity);
+}
+
+void ControlTrajectoryView::toControl(size_t knot, Control &output) const
+{
+    for (size_t i = 0; i < m_ranges->left.forceControlPoints.size(); ++i) {
+        output.leftContactPointsControl[i].pointForceControl = leftPointForceControl(knot, i);
+        output.leftContactPointsControl[i].pointVelocityControl = leftPointVelocityControl(knot, i);
+    }
+
+    for (size_t i = 0; i < m_ranges->right.forceControlPoints.size(); ++i) {
+        output.rightContactPointsControl[i].pointForceControl = rightPointForceControl(knot, i);
+        output.rightContactPointsControl[i].pointVelocityControl = rightPointVelocityControl(knot, i);
+    }
+
+    output.baseLinearVelocity = baseLinearVelocity(knot);
+    output.baseQuaternionDerivative = baseQuaternionDerivative(knot);
+    output.jointsVelocity = jointsVelocity(knot);
+    output.time = time(knot);
+}
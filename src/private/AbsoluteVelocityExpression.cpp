@@ -145,7 +145,7 @@ public:
 
                 m_cols[jointIndex] = expressionsServer->adjointTransform(targetFrame, model.getLinkName(visitedLink)) *
                     (-expressionsServer->motionSubSpaceAsCrossProduct(jointPtr->getIndex(), parentLink, visitedLink)) *
-                    (expressionsServer->absoluteVelocity(model.getLinkName(visitedLink), baseTwist));
+                    (expressionsServer->absoluteVelocity(visitedLink, baseTwist));
 
                 m_nonZeros.push_back(jointIndex);
 
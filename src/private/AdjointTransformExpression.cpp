@@ -28,6 +28,7 @@ class DynamicalPlanner::Private::AdjointTransformEvaluable : public levi::Defaul
 
     ExpressionsServer* m_expressionsServer;
     std::string m_baseFrameName, m_targetFrameName, m_parentFrameName;
+    iDynTree::FrameIndex m_baseFrame, m_targetFrame;
     iDynTree::LinkIndex m_targetLink, m_parentLink;
     iDynTree::IJointConstPtr m_parentJoint = nullptr;
     iDynTree::Transform m_linkToTargetTransform;
@@ -51,6 +52,8 @@ public:
         assert(baseFrameIndex != iDynTree::FRAME_INVALID_INDEX);
         iDynTree::FrameIndex targetFrameIndex = model.getFrameIndex(targetFrame);
         assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+        m_baseFrame = baseFrameIndex;
+        m_targetFrame = targetFrameIndex;
         iDynTree::LinkIndex baseLink = model.getFrameLink(baseFrameIndex);
         assert(baseLink != iDynTree::LINK_INVALID_INDEX);
 
@@ -88,7 +91,7 @@ public:
 //            m_evaluationBuffer = m_expressionsServer->adjointTransform(m_baseFrameName, m_parentFrameName).evaluate() *
 //                iDynTree::toEigen((m_parentJoint->getTransform(m_expressionsServer->currentState().s, m_parentLink, m_targetLink) *
 //                                   m_linkToTargetTransform).asAdjointTransform());
-            m_evaluationBuffer = iDynTree::toEigen(m_expressionsServer->currentKinDyn()->getRelativeTransform(m_expressionsServer->currentState(), m_baseFrameName, m_targetFrameName).asAdjointTransform());
+            m_evaluationBuffer = iDynTree::toEigen(m_expressionsServer->currentKinDyn()->getRelativeTransform(m_expressionsServer->currentState(), m_baseFrame, m_targetFrame).asAdjointTransform());
         }
 
         return m_evaluationBuffer;
@@ -103,7 +106,7 @@ AdjointTransformEvaluable::getColumnDerivative(Eigen::Index column, std::shared_
 {
     if (!m_isConstant && (variable->variableName() == m_jointsVariable.name() && variable->dimension() == m_jointsVariable.rows())) {
 
-        return m_expressionsServer->adjointTransformJointsDerivative(m_baseFrameName, m_targetFrameName, column);
+        return m_expressionsServer->adjointTransformJointsDerivative(m_baseFrame, m_targetFrame, column);
 
     } else {
         return levi::Null(6, variable->dimension());
@@ -116,6 +119,7 @@ class DynamicalPlanner::Private::AdjointTransformWrenchEvaluable : public levi::
 
     ExpressionsServer* m_expressionsServer;
     std::string m_baseFrameName, m_targetFrameName, m_parentFrameName;
+    iDynTree::FrameIndex m_baseFrame, m_targetFrame;
     iDynTree::LinkIndex m_targetLink, m_parentLink;
     iDynTree::IJointConstPtr m_parentJoint = nullptr;
     iDynTree::Transform m_linkToTargetTransform;
@@ -139,6 +143,8 @@ public:
         assert(baseFrameIndex != iDynTree::FRAME_INVALID_INDEX);
         iDynTree::FrameIndex targetFrameIndex = model.getFrameIndex(targetFrame);
         assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+        m_baseFrame = baseFrameIndex;
+        m_targetFrame = targetFrameIndex;
         iDynTree::LinkIndex baseLink = model.getFrameLink(baseFrameIndex);
         assert(baseLink != iDynTree::LINK_INVALID_INDEX);
 
@@ -175,7 +181,7 @@ public:
 //                iDynTree::toEigen((m_parentJoint->getTransform(m_expressionsServer->currentState().s, m_parentLink, m_targetLink) *
 //                                   m_linkToTargetTransform).asAdjointTransformWrench());
 
-            m_evaluationBuffer = iDynTree::toEigen(m_expressionsServer->currentKinDyn()->getRelativeTransform(m_expressionsServer->currentState(), m_baseFrameName, m_targetFrameName).asAdjointTransformWrench());
+            m_evaluationBuffer = iDynTree::toEigen(m_expressionsServer->currentKinDyn()->getRelativeTransform(m_expressionsServer->currentState(), m_baseFrame, m_targetFrame).asAdjointTransformWrench());
 
         }
 
@@ -191,7 +197,7 @@ AdjointTransformWrenchEvaluable::getColumnDerivative(Eigen::Index column, std::s
 {
     if (!m_isConstant && (variable->variableName() == m_jointsVariable.name() && variable->dimension() == m_jointsVariable.rows())) {
 
-        return m_expressionsServer->adjointTransformWrenchJointsDerivative(m_baseFrameName, m_targetFrameName, column);
+        return m_expressionsServer->adjointTransformWrenchJointsDerivative(m_baseFrame, m_targetFrame, column);
 
     } else {
         return levi::Null(6, variable->dimension());
@@ -251,7 +257,7 @@ public:
             parentLink = traversal.getParentLinkIndexFromJointIndex(model, jointPtr->getIndex());
 
             jointsDerivative[jointIndex] =
-                expressionsServer->adjointTransform(baseFrame, targetFrame) * expressionsServer->motionSubSpaceAsCrossProduct(jointPtr->getIndex(), parentLink, targetLink);
+                expressionsServer->adjointTransform(baseFrameIndex, targetFrameIndex) * expressionsServer->motionSubSpaceAsCrossProduct(jointPtr->getIndex(), parentLink, targetLink);
 
             m_nonZeros.push_back(jointIndex);
 
@@ -264,9 +270,9 @@ public:
 
                 parentLink = traversal.getParentLinkIndexFromJointIndex(model, jointPtr->getIndex());
 
-                jointsDerivative[jointIndex] = expressionsServer->adjointTransform(baseFrame, model.getLinkName(visitedLink)) *
+                jointsDerivative[jointIndex] = expressionsServer->adjointTransform(baseFrameIndex, visitedLink) *
                     expressionsServer->motionSubSpaceAsCrossProduct(jointPtr->getIndex(), parentLink, visitedLink) *
-                    expressionsServer->adjointTransform(model.getLinkName(visitedLink), targetFrame);
+                    expressionsServer->adjointTransform(visitedLink, targetFrameIndex);
 
                 m_nonZeros.push_back(jointIndex);
 
@@ -377,7 +383,7 @@ public:
             parentLink = traversal.getParentLinkIndexFromJointIndex(model, jointPtr->getIndex());
 
             jointsDerivative[jointIndex] =
-                expressionsServer->adjointTransformWrench(baseFrame, targetFrame) * expressionsServer->motionSubSpaceAsCrossProductWrench(jointPtr->getIndex(), parentLink, targetLink);
+                expressionsServer->adjointTransformWrench(baseFrameIndex, targetFrameIndex) * expressionsServer->motionSubSpaceAsCrossProductWrench(jointPtr->getIndex(), parentLink, targetLink);
 
             m_nonZeros.push_back(jointIndex);
 
@@ -390,9 +396,9 @@ public:
 
                 parentLink = traversal.getParentLinkIndexFromJointIndex(model, jointPtr->getIndex());
 
-                jointsDerivative[jointIndex] = expressionsServer->adjointTransformWrench(baseFrame, model.getLinkName(visitedLink)) *
+                jointsDerivative[jointIndex] = expressionsServer->adjointTransformWrench(baseFrameIndex, visitedLink) *
                     expressionsServer->motionSubSpaceAsCrossProductWrench(jointPtr->getIndex(), parentLink, visitedLink) *
-                    expressionsServer->adjointTransformWrench(model.getLinkName(visitedLink), targetFrame);
+                    expressionsServer->adjointTransformWrench(visitedLink, targetFrameIndex);
 
                 m_nonZeros.push_back(jointIndex);
 
@@ -7,7 +7,6 @@
 
 #include <levi/levi.h>
 #include <DynamicalPlannerPrivate/Constraints/CentroidalMomentumConstraint.h>
-#include <DynamicalPlannerPrivate/Utilities/CheckEqualVector.h>
 #include <iDynTree/Core/EigenHelpers.h>
 #include <DynamicalPlannerPrivate/Utilities/QuaternionUtils.h>
 #include <DynamicalPlannerPrivate/Utilities/levi/CoMInBaseExpression.h>
@@ -16,9 +15,7 @@
 #include <DynamicalPlannerPrivate/Utilities/levi/RelativeVelocityExpression.h>
 #include <DynamicalPlannerPrivate/Utilities/levi/MomentumInBaseExpression.h>
 #include <cassert>
-#include <thread>
-#include <future>
-#include <chrono>
+#include <iostream>
 
 using namespace DynamicalPlanner::Private;
 
@@ -30,13 +27,12 @@ public:
     iDynTree::IndexRange momentumRange, comPositionRange, basePositionRange, baseQuaternionRange, jointsPositionRange, jointsVelocityRange;
 //    iDynTree::IndexRange baseVelocityRange;
     iDynTree::IndexRange baseLinearVelocityRange, baseQuaternionDerivativeRange;
-    iDynTree::VectorDynSize constraintValueBuffer;
+    iDynTree::VectorDynSize constraintValueBuffer; //momentum expected from the robot state, the momentum variable is subtracted at every call
     iDynTree::Position basePosition;
     iDynTree::Position comPosition;
     iDynTree::Vector4 baseQuaternion, baseQuaternionNormalized, baseQuaternionVelocity;
     iDynTree::Rotation baseRotation;
     iDynTree::Transform comTransform;
-    iDynTree::Vector6 momentum;
 
     iDynTree::MatrixDynSize cmmMatrixInCoMBuffer, cmmMatrixInBaseBuffer,
     momentumDerivativeBuffer, stateJacobianBuffer, controlJacobianBuffer, comJacobianBuffer;
@@ -47,10 +43,9 @@ public:
     std::shared_ptr<TimelySharedKinDynComputations> timedSharedKinDyn;
     std::shared_ptr<ExpressionsServer> expressionsServer;
 
-    bool updateDoneOnceConstraint = false;
-    bool updateDoneOnceStateJacobian = false;
-    bool updateDoneOnceControlJacobian = false;
-    double tolerance;
+    uint64_t constraintVersion = 0; //versions of the robot state used to compute the cached values
+    uint64_t stateJacobianVersion = 0;
+    uint64_t controlJacobianVersion = 0;
 
     iDynTree::optimalcontrol::SparsityStructure stateJacobianSparsity, controlJacobianSparsity;
     iDynTree::optimalcontrol::SparsityStructure stateHessianSparsity, controlHessianSparsity, mixedHessianSparsity;
@@ -63,8 +58,10 @@ public:
     levi::Variable comPositionVariable;
 
     levi::Variable lagrangeMultipliers = levi::Variable(3, "lambdaCentroidal");
+    levi::Expression notNormalizedQuaternionMapExpr, comJacobian;
     levi::Expression quatQuatHessian, quatJointsHessian, jointsJointsHessian, quatLinVelHessian, quatQuatVelHessian, quatJointsVelHessian,
         jointsLinVelHessian, jointsQuatVelHessian, jointsJointsVelHessian;
+    bool hessianExpressionsBuilt = false;
 
 
     void getRanges() {
@@ -123,27 +120,23 @@ public:
 
     }
 
-    void updateVariables (){
-        updateRobotState();
+    void updateCoMTransform() {
 //        comPosition = stateVariables(comPositionRange);
 //        iDynTree::toEigen(comPositionInverse) = -1 * iDynTree::toEigen(comPosition);
         comPosition = sharedKinDyn->getCenterOfMassPosition(robotState);
         comTransform.setPosition(iDynTree::Position(0.0, 0.0, 0.0) - comPosition);
         comTransform.setRotation(iDynTree::Rotation::Identity());
-        momentum = stateVariables(momentumRange);
     }
 
-    bool sameVariables(bool updateDoneOnce) {
-        bool same = updateDoneOnce;
-        same = same && VectorsAreEqual(momentum, stateVariables(momentumRange), tolerance);
-        same = same && VectorsAreEqual(comPosition, stateVariables(comPositionRange), tolerance);
-        same = same && VectorsAreEqual(basePosition, stateVariables(basePositionRange), tolerance);
-        same = same && VectorsAreEqual(baseQuaternion, stateVariables(baseQuaternionRange), tolerance);
-        same = same && VectorsAreEqual(robotState.s, stateVariables(jointsPositionRange), tolerance);
-        same = same && VectorsAreEqual(robotState.base_linearVelocity, controlVariables(baseLinearVelocityRange), tolerance);
-        same = same && VectorsAreEqual(baseQuaternionVelocity, controlVariables(baseQuaternionDerivativeRange), tolerance);
-        same = same && VectorsAreEqual(robotState.s_dot, controlVariables(jointsVelocityRange), tolerance);
+    void updateVariables (){
+        updateRobotState();
+        updateCoMTransform();
+    }
 
+    bool sameVariables(uint64_t& lastVersion) { //Updates the robot state. True if its version is the one used to compute the cached values.
+        updateRobotState();
+        bool same = (robotState.version.value() != 0) && (robotState.version.value() == lastVersion);
+        lastVersion = robotState.version.value();
         return same;
     }
 
@@ -205,15 +198,21 @@ public:
 
         asExpression = mixedAdjointBottomRows * DynamicalPlanner::Private::MomentumInBaseExpression(expressionsServer.get(), baseTwist.asVariable());
 
-        levi::Expression notNormalizedQuaternionMapExpr =
+        notNormalizedQuaternionMapExpr =
             expressionsServer->normalizedBaseQuaternion().getColumnDerivative(0, expressionsServer->baseQuaternion());
 
         quaternionDerivative = asExpression.getColumnDerivative(0, normalizedQuaternion) * notNormalizedQuaternionMapExpr;
 
-        levi::Expression comJacobian = expressionsServer->comInBase().getColumnDerivative(0, expressionsServer->jointsPosition());
+        comJacobian = expressionsServer->comInBase().getColumnDerivative(0, expressionsServer->jointsPosition());
 
         jointsDerivative = asExpression.getColumnDerivative(0, expressionsServer->jointsPosition())
             + asExpression.getColumnDerivative(0, comPositionVariable) * comJacobian;
+    }
+
+    void buildHessianExpressions() { //The second derivatives are built only when first needed
+        if (hessianExpressionsBuilt) {
+            return;
+        }
 
         levi::Expression lagrangian = lagrangeMultipliers.transpose() * asExpression;
         levi::Expression jointsLagrangian = (lagrangian.getColumnDerivative(0, expressionsServer->jointsPosition())
@@ -235,21 +234,37 @@ public:
         jointsLinVelHessian = jointsLagrangian.getColumnDerivative(0, expressionsServer->baseLinearVelocity());
         jointsQuatVelHessian = jointsLagrangian.getColumnDerivative(0, expressionsServer->baseQuaternionVelocity());
         jointsJointsVelHessian = jointsLagrangian.getColumnDerivative(0, expressionsServer->jointsVelocity());
+
+        quatQuatHessian = expressionsServer->flatten(quatQuatHessian, "centroidalQuatQuatHessian");
+        quatJointsHessian = expressionsServer->flatten(quatJointsHessian, "centroidalQuatJointsHessian");
+        jointsJointsHessian = expressionsServer->flatten(jointsJointsHessian, "centroidalJointsJointsHessian");
+        quatLinVelHessian = expressionsServer->flatten(quatLinVelHessian, "centroidalQuatLinVelHessian");
+        quatQuatVelHessian = expressionsServer->flatten(quatQuatVelHessian, "centroidalQuatQuatVelHessian");
+        quatJointsVelHessian = expressionsServer->flatten(quatJointsVelHessian, "centroidalQuatJointsVelHessian");
+        jointsLinVelHessian = expressionsServer->flatten(jointsLinVelHessian, "centroidalJointsLinVelHessian");
+        jointsQuatVelHessian = expressionsServer->flatten(jointsQuatVelHessian, "centroidalJointsQuatVelHessian");
+        jointsJointsVelHessian = expressionsServer->flatten(jointsJointsVelHessian, "centroidalJointsJointsVelHessian");
+
+        hessianExpressionsBuilt = true;
     }
 
     ~Implementation() {
         asExpression.clearDerivativesCache();
         quaternionDerivative.clearDerivativesCache();
         jointsDerivative.clearDerivativesCache();
-        quatQuatHessian.clearDerivativesCache();
-        quatJointsHessian.clearDerivativesCache();
-        jointsJointsHessian.clearDerivativesCache();
-        quatLinVelHessian.clearDerivativesCache();
-        quatQuatVelHessian.clearDerivativesCache();
-        quatJointsVelHessian.clearDerivativesCache();
-        jointsLinVelHessian.clearDerivativesCache();
-        jointsQuatVelHessian.clearDerivativesCache();
-        jointsJointsVelHessian.clearDerivativesCache();
+        notNormalizedQuaternionMapExpr.clearDerivativesCache();
+        comJacobian.clearDerivativesCache();
+        if (hessianExpressionsBuilt) {
+            quatQuatHessian.clearDerivativesCache();
+            quatJointsHessian.clearDerivativesCache();
+            jointsJointsHessian.clearDerivativesCache();
+            quatLinVelHessian.clearDerivativesCache();
+            quatQuatVelHessian.clearDerivativesCache();
+            quatJointsVelHessian.clearDerivativesCache();
+            jointsLinVelHessian.clearDerivativesCache();
+            jointsQuatVelHessian.clearDerivativesCache();
+            jointsJointsVelHessian.clearDerivativesCache();
+        }
     }
 
 };
@@ -290,7 +305,6 @@ CentroidalMomentumConstraint::CentroidalMomentumConstraint(const VariablesLabell
     m_pimpl->comJacobianBuffer.resize(6, 6 + static_cast<unsigned int>(m_pimpl->jointsPositionRange.size));
     m_pimpl->comJacobianBuffer.zero();
 
-    m_pimpl->tolerance = timelySharedKinDyn->getUpdateTolerance();
 
     m_pimpl->setSparsity();
 
@@ -319,20 +333,20 @@ bool CentroidalMomentumConstraint::evaluateConstraint(double time, const iDynTre
 
     m_pimpl->sharedKinDyn = m_pimpl->timedSharedKinDyn->get(time);
 
-    if (!(m_pimpl->sameVariables(m_pimpl->updateDoneOnceConstraint))) {
+    if (!(m_pimpl->sameVariables(m_pimpl->constraintVersion))) {
 
-//        m_pimpl->updateDoneOnceConstraint = true;
-        m_pimpl->updateVariables();
+        m_pimpl->updateCoMTransform();
 
         iDynTree::SpatialMomentum expectedMomentum;
         expectedMomentum = m_pimpl->comTransform *
                 (m_pimpl->sharedKinDyn->getBaseTransform(m_pimpl->robotState) *
                  m_pimpl->sharedKinDyn->getLinearAngularMomentum(m_pimpl->robotState, iDynTree::FrameVelocityRepresentation::BODY_FIXED_REPRESENTATION));
 
-        iDynTree::toEigen(m_pimpl->constraintValueBuffer) = iDynTree::toEigen(expectedMomentum) - iDynTree::toEigen(m_pimpl->momentum);
+        iDynTree::toEigen(m_pimpl->constraintValueBuffer) = iDynTree::toEigen(expectedMomentum);
     }
 
-    iDynTree::toEigen(constraint) = iDynTree::toEigen(m_pimpl->constraintValueBuffer).bottomRows<3>();
+    iDynTree::toEigen(constraint) = iDynTree::toEigen(m_pimpl->constraintValueBuffer).bottomRows<3>() -
+            iDynTree::toEigen(m_pimpl->stateVariables(m_pimpl->momentumRange)).bottomRows<3>();
 
     return true;
 }
@@ -344,10 +358,9 @@ bool CentroidalMomentumConstraint::constraintJacobianWRTState(double time, const
 
     m_pimpl->sharedKinDyn = m_pimpl->timedSharedKinDyn->get(time);
 
-    if (!(m_pimpl->sameVariables(m_pimpl->updateDoneOnceStateJacobian))) {
+    if (!(m_pimpl->sameVariables(m_pimpl->stateJacobianVersion))) {
 
-//        m_pimpl->updateDoneOnceStateJacobian = true;
-        m_pimpl->updateVariables();
+        m_pimpl->updateCoMTransform();
 
         iDynTree::Transform G_T_B = m_pimpl->comTransform * m_pimpl->sharedKinDyn->getBaseTransform(m_pimpl->robotState);
 
@@ -427,10 +440,9 @@ bool CentroidalMomentumConstraint::constraintJacobianWRTControl(double time, con
 
     m_pimpl->sharedKinDyn = m_pimpl->timedSharedKinDyn->get(time);
 
-    if (!(m_pimpl->sameVariables(m_pimpl->updateDoneOnceControlJacobian))) {
+    if (!(m_pimpl->sameVariables(m_pimpl->controlJacobianVersion))) {
 
-//        m_pimpl->updateDoneOnceControlJacobian = true;
-        m_pimpl->updateVariables();
+        m_pimpl->updateCoMTransform();
 
         iDynTree::Transform G_T_B = m_pimpl->comTransform * m_pimpl->sharedKinDyn->getBaseTransform(m_pimpl->robotState);
 
@@ -477,6 +489,13 @@ bool CentroidalMomentumConstraint::constraintJacobianWRTControlSparsity(iDynTree
 
 bool CentroidalMomentumConstraint::constraintSecondPartialDerivativeWRTState(double time, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, const iDynTree::VectorDynSize &lambda, iDynTree::MatrixDynSize &hessian)
 {
+    if (!m_pimpl->expressionsServer->hessiansEnabled()) {
+        std::cerr << "[ERROR][CentroidalMomentumConstraint::constraintSecondPartialDerivativeWRTState] The Hessians have been disabled." << std::endl;
+        return false;
+    }
+
+    m_pimpl->buildHessianExpressions();
+
     m_pimpl->stateVariables = state;
     m_pimpl->controlVariables = control;
 
@@ -490,45 +509,17 @@ bool CentroidalMomentumConstraint::constraintSecondPartialDerivativeWRTState(dou
 
     m_pimpl->lagrangeMultipliers = lambdaMap;
 
-    auto quatQuat = std::async(std::launch::async, &levi::Expression::evaluate, m_pimpl->quatQuatHessian);
-    auto quatJoints = std::async(std::launch::async, &levi::Expression::evaluate, m_pimpl->quatJointsHessian);
-    auto jointsJoints = std::async(std::launch::async, &levi::Expression::evaluate, m_pimpl->jointsJointsHessian);
-
-    using namespace std::chrono_literals;
-    std::this_thread::sleep_for(10us);
+    //Sequential evaluation: spawning a thread per block allocated memory at every call
+    hessianMap.block<4,4>(m_pimpl->baseQuaternionRange.offset, m_pimpl->baseQuaternionRange.offset) = m_pimpl->quatQuatHessian.evaluate();
 
-    bool quatQuatDone = false, quatJointsDone = false, jointsJointsDone = false;
+    const Eigen::MatrixXd& quatJointsOutput = m_pimpl->quatJointsHessian.evaluate();
+    hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->baseQuaternionRange.offset, m_pimpl->jointsPositionRange.size, 4) =
+        quatJointsOutput.transpose();
+    hessianMap.block(m_pimpl->baseQuaternionRange.offset, m_pimpl->jointsPositionRange.offset, 4, m_pimpl->jointsPositionRange.size) =
+        quatJointsOutput;
 
-    while (!quatQuatDone || !quatJointsDone || !jointsJointsDone) {
-
-        std::this_thread::sleep_for(1us);
-
-        if (!quatQuatDone) {
-            if (quatQuat.wait_for(1us) == std::future_status::ready) {
-                hessianMap.block<4,4>(m_pimpl->baseQuaternionRange.offset, m_pimpl->baseQuaternionRange.offset) = quatQuat.get();
-                quatQuatDone = true;
-            }
-        }
-
-        if (!quatJointsDone) {
-            if (quatJoints.wait_for(1us) == std::future_status::ready) {
-                const Eigen::MatrixXd hessianOutput = quatJoints.get();
-                hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->baseQuaternionRange.offset, m_pimpl->jointsPositionRange.size, 4) =
-                    hessianOutput.transpose();
-                hessianMap.block(m_pimpl->baseQuaternionRange.offset, m_pimpl->jointsPositionRange.offset, 4, m_pimpl->jointsPositionRange.size) =
-                    hessianOutput;
-                quatJointsDone = true;
-            }
-        }
-
-        if (!jointsJointsDone) {
-            if (jointsJoints.wait_for(1us) == std::future_status::ready) {
-                hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->jointsPositionRange.offset,
-                                 m_pimpl->jointsPositionRange.size, m_pimpl->jointsPositionRange.size) = jointsJoints.get();
-                jointsJointsDone = true;
-            }
-        }
-    }
+    hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->jointsPositionRange.offset,
+                     m_pimpl->jointsPositionRange.size, m_pimpl->jointsPositionRange.size) = m_pimpl->jointsJointsHessian.evaluate();
 
     return true;
 }
@@ -543,6 +534,13 @@ bool CentroidalMomentumConstraint::constraintSecondPartialDerivativeWRTControl(d
 
 bool CentroidalMomentumConstraint::constraintSecondPartialDerivativeWRTStateControl(double time, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, const iDynTree::VectorDynSize &lambda, iDynTree::MatrixDynSize &hessian)
 {
+    if (!m_pimpl->expressionsServer->hessiansEnabled()) {
+        std::cerr << "[ERROR][CentroidalMomentumConstraint::constraintSecondPartialDerivativeWRTStateControl] The Hessians have been disabled." << std::endl;
+        return false;
+    }
+
+    m_pimpl->buildHessianExpressions();
+
     m_pimpl->stateVariables = state;
     m_pimpl->controlVariables = control;
 
@@ -556,78 +554,21 @@ bool CentroidalMomentumConstraint::constraintSecondPartialDerivativeWRTStateCont
 
     m_pimpl->lagrangeMultipliers = lambdaMap;
 
-    auto quatLinVel = std::async(std::launch::async, &levi::Expression::evaluate, m_pimpl->quatLinVelHessian);
-    auto quatQuatVel = std::async(std::launch::async, &levi::Expression::evaluate, m_pimpl->quatQuatVelHessian);
-    auto quatJointsVel = std::async(std::launch::async, &levi::Expression::evaluate, m_pimpl->quatJointsVelHessian);
-    auto jointsLinVel = std::async(std::launch::async, &levi::Expression::evaluate, m_pimpl->jointsLinVelHessian);
-    auto jointsQuatVel = std::async(std::launch::async, &levi::Expression::evaluate, m_pimpl->jointsQuatVelHessian);
-    auto jointsJointsVel = std::async(std::launch::async, &levi::Expression::evaluate, m_pimpl->jointsJointsVelHessian);
-
-    using namespace std::chrono_literals;
-    std::this_thread::sleep_for(10us);
-
-    bool quatLinVelDone = false;
-    bool quatQuatVelDone = false;
-    bool quatJointsVelDone = false;
-    bool jointsLinVelDone = false;
-    bool jointsQuatVelDone = false;
-    bool jointsJointsVelDone = false;
-
-    while (!quatLinVelDone ||
-           !quatQuatVelDone ||
-           !quatJointsVelDone ||
-           !jointsLinVelDone ||
-           !jointsQuatVelDone ||
-           !jointsJointsVelDone) {
-
-        std::this_thread::sleep_for(1us);
-
-        if (!quatLinVelDone) {
-            if (quatLinVel.wait_for(1us) == std::future_status::ready) {
-                hessianMap.block<4, 3>(m_pimpl->baseQuaternionRange.offset, m_pimpl->baseLinearVelocityRange.offset) = quatLinVel.get();
-                quatLinVelDone = true;
-            }
-        }
+    hessianMap.block<4, 3>(m_pimpl->baseQuaternionRange.offset, m_pimpl->baseLinearVelocityRange.offset) = m_pimpl->quatLinVelHessian.evaluate();
 
-        if (!quatQuatVelDone) {
-            if (quatQuatVel.wait_for(1us) == std::future_status::ready) {
-                hessianMap.block<4,4>(m_pimpl->baseQuaternionRange.offset, m_pimpl->baseQuaternionDerivativeRange.offset) = quatQuatVel.get();
-                quatQuatVelDone = true;
-            }
-        }
+    hessianMap.block<4,4>(m_pimpl->baseQuaternionRange.offset, m_pimpl->baseQuaternionDerivativeRange.offset) = m_pimpl->quatQuatVelHessian.evaluate();
 
-        if (!quatJointsVelDone) {
-            if (quatJointsVel.wait_for(1us) == std::future_status::ready) {
-                hessianMap.block(m_pimpl->baseQuaternionRange.offset, m_pimpl->jointsVelocityRange.offset,
-                                 4, m_pimpl->jointsVelocityRange.size) = quatJointsVel.get();
-                quatJointsVelDone = true;
-            }
-        }
+    hessianMap.block(m_pimpl->baseQuaternionRange.offset, m_pimpl->jointsVelocityRange.offset,
+                     4, m_pimpl->jointsVelocityRange.size) = m_pimpl->quatJointsVelHessian.evaluate();
 
-        if (!jointsLinVelDone) {
-            if (jointsLinVel.wait_for(1us) == std::future_status::ready) {
-                hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->baseLinearVelocityRange.offset,
-                                 m_pimpl->jointsPositionRange.size, 3) = jointsLinVel.get();
-                jointsLinVelDone = true;
-            }
-        }
+    hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->baseLinearVelocityRange.offset,
+                     m_pimpl->jointsPositionRange.size, 3) = m_pimpl->jointsLinVelHessian.evaluate();
 
-        if (!jointsQuatVelDone) {
-            if (jointsQuatVel.wait_for(1us) == std::future_status::ready) {
-                hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->baseQuaternionDerivativeRange.offset,
-                                 m_pimpl->jointsPositionRange.size, 4) = jointsQuatVel.get();
-                jointsQuatVelDone = true;
-            }
-        }
+    hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->baseQuaternionDerivativeRange.offset,
+                     m_pimpl->jointsPositionRange.size, 4) = m_pimpl->jointsQuatVelHessian.evaluate();
 
-        if (!jointsJointsVelDone) {
-            if (jointsJointsVel.wait_for(1us) == std::future_status::ready) {
-                hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->jointsVelocityRange.offset,
-                                 m_pimpl->jointsPositionRange.size, m_pimpl->jointsVelocityRange.size) = jointsJointsVel.get();
-                jointsJointsVelDone = true;
-            }
-        }
-    }
+    hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->jointsVelocityRange.offset,
+                     m_pimpl->jointsPositionRange.size, m_pimpl->jointsVelocityRange.size) = m_pimpl->jointsJointsVelHessian.evaluate();
 
     return true;
 }
@@ -81,13 +81,12 @@ ClassicalComplementarityConstraint::ClassicalComplementarityConstraint(const Var
 ClassicalComplementarityConstraint::~ClassicalComplementarityConstraint()
 { }
 
-bool ClassicalComplementarityConstraint::evaluateConstraint(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::VectorDynSize &constraint)
+bool ClassicalComplementarityConstraint::evaluateConstraint(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &/*control*/, iDynTree::VectorDynSize &constraint)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
 
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
-    m_pimpl->pointForce = m_pimpl->stateVariables(m_pimpl->forcePointRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointForce = stateVariables(m_pimpl->forcePointRange);
 
 
     m_pimpl->constraintValues(0) = m_pimpl->pointPosition(2) * m_pimpl->pointForce(2);
@@ -97,13 +96,12 @@ bool ClassicalComplementarityConstraint::evaluateConstraint(double, const iDynTr
     return true;
 }
 
-bool ClassicalComplementarityConstraint::constraintJacobianWRTState(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::MatrixDynSize &jacobian)
+bool ClassicalComplementarityConstraint::constraintJacobianWRTState(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &/*control*/, iDynTree::MatrixDynSize &jacobian)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
 
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
-    m_pimpl->pointForce = m_pimpl->stateVariables(m_pimpl->forcePointRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointForce = stateVariables(m_pimpl->forcePointRange);
 
     unsigned int fzIndex = static_cast<unsigned int>(m_pimpl->forcePointRange.offset + 2);
     unsigned int pzIndex = static_cast<unsigned int>(m_pimpl->positionPointRange.offset + 2);
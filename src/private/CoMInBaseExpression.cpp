@@ -271,7 +271,7 @@ public:
         bool ok = kinDyn->getCenterOfMassJacobian(m_expressionsServer->currentState(), m_jacobian);
         assert(ok);
 
-        m_evaluationBuffer = iDynTree::toEigen(baseRotation.inverse()) * iDynTree::toEigen(m_jacobian).rightCols(m_expressionsServer->currentState().s.size());
+        m_evaluationBuffer.noalias() = iDynTree::toEigen(baseRotation.inverse()) * iDynTree::toEigen(m_jacobian).rightCols(m_expressionsServer->currentState().s.size());
 
         return m_evaluationBuffer;
     }
@@ -8,7 +8,6 @@
 #include <levi/levi.h>
 #include <DynamicalPlannerPrivate/Constraints/CoMPositionConstraint.h>
 #include <DynamicalPlannerPrivate/Utilities/QuaternionUtils.h>
-#include <DynamicalPlannerPrivate/Utilities/CheckEqualVector.h>
 #include <iDynTree/Core/EigenHelpers.h>
 #include <iDynTree/Core/VectorFixSize.h>
 #include <iDynTree/Core/Transform.h>
@@ -25,7 +24,7 @@ public:
     VariablesLabeller stateVariables;
     VariablesLabeller controlVariables;
     iDynTree::IndexRange comPositionRange, jointsPositionRange, basePositionRange, baseQuaternionRange;
-    iDynTree::VectorDynSize constraintValueBuffer;
+    iDynTree::VectorDynSize constraintValueBuffer; //CoM position from the robot state, the CoM variable is subtracted at every call
     iDynTree::Position basePosition;
     iDynTree::Vector3 comPosition;
     iDynTree::Vector4 baseQuaternion, baseQuaternionNormalized;
@@ -38,9 +37,8 @@ public:
     std::shared_ptr<TimelySharedKinDynComputations> timedSharedKinDyn;
     std::shared_ptr<ExpressionsServer> expressionsServer;
 
-    bool updateDoneOnceConstraint = false;
-    bool updateDoneOnceStateJacobian = false;
-    double tolerance;
+    uint64_t constraintVersion = 0; //versions of the robot state used to compute the cached values
+    uint64_t stateJacobianVersion = 0;
 
     iDynTree::optimalcontrol::SparsityStructure stateJacobianSparsity, controlJacobianSparsity;
     iDynTree::optimalcontrol::SparsityStructure stateHessianSparsity, controlHessianSparsity, mixedHessianSparsity;
@@ -72,12 +70,10 @@ public:
         comPosition = stateVariables(comPositionRange);
     }
 
-    bool sameVariables(bool updateDoneOnce) {
-        bool same = updateDoneOnce;
-        same = same && VectorsAreEqual(comPosition, stateVariables(comPositionRange), tolerance);
-        same = same && VectorsAreEqual(basePosition, stateVariables(basePositionRange), tolerance);
-        same = same && VectorsAreEqual(baseQuaternion, stateVariables(baseQuaternionRange), tolerance);
-        same = same && VectorsAreEqual(robotState.s, stateVariables(jointsPositionRange), tolerance);
+    bool sameVariables(uint64_t& lastVersion) { //Updates the robot state. True if its version is the one used to compute the cached values.
+        updateRobotState();
+        bool same = (robotState.version.value() != 0) && (robotState.version.value() == lastVersion);
+        lastVersion = robotState.version.value();
         return same;
     }
 
@@ -143,7 +139,6 @@ CoMPositionConstraint::CoMPositionConstraint(const VariablesLabeller &stateVaria
     m_pimpl->controlJacobianBuffer.resize(3, static_cast<unsigned int>(controlVariables.size()));
     m_pimpl->controlJacobianBuffer.zero();
 
-    m_pimpl->tolerance = timelySharedKinDyn->getUpdateTolerance();
 
     m_pimpl->setSparsity();
 
@@ -172,15 +167,12 @@ bool CoMPositionConstraint::evaluateConstraint(double time, const iDynTree::Vect
     m_pimpl->stateVariables = state;
     m_pimpl->sharedKinDyn = m_pimpl->timedSharedKinDyn->get(time);
 
-    if (!(m_pimpl->sameVariables(m_pimpl->updateDoneOnceConstraint))) {
-
-//        m_pimpl->updateDoneOnceConstraint = true;
-        m_pimpl->updateVariables();
+    if (!(m_pimpl->sameVariables(m_pimpl->constraintVersion))) {
 
-        iDynTree::toEigen(m_pimpl->constraintValueBuffer) = iDynTree::toEigen(m_pimpl->sharedKinDyn->getCenterOfMassPosition(m_pimpl->robotState)) - iDynTree::toEigen(m_pimpl->stateVariables(m_pimpl->comPositionRange));
+        iDynTree::toEigen(m_pimpl->constraintValueBuffer) = iDynTree::toEigen(m_pimpl->sharedKinDyn->getCenterOfMassPosition(m_pimpl->robotState));
 
     }
-    constraint = m_pimpl->constraintValueBuffer;
+    iDynTree::toEigen(constraint) = iDynTree::toEigen(m_pimpl->constraintValueBuffer) - iDynTree::toEigen(m_pimpl->stateVariables(m_pimpl->comPositionRange));
 
     return true;
 
@@ -191,10 +183,7 @@ bool CoMPositionConstraint::constraintJacobianWRTState(double time, const iDynTr
     m_pimpl->stateVariables = state;
     m_pimpl->sharedKinDyn = m_pimpl->timedSharedKinDyn->get(time);
 
-    if (!(m_pimpl->sameVariables(m_pimpl->updateDoneOnceStateJacobian))) {
-
-//        m_pimpl->updateDoneOnceStateJacobian = true;
-        m_pimpl->updateVariables();
+    if (!(m_pimpl->sameVariables(m_pimpl->stateJacobianVersion))) {
 
         bool ok = m_pimpl->sharedKinDyn->getCenterOfMassJacobian(m_pimpl->robotState, m_pimpl->comJacobianBuffer, iDynTree::FrameVelocityRepresentation::MIXED_REPRESENTATION);
         assert(ok);
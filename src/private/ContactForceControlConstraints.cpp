@@ -96,12 +96,12 @@ ContactForceControlConstraints::~ContactForceControlConstraints()
 
 bool ContactForceControlConstraints::evaluateConstraint(double /*time*/, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::VectorDynSize &constraint)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
+    VariablesLabeller::ScopedWrap controlVariables(m_pimpl->controlVariables, control);
 
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
-    m_pimpl->pointForce = m_pimpl->stateVariables(m_pimpl->forcePointRange);
-    m_pimpl->pointForceControl = m_pimpl->controlVariables(m_pimpl->forceControlRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointForce = stateVariables(m_pimpl->forcePointRange);
+    m_pimpl->pointForceControl = controlVariables(m_pimpl->forceControlRange);
     double delta = m_pimpl->activation.eval(m_pimpl->pointPosition(2));
     double fz = m_pimpl->pointForce(2);
     double uz = m_pimpl->pointForceControl(2);
@@ -115,12 +115,12 @@ bool ContactForceControlConstraints::evaluateConstraint(double /*time*/, const i
 
 bool ContactForceControlConstraints::constraintJacobianWRTState(double /*time*/, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::MatrixDynSize &jacobian)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
+    VariablesLabeller::ScopedWrap controlVariables(m_pimpl->controlVariables, control);
 
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
-    m_pimpl->pointForce = m_pimpl->stateVariables(m_pimpl->forcePointRange);
-    m_pimpl->pointForceControl = m_pimpl->controlVariables(m_pimpl->forceControlRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointForce = stateVariables(m_pimpl->forcePointRange);
+    m_pimpl->pointForceControl = controlVariables(m_pimpl->forceControlRange);
 
     double delta = m_pimpl->activation.eval(m_pimpl->pointPosition(2));
     double deltaDerivative = m_pimpl->activation.evalDerivative(m_pimpl->pointPosition(2));
@@ -137,11 +137,8 @@ bool ContactForceControlConstraints::constraintJacobianWRTState(double /*time*/,
     return true;
 }
 
-bool ContactForceControlConstraints::constraintJacobianWRTControl(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::MatrixDynSize &jacobian)
+bool ContactForceControlConstraints::constraintJacobianWRTControl(double, const iDynTree::VectorDynSize &/*state*/, const iDynTree::VectorDynSize &/*control*/, iDynTree::MatrixDynSize &jacobian)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
-
     m_pimpl->controlJacobianBuffer(0, static_cast<unsigned int>(m_pimpl->forceControlRange.offset + 2)) = 1;
 
     jacobian = m_pimpl->controlJacobianBuffer;
@@ -175,10 +172,10 @@ bool ContactForceControlConstraints::constraintSecondPartialDerivativeWRTState(d
                                                                                const iDynTree::VectorDynSize &lambda,
                                                                                iDynTree::MatrixDynSize &hessian)
 {
-    m_pimpl->stateVariables = state;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
 
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
-    m_pimpl->pointForce = m_pimpl->stateVariables(m_pimpl->forcePointRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointForce = stateVariables(m_pimpl->forcePointRange);
 
     double fz = m_pimpl->pointForce(2);
 
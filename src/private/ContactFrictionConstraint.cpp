@@ -29,7 +29,7 @@ public:
 
 
 ContactFrictionConstraint::ContactFrictionConstraint(const VariablesLabeller &stateVariables, const VariablesLabeller &controlVariables,
-                                                     const std::string &footName, size_t contactIndex)
+                                                     const FootRanges &footRanges, const std::string &footName, size_t contactIndex)
     : iDynTree::optimalcontrol::Constraint (1, "ContactFriction" + footName + std::to_string(contactIndex))
     , m_pimpl(std::make_unique<Implementation>())
 {
@@ -39,7 +39,8 @@ ContactFrictionConstraint::ContactFrictionConstraint(const VariablesLabeller &st
     m_pimpl->footName = footName;
     m_pimpl->contactIndex = contactIndex;
 
-    m_pimpl->forcePointRange = stateVariables.getIndexRange(footName + "ForcePoint" + std::to_string(contactIndex));
+    assert(contactIndex < footRanges.forcePoints.size());
+    m_pimpl->forcePointRange = footRanges.forcePoints[contactIndex];
     assert(m_pimpl->forcePointRange.isValid());
 
     m_pimpl->frictionCoefficient = 0.3;
@@ -74,9 +75,9 @@ bool ContactFrictionConstraint::setFrictionCoefficient(double frictionCoefficien
 
 bool ContactFrictionConstraint::evaluateConstraint(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &, iDynTree::VectorDynSize &constraint)
 {
-    m_pimpl->stateVariables = state;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
 
-    m_pimpl->pointForce = m_pimpl->stateVariables(m_pimpl->forcePointRange);
+    m_pimpl->pointForce = stateVariables(m_pimpl->forcePointRange);
 
     constraint(0) = m_pimpl->pointForce(0) * m_pimpl->pointForce(0) + m_pimpl->pointForce(1) * m_pimpl->pointForce(1) -
             m_pimpl->frictionCoefficient * m_pimpl->frictionCoefficient * m_pimpl->pointForce(2) * m_pimpl->pointForce(2);
@@ -87,9 +88,9 @@ bool ContactFrictionConstraint::evaluateConstraint(double, const iDynTree::Vecto
 
 bool ContactFrictionConstraint::constraintJacobianWRTState(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &, iDynTree::MatrixDynSize &jacobian)
 {
-    m_pimpl->stateVariables = state;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
 
-    m_pimpl->pointForce = m_pimpl->stateVariables(m_pimpl->forcePointRange);
+    m_pimpl->pointForce = stateVariables(m_pimpl->forcePointRange);
 
     unsigned int col = static_cast<unsigned int>(m_pimpl->forcePointRange.offset);
 
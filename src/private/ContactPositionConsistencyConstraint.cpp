@@ -6,7 +6,6 @@
  */
 #include <levi/levi.h>
 #include <DynamicalPlannerPrivate/Constraints/ContactPositionConsistencyConstraint.h>
-#include <DynamicalPlannerPrivate/Utilities/CheckEqualVector.h>
 #include <iDynTree/Core/EigenHelpers.h>
 #include <DynamicalPlannerPrivate/Utilities/QuaternionUtils.h>
 #include <cassert>
@@ -26,7 +25,7 @@ public:
     iDynTree::IndexRange positionPointRange;
     iDynTree::IndexRange jointsPositionRange, basePositionRange, baseQuaternionRange;
 
-    iDynTree::VectorDynSize constraintValueBuffer;
+    iDynTree::VectorDynSize constraintValueBuffer; //point position from the robot state, the point variable is subtracted at every call
     iDynTree::Vector4 baseQuaternion, baseQuaternionNormalized;
     iDynTree::Position pointPosition;
     iDynTree::MatrixDynSize footJacobianBuffer, pointJacobianBuffer, stateJacobianBuffer, controlJacobianBuffer;
@@ -41,15 +40,16 @@ public:
     std::shared_ptr<TimelySharedKinDynComputations> timedSharedKinDyn;
     std::shared_ptr<ExpressionsServer> expressionsServer;
 
-    bool updateDoneOnceConstraint = false;
-    bool updateDoneOnceStateJacobian = false;
-    double tolerance;
+    uint64_t constraintVersion = 0; //versions of the robot state used to compute the cached values
+    uint64_t stateJacobianVersion = 0;
 
     iDynTree::optimalcontrol::SparsityStructure stateJacobianSparsity, controlJacobianSparsity;
     iDynTree::optimalcontrol::SparsityStructure stateHessianSparsity, controlHessianSparsity, mixedHessianSparsity;
 
     levi::Expression asExpression, quaternionDerivative, jointsDerivative;
     std::vector<levi::Expression> quaternionQuaternionDerivatives, quaternionJointsDerivatives, jointsJointsDerivatives;
+    bool hessianExpressionsBuilt = false;
+    std::vector<size_t> chainJoints; //the derivatives with respect to the other joints are zero
     iDynTree::VectorDynSize jointsHessianBuffer;
 
     void getRanges() {
@@ -89,13 +89,10 @@ public:
         iDynTree::toEigen(pointPosition) = iDynTree::toEigen(stateVariables(positionPointRange));
     }
 
-    bool sameVariables(bool updateDoneOnce) {
-        bool same = updateDoneOnce;
-        same = same && VectorsAreEqual(pointPosition, stateVariables(positionPointRange), tolerance);
-        same = same && VectorsAreEqual(basePosition, stateVariables(basePositionRange), tolerance);
-        same = same && VectorsAreEqual(baseQuaternion, stateVariables(baseQuaternionRange), tolerance);
-        same = same && VectorsAreEqual(robotState.s, stateVariables(jointsPositionRange), tolerance);
-
+    bool sameVariables(uint64_t& lastVersion) { //Updates the robot state. True if its version is the one used to compute the cached values.
+        updateRobotState();
+        bool same = (robotState.version.value() != 0) && (robotState.version.value() == lastVersion);
+        lastVersion = robotState.version.value();
         return same;
     }
 
@@ -109,18 +106,44 @@ public:
 
         stateJacobianSparsity.addIdentityBlock(0, static_cast<size_t>(basePositionRange.offset), 3);
         stateJacobianSparsity.addDenseBlock(fullRange, baseQuaternionRange);
-        stateJacobianSparsity.addDenseBlock(fullRange, jointsPositionRange);
         stateJacobianSparsity.addIdentityBlock(0, static_cast<size_t>(positionPointRange.offset), 3);
 
         stateHessianSparsity.addDenseBlock(baseQuaternionRange, baseQuaternionRange);
-        stateHessianSparsity.addDenseBlock(baseQuaternionRange, jointsPositionRange);
-        stateHessianSparsity.addDenseBlock(jointsPositionRange, baseQuaternionRange);
-        stateHessianSparsity.addDenseBlock(jointsPositionRange, jointsPositionRange);
+
+        size_t quaternionOffset = static_cast<size_t>(baseQuaternionRange.offset);
+        size_t jointsOffset = static_cast<size_t>(jointsPositionRange.offset);
+        for (size_t joint : chainJoints) {
+            stateJacobianSparsity.addDenseBlock(0, jointsOffset + joint, 3, 1);
+            stateHessianSparsity.addDenseBlock(quaternionOffset, jointsOffset + joint, 4, 1);
+            stateHessianSparsity.addDenseBlock(jointsOffset + joint, quaternionOffset, 1, 4);
+            for (size_t otherJoint : chainJoints) {
+                stateHessianSparsity.addDenseBlock(jointsOffset + joint, jointsOffset + otherJoint, 1, 1);
+            }
+        }
         controlHessianSparsity.clear();
         mixedHessianSparsity.clear();
 
     }
 
+    void buildHessianExpressions() { //The second derivatives are built only when first needed
+        if (hessianExpressionsBuilt) {
+            return;
+        }
+
+        for (Eigen::Index i = 0; i < 4; ++i) {
+
+            quaternionQuaternionDerivatives.push_back(quaternionDerivative.getColumnDerivative(i, (expressionsServer->baseQuaternion())));
+            quaternionJointsDerivatives.push_back(quaternionDerivative.getColumnDerivative(i, (expressionsServer->jointsPosition())));
+
+        }
+
+        for (size_t joint : chainJoints) {
+            jointsJointsDerivatives.push_back(jointsDerivative.getColumnDerivative(static_cast<Eigen::Index>(joint), (expressionsServer->jointsPosition())));
+        }
+
+        hessianExpressionsBuilt = true;
+    }
+
     void clearDerivativesCache(std::vector<levi::Expression>& vector) {
         for (auto& expr : vector) {
             expr.clearDerivativesCache();
@@ -172,7 +195,6 @@ ContactPositionConsistencyConstraint::ContactPositionConsistencyConstraint(const
     m_pimpl->controlJacobianBuffer.resize(3, static_cast<unsigned int>(controlVariables.size()));
     m_pimpl->controlJacobianBuffer.zero();
 
-    m_pimpl->tolerance = timelySharedKinDyn->getUpdateTolerance();
 
     iDynTree::toEigen(m_pimpl->footTransformationBuffer).leftCols<3>().setIdentity();
 
@@ -182,9 +204,11 @@ ContactPositionConsistencyConstraint::ContactPositionConsistencyConstraint(const
     m_upperBound.zero();
     m_lowerBound.zero();
 
+    m_pimpl->expressionsServer = expressionsServer;
+    m_pimpl->chainJoints = expressionsServer->chainJoints(expressionsServer->model().getFrameIndex(timelySharedKinDyn->getFloatingBase()), footFrame);
+
     m_pimpl->setSparsity();
 
-    m_pimpl->expressionsServer = expressionsServer;
     m_pimpl->jointsHessianBuffer.resize(static_cast<unsigned int>(m_pimpl->jointsPositionRange.size));
 
     levi::Constant positionInFootExpr(iDynTree::toEigen(positionInFoot), footName + "_p_" + std::to_string(contactIndex));
@@ -196,17 +220,6 @@ ContactPositionConsistencyConstraint::ContactPositionConsistencyConstraint(const
     m_pimpl->quaternionDerivative = m_pimpl->asExpression.getColumnDerivative(0, (m_pimpl->expressionsServer->baseQuaternion()));
     m_pimpl->jointsDerivative = m_pimpl->asExpression.getColumnDerivative(0, (m_pimpl->expressionsServer->jointsPosition()));
 
-    for (Eigen::Index i = 0; i < 4; ++i) {
-
-        m_pimpl->quaternionQuaternionDerivatives.push_back(m_pimpl->quaternionDerivative.getColumnDerivative(i, (m_pimpl->expressionsServer->baseQuaternion())));
-        m_pimpl->quaternionJointsDerivatives.push_back(m_pimpl->quaternionDerivative.getColumnDerivative(i, (m_pimpl->expressionsServer->jointsPosition())));
-
-    }
-
-    for (Eigen::Index i = 0; i < m_pimpl->jointsPositionRange.size; ++i) {
-        m_pimpl->jointsJointsDerivatives.push_back(m_pimpl->jointsDerivative.getColumnDerivative(i, (m_pimpl->expressionsServer->jointsPosition())));
-    }
-
 }
 
 ContactPositionConsistencyConstraint::~ContactPositionConsistencyConstraint()
@@ -225,16 +238,12 @@ bool ContactPositionConsistencyConstraint::evaluateConstraint(double time, const
     m_pimpl->stateVariables = state;
     m_pimpl->sharedKinDyn = m_pimpl->timedSharedKinDyn->get(time);
 
-    if (!(m_pimpl->sameVariables(m_pimpl->updateDoneOnceConstraint))) {
+    if (!(m_pimpl->sameVariables(m_pimpl->constraintVersion))) {
 
-//        m_pimpl->updateDoneOnceConstraint = true;
-        m_pimpl->updateVariables();
-
-        iDynTree::toEigen(m_pimpl->constraintValueBuffer) = iDynTree::toEigen(m_pimpl->sharedKinDyn->getWorldTransform(m_pimpl->robotState, m_pimpl->footFrame) * m_pimpl->positionInFoot
-                - m_pimpl->pointPosition);
+        iDynTree::toEigen(m_pimpl->constraintValueBuffer) = iDynTree::toEigen(m_pimpl->sharedKinDyn->getWorldTransform(m_pimpl->robotState, m_pimpl->footFrame) * m_pimpl->positionInFoot);
     }
 
-    constraint = m_pimpl->constraintValueBuffer;
+    iDynTree::toEigen(constraint) = iDynTree::toEigen(m_pimpl->constraintValueBuffer) - iDynTree::toEigen(m_pimpl->stateVariables(m_pimpl->positionPointRange));
 
     return true;
 }
@@ -244,10 +253,8 @@ bool ContactPositionConsistencyConstraint::constraintJacobianWRTState(double tim
     m_pimpl->stateVariables = state;
     m_pimpl->sharedKinDyn = m_pimpl->timedSharedKinDyn->get(time);
 
-    if (!(m_pimpl->sameVariables(m_pimpl->updateDoneOnceStateJacobian))) {
+    if (!(m_pimpl->sameVariables(m_pimpl->stateJacobianVersion))) {
 
-//        m_pimpl->updateDoneOnceStateJacobian = true;
-        m_pimpl->updateVariables();
         m_pimpl->expressionsServer->updateRobotState(time);
 
         bool ok = m_pimpl->sharedKinDyn->getFrameFreeFloatingJacobian(m_pimpl->robotState, m_pimpl->footFrame, m_pimpl->footJacobianBuffer, iDynTree::FrameVelocityRepresentation::MIXED_REPRESENTATION);
@@ -339,6 +346,13 @@ bool ContactPositionConsistencyConstraint::constraintSecondPartialDerivativeWRTS
                                                                                      const iDynTree::VectorDynSize &lambda,
                                                                                      iDynTree::MatrixDynSize &hessian)
 {
+    if (!m_pimpl->expressionsServer->hessiansEnabled()) {
+        std::cerr << "[ERROR][ContactPositionConsistencyConstraint::constraintSecondPartialDerivativeWRTState] The Hessians have been disabled." << std::endl;
+        return false;
+    }
+
+    m_pimpl->buildHessianExpressions();
+
     m_pimpl->stateVariables = state;
     m_pimpl->controlVariables = control;
 
@@ -371,12 +385,12 @@ bool ContactPositionConsistencyConstraint::constraintSecondPartialDerivativeWRTS
             jointsMap;
     }
 
-    for (Eigen::Index i = 0; i < m_pimpl->jointsPositionRange.size; ++i) {
-        jointsMap = (m_pimpl->jointsJointsDerivatives[static_cast<size_t>(i)].evaluate()).transpose() *
+    for (size_t i = 0; i < m_pimpl->chainJoints.size(); ++i) {
+        jointsMap = (m_pimpl->jointsJointsDerivatives[i].evaluate()).transpose() *
             lambdaMap;
 
-        hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->jointsPositionRange.offset + i, m_pimpl->jointsPositionRange.size, 1) =
-            jointsMap;
+        hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->jointsPositionRange.offset + static_cast<Eigen::Index>(m_pimpl->chainJoints[i]),
+                         m_pimpl->jointsPositionRange.size, 1) = jointsMap;
     }
 
     return true;
@@ -99,13 +99,13 @@ DynamicalComplementarityConstraint::~DynamicalComplementarityConstraint()
 
 bool DynamicalComplementarityConstraint::evaluateConstraint(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::VectorDynSize &constraint)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
+    VariablesLabeller::ScopedWrap controlVariables(m_pimpl->controlVariables, control);
 
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
-    m_pimpl->pointForce = m_pimpl->stateVariables(m_pimpl->forcePointRange);
-    m_pimpl->pointVelocityControl = m_pimpl->controlVariables(m_pimpl->velocityControlRange);
-    m_pimpl->pointForceControl = m_pimpl->controlVariables(m_pimpl->forceControlRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointForce = stateVariables(m_pimpl->forcePointRange);
+    m_pimpl->pointVelocityControl = controlVariables(m_pimpl->velocityControlRange);
+    m_pimpl->pointForceControl = controlVariables(m_pimpl->forceControlRange);
 
     m_pimpl->constraintValues(0) = m_pimpl->pointForceControl(2) * m_pimpl->pointPosition(2) + m_pimpl->pointForce(2) * m_pimpl->pointVelocityControl(2)
             + m_pimpl->dissipationGain * m_pimpl->pointPosition(2) * m_pimpl->pointForce(2);
@@ -117,13 +117,13 @@ bool DynamicalComplementarityConstraint::evaluateConstraint(double, const iDynTr
 
 bool DynamicalComplementarityConstraint::constraintJacobianWRTState(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::MatrixDynSize &jacobian)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
+    VariablesLabeller::ScopedWrap controlVariables(m_pimpl->controlVariables, control);
 
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
-    m_pimpl->pointForce = m_pimpl->stateVariables(m_pimpl->forcePointRange);
-    m_pimpl->pointVelocityControl = m_pimpl->controlVariables(m_pimpl->velocityControlRange);
-    m_pimpl->pointForceControl = m_pimpl->controlVariables(m_pimpl->forceControlRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointForce = stateVariables(m_pimpl->forcePointRange);
+    m_pimpl->pointVelocityControl = controlVariables(m_pimpl->velocityControlRange);
+    m_pimpl->pointForceControl = controlVariables(m_pimpl->forceControlRange);
 
     unsigned int fzIndex = static_cast<unsigned int>(m_pimpl->forcePointRange.offset + 2);
     unsigned int pzIndex = static_cast<unsigned int>(m_pimpl->positionPointRange.offset + 2);
@@ -137,13 +137,13 @@ bool DynamicalComplementarityConstraint::constraintJacobianWRTState(double, cons
 
 bool DynamicalComplementarityConstraint::constraintJacobianWRTControl(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::MatrixDynSize &jacobian)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
+    VariablesLabeller::ScopedWrap controlVariables(m_pimpl->controlVariables, control);
 
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
-    m_pimpl->pointForce = m_pimpl->stateVariables(m_pimpl->forcePointRange);
-    m_pimpl->pointVelocityControl = m_pimpl->controlVariables(m_pimpl->velocityControlRange);
-    m_pimpl->pointForceControl = m_pimpl->controlVariables(m_pimpl->forceControlRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointForce = stateVariables(m_pimpl->forcePointRange);
+    m_pimpl->pointVelocityControl = controlVariables(m_pimpl->velocityControlRange);
+    m_pimpl->pointForceControl = controlVariables(m_pimpl->forceControlRange);
 
     unsigned int fzDotIndex = static_cast<unsigned int>(m_pimpl->forceControlRange.offset + 2);
     unsigned int vzIndex = static_cast<unsigned int>(m_pimpl->velocityControlRange.offset + 2);
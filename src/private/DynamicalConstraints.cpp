@@ -8,6 +8,7 @@
 #include <levi/levi.h>
 #include <DynamicalPlannerPrivate/Constraints/DynamicalConstraints.h>
 #include <DynamicalPlannerPrivate/Utilities/QuaternionUtils.h>
+#include <DynamicalPlannerPrivate/Utilities/VariablesLayout.h>
 #include <iDynTree/Core/EigenHelpers.h>
 #include <iDynTree/Core/Utils.h>
 #include <cassert>
@@ -36,6 +37,7 @@ public:
     std::shared_ptr<SharedKinDynComputations> sharedKinDyn;
     std::shared_ptr<TimelySharedKinDynComputations> timedSharedKinDyn;
     std::shared_ptr<ExpressionsServer> expressionServer;
+    std::shared_ptr<const SolverInterruption> interruption;
 
     HyperbolicTangent activationXY;
     HyperbolicSecant normalForceActivation;
@@ -44,10 +46,8 @@ public:
     levi::Expression skewForce;
     levi::Expression basePositionDerivative, basePositionDerivativeJacobian;
     std::vector<levi::Expression> basePositionDerivativeHessian;
+    bool hessianExpressionsBuilt = false;
 
-    typedef struct {
-        std::vector<iDynTree::IndexRange> positionPoints, forcePoints, velocityControlPoints, forceControlPoints;
-    } FootRanges;
     FootRanges leftRanges, rightRanges;
     iDynTree::IndexRange momentumRange, comPositionRange, basePositionRange, baseQuaternionRange, jointsPositionRange, jointsVelocityRange;
 //    iDynTree::IndexRange baseVelocityRange;
@@ -57,46 +57,6 @@ public:
     iDynTree::optimalcontrol::SparsityStructure stateJacobianSparsity, controlJacobianSparsity;
     iDynTree::optimalcontrol::SparsityStructure stateHessianSparsity, controlHessianSparsity, mixedHessianSparsity;
 
-    void checkFootVariables(const std::string& footName, size_t numberOfPoints, FootRanges& foot) {
-        foot.positionPoints.resize(numberOfPoints);
-        foot.forcePoints.resize(numberOfPoints);
-        foot.velocityControlPoints.resize(numberOfPoints);
-        foot.forceControlPoints.resize(numberOfPoints);
-
-        iDynTree::IndexRange obtainedRange;
-        for (size_t i= 0; i < numberOfPoints; ++i) {
-            obtainedRange = stateVariables.getIndexRange(footName + "ForcePoint" + std::to_string(i));
-
-            if (!obtainedRange.isValid()){
-                std::cerr << "[ERROR][DynamicalConstraints::DynamicalConstraints] Variable " << footName + "ForcePoint" + std::to_string(i) << " not available among state variables." << std::endl;
-                assert(false);
-            }
-            foot.forcePoints[i] = obtainedRange;
-
-            obtainedRange = stateVariables.getIndexRange(footName + "PositionPoint" + std::to_string(i));
-            if (!obtainedRange.isValid()){
-                std::cerr << "[ERROR][DynamicalConstraints::DynamicalConstraints] Variable " << footName + "PositionPoint" + std::to_string(i) << " not available among state variables." << std::endl;
-                assert(false);
-            }
-            foot.positionPoints[i] = obtainedRange;
-
-            obtainedRange = controlVariables.getIndexRange(footName + "ForceControlPoint" + std::to_string(i));
-            if (!obtainedRange.isValid()){
-                std::cerr << "[ERROR][DynamicalConstraints::DynamicalConstraints] Variable " << footName + "ForceControlPoint" + std::to_string(i) << " not available among control variables." << std::endl;
-                assert(false);
-            }
-            foot.forceControlPoints[i] = obtainedRange;
-
-            obtainedRange = controlVariables.getIndexRange(footName + "VelocityControlPoint" + std::to_string(i));
-            if (!obtainedRange.isValid()){
-                std::cerr << "[ERROR][DynamicalConstraints::DynamicalConstraints] Variable " << footName + "VelocityControlPoint" + std::to_string(i) << " not available among control variables." << std::endl;
-                assert(false);
-            }
-            foot.velocityControlPoints[i] = obtainedRange;
-        }
-    }
-
-
     void computeFootRelatedDynamics(FootRanges& foot) {
         Eigen::Vector3d distance, appliedForce;
 
@@ -225,6 +185,18 @@ public:
         }
     }
 
+    void buildHessianExpressions() { //The second derivatives are built only when first needed
+        if (hessianExpressionsBuilt) {
+            return;
+        }
+
+        for (long i = 0; i < 4; ++i) {
+            basePositionDerivativeHessian.push_back(basePositionDerivativeJacobian.getColumnDerivative(i, expressionServer->baseQuaternion()));
+        }
+
+        hessianExpressionsBuilt = true;
+    }
+
     void updateRobotState() {
 
         robotState = sharedKinDyn->currentState();
@@ -321,7 +293,7 @@ public:
 
 
 DynamicalConstraints::DynamicalConstraints(const VariablesLabeller &stateVariables, const VariablesLabeller &controlVariables,
-                                           std::shared_ptr<TimelySharedKinDynComputations> timelySharedKinDyn,
+                                           const VariablesRanges &ranges, std::shared_ptr<TimelySharedKinDynComputations> timelySharedKinDyn,
                                            std::shared_ptr<ExpressionsServer> expressionsServer, const HyperbolicTangent& planarVelocityActivation,
                                            const HyperbolicSecant &normalForceActivation,  double forceDissipationRatio)
    : iDynTree::optimalcontrol::DynamicalSystem (stateVariables.size(), controlVariables.size())
@@ -361,46 +333,16 @@ DynamicalConstraints::DynamicalConstraints(const VariablesLabeller &stateVariabl
     m_pimpl->activationXY = planarVelocityActivation;
     m_pimpl->normalForceDissipation = forceDissipationRatio;
 
-    size_t leftPoints = 0, rightPoints = 0;
-    for (auto& label : stateVariables.listOfLabels()) {
-        if (label.find("LeftForcePoint") != std::string::npos) {
-            leftPoints++;
-        }
-
-        if (label.find("RightForcePoint") != std::string::npos) {
-             rightPoints++;
-        }
-    }
-
-    m_pimpl->checkFootVariables("Left",leftPoints, m_pimpl->leftRanges);
-    m_pimpl->checkFootVariables("Right", rightPoints, m_pimpl->rightRanges);
-
-    m_pimpl->momentumRange = m_pimpl->stateVariables.getIndexRange("Momentum");
-    assert(m_pimpl->momentumRange.isValid());
-
-    m_pimpl->comPositionRange = m_pimpl->stateVariables.getIndexRange("CoMPosition");
-    assert(m_pimpl->comPositionRange.isValid());
-
-    m_pimpl->basePositionRange = m_pimpl->stateVariables.getIndexRange("BasePosition");
-    assert(m_pimpl->basePositionRange.isValid());
-
-    m_pimpl->baseQuaternionRange = m_pimpl->stateVariables.getIndexRange("BaseQuaternion");
-    assert(m_pimpl->baseQuaternionRange.isValid());
-
-    m_pimpl->jointsPositionRange = m_pimpl->stateVariables.getIndexRange("JointsPosition");
-    assert(m_pimpl->jointsPositionRange.isValid());
-
-//    m_pimpl->baseVelocityRange = m_pimpl->controlVariables.getIndexRange("BaseVelocity");
-//    assert(m_pimpl->baseVelocityRange.isValid());
-
-    m_pimpl->baseLinearVelocityRange = m_pimpl->controlVariables.getIndexRange("BaseLinearVelocity");
-    assert(m_pimpl->baseLinearVelocityRange.isValid());
-
-    m_pimpl->baseQuaternionDerivativeRange = m_pimpl->controlVariables.getIndexRange("BaseQuaternionDerivative");
-    assert(m_pimpl->baseQuaternionDerivativeRange.isValid());
-
-    m_pimpl->jointsVelocityRange = m_pimpl->controlVariables.getIndexRange("JointsVelocity");
-    assert(m_pimpl->jointsVelocityRange.isValid());
+    m_pimpl->leftRanges = ranges.left;
+    m_pimpl->rightRanges = ranges.right;
+    m_pimpl->momentumRange = ranges.momentum;
+    m_pimpl->comPositionRange = ranges.comPosition;
+    m_pimpl->basePositionRange = ranges.basePosition;
+    m_pimpl->baseQuaternionRange = ranges.baseQuaternion;
+    m_pimpl->jointsPositionRange = ranges.jointsPosition;
+    m_pimpl->baseLinearVelocityRange = ranges.baseLinearVelocity;
+    m_pimpl->baseQuaternionDerivativeRange = ranges.baseQuaternionDerivative;
+    m_pimpl->jointsVelocityRange = ranges.jointsVelocity;
 
     m_pimpl->comjacobianBuffer.resize(3, 6 + static_cast<unsigned int>(m_pimpl->jointsPositionRange.size));
     m_pimpl->comjacobianBuffer.zero();
@@ -413,11 +355,6 @@ DynamicalConstraints::DynamicalConstraints(const VariablesLabeller &stateVariabl
     m_pimpl->basePositionDerivative = (m_pimpl->expressionServer->baseRotation()) * (m_pimpl->expressionServer->baseLinearVelocity());
     m_pimpl->basePositionDerivativeJacobian = m_pimpl->basePositionDerivative.getColumnDerivative(0, m_pimpl->expressionServer->baseQuaternion());
 
-    for (long i = 0; i < 4; ++i) {
-        m_pimpl->basePositionDerivativeHessian.push_back(m_pimpl->basePositionDerivativeJacobian.getColumnDerivative(i, m_pimpl->expressionServer->baseQuaternion()));
-    }
-
-
 }
 
 DynamicalConstraints::~DynamicalConstraints()
@@ -457,8 +394,20 @@ bool DynamicalConstraints::dynamics(const iDynTree::VectorDynSize &state, double
     return true;
 }
 
+void DynamicalConstraints::setInterruption(std::shared_ptr<const SolverInterruption> interruption)
+{
+    m_pimpl->interruption = interruption;
+}
+
 bool DynamicalConstraints::dynamicsStateFirstDerivative(const iDynTree::VectorDynSize &state, double time, iDynTree::MatrixDynSize &dynamicsDerivative)
 {
+    if (m_pimpl->interruption && m_pimpl->interruption->isInterrupted()) {
+        //Called once per knot, not once per iteration. Ipopt treats the false return as an evaluation error and stops in the middle of the
+        //iteration. The Solver maps that failure to Cancelled or DeadlineReached by checking the interruption flags. The intermediate
+        //callback of Ipopt, which would stop at an iteration boundary, is not reachable through iDynTree::optimization::IpoptInterface.
+        return false;
+    }
+
     m_pimpl->stateVariables = state;
     m_pimpl->controlVariables = controlInput();
     m_pimpl->sharedKinDyn = m_pimpl->timedSharedKinDyn->get(time);
@@ -534,6 +483,13 @@ bool DynamicalConstraints::dynamicsControlFirstDerivativeSparsity(iDynTree::opti
 
 bool DynamicalConstraints::dynamicsSecondPartialDerivativeWRTState(double time, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &lambda, iDynTree::MatrixDynSize &partialDerivative)
 {
+    if (!m_pimpl->expressionServer->hessiansEnabled()) {
+        std::cerr << "[ERROR][DynamicalConstraints::dynamicsSecondPartialDerivativeWRTState] The Hessians have been disabled." << std::endl;
+        return false;
+    }
+
+    m_pimpl->buildHessianExpressions();
+
     m_pimpl->stateVariables = state;
     m_pimpl->controlVariables = controlInput();
     m_pimpl->lambda = lambda;
@@ -568,6 +524,11 @@ bool DynamicalConstraints::dynamicsSecondPartialDerivativeWRTControl(double /*ti
 
 bool DynamicalConstraints::dynamicsSecondPartialDerivativeWRTStateControl(double time, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &lambda, iDynTree::MatrixDynSize &partialDerivative)
 {
+    if (!m_pimpl->expressionServer->hessiansEnabled()) {
+        std::cerr << "[ERROR][DynamicalConstraints::dynamicsSecondPartialDerivativeWRTStateControl] The Hessians have been disabled." << std::endl;
+        return false;
+    }
+
     m_pimpl->stateVariables = state;
     m_pimpl->controlVariables = controlInput();
     m_pimpl->lambda = lambda;
@@ -19,17 +19,34 @@
 #include <DynamicalPlannerPrivate/Utilities/levi/MomentumInBaseExpression.h>
 #include <initializer_list>
 #include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/Model/Traversal.h>
+#include <algorithm>
 #include <cassert>
 #include <unordered_map>
+#include <vector>
+#include <functional>
 
 using namespace DynamicalPlanner::Private;
 
-using ExpressionMap = std::unordered_map<std::string, levi::Expression>;
-using TransformsMap = std::unordered_map<std::string, TransformExpression>;
+namespace {
+    VariablesStamp AddNameToStamp(VariablesStamp seed, const std::string& name) {
+        return MixStamp(seed, static_cast<uint64_t>(std::hash<std::string>()(name)));
+    }
+
+    template<typename MatrixType>
+    VariablesStamp AddMatrixToStamp(VariablesStamp seed, const MatrixType& matrix) {
+        return AddToStamp(seed, Eigen::Map<const Eigen::VectorXd>(matrix.data(), static_cast<Eigen::Index>(matrix.rows() * matrix.cols())));
+    }
+}
+
+//The expressions are indexed by integer keys built from the frames, links, joints and columns indices
+using ExpressionMap = std::unordered_map<size_t, levi::Expression>;
+using TransformsMap = std::unordered_map<size_t, TransformExpression>;
 
 class ExpressionsServer::Implementation {
 public:
     std::shared_ptr<TimelySharedKinDynComputations> timelySharedKinDyn;
+    TimelySharedKinDynComputations::Cursor timeCursor;
     SharedKinDynComputationsPointer kinDyn;
     levi::ScalarVariable time = levi::ScalarVariable("t");
     levi::Variable quaternion = levi::Variable(4, "baseQuaternion");
@@ -49,10 +66,64 @@ public:
         motionSubspacesWrenchMap, adjointDerivativeMap, adjointWrenchDerivativeMap, absoluteVelocitiesMap,
         absoluteVelocitiesDerivativeMap, linkInertiaMap, linkInertiaInBaseMap, momentumDoubleDerivativeMap, comHessianMap;
     TransformsMap transformsMap;
+    std::unordered_map<size_t, std::vector<size_t>> chainJointsMap;
     RobotState robotState;
+    size_t nFrames, nLinks, nDOFs;
+    iDynTree::FrameIndex baseFrame;
+    std::vector<std::string> twistsNames;
+    VariablesStamp modelStamp;
+    bool hessiansEnabled = true;
+    VariablesStamp quaternionStamp = 0, basePositionStamp = 0, jointsPositionStamp = 0, jointsVelocityStamp = 0,
+        baseLinearVelocityStamp = 0, baseQuaternionVelocityStamp = 0;
 
     bool first;
 
+    size_t framesPairKey(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame) const {
+        assert(baseFrame >= 0 && static_cast<size_t>(baseFrame) < nFrames);
+        assert(targetFrame >= 0 && static_cast<size_t>(targetFrame) < nFrames);
+        return static_cast<size_t>(baseFrame) * nFrames + static_cast<size_t>(targetFrame);
+    }
+
+    size_t columnKey(size_t key, long column) const {
+        assert(column >= 0 && static_cast<size_t>(column) < nDOFs);
+        return key * nDOFs + static_cast<size_t>(column);
+    }
+
+    size_t motionSubspaceKey(iDynTree::JointIndex joint, iDynTree::LinkIndex parentLink, iDynTree::LinkIndex childLink) const {
+        return (static_cast<size_t>(joint) * nLinks + static_cast<size_t>(parentLink)) * nLinks + static_cast<size_t>(childLink);
+    }
+
+    size_t twistKey(const levi::Variable &baseTwist, iDynTree::FrameIndex targetFrame) {
+        size_t twistIndex = 0;
+        while (twistIndex < twistsNames.size() && twistsNames[twistIndex] != baseTwist.name()) {
+            twistIndex++;
+        }
+        if (twistIndex == twistsNames.size()) {
+            twistsNames.push_back(baseTwist.name());
+        }
+        return twistIndex * nFrames + static_cast<size_t>(targetFrame);
+    }
+
+    template<typename VectorType>
+    void assignIfChanged(levi::Variable& variable, VariablesStamp& lastStamp, const VectorType& value) {
+        VariablesStamp newStamp = VectorsStamp(value);
+        if (newStamp != lastStamp) {
+            variable = iDynTree::toEigen(value);
+            lastStamp = newStamp;
+        }
+    }
+
+    //Assigning a levi variable invalidates the buffers of all the expressions depending on it.
+    //Hence, only the variables whose value changed are assigned, so that the other expressions keep their evaluations.
+    void assignVariables(const RobotState& state) {
+        assignIfChanged(quaternion, quaternionStamp, state.base_quaternion);
+        assignIfChanged(basePositionExpr, basePositionStamp, state.base_position);
+        assignIfChanged(s, jointsPositionStamp, state.s);
+        assignIfChanged(s_dot, jointsVelocityStamp, state.s_dot);
+        assignIfChanged(baseLinearVelocity, baseLinearVelocityStamp, state.base_linearVelocity);
+        assignIfChanged(baseQuaternionVelocity, baseQuaternionVelocityStamp, state.base_quaternionVelocity);
+    }
+
     void clearDerivatives(ExpressionMap& map) {
         for (ExpressionMap::iterator it = map.begin(); it != map.end(); ++it) {
             it->second.clearDerivativesCache();
@@ -67,6 +138,12 @@ ExpressionsServer::ExpressionsServer(std::shared_ptr<TimelySharedKinDynComputati
 {
     assert(timelySharedKinDyn);
     m_pimpl->timelySharedKinDyn = timelySharedKinDyn;
+    m_pimpl->nFrames = timelySharedKinDyn->model().getNrOfFrames();
+    m_pimpl->nLinks = timelySharedKinDyn->model().getNrOfLinks();
+    m_pimpl->nDOFs = timelySharedKinDyn->model().getNrOfDOFs();
+    m_pimpl->baseFrame = timelySharedKinDyn->model().getFrameIndex(timelySharedKinDyn->getFloatingBase());
+    assert(m_pimpl->baseFrame != iDynTree::FRAME_INVALID_INDEX);
+    m_pimpl->modelStamp = modelStamp(timelySharedKinDyn->model(), timelySharedKinDyn->getFloatingBase());
 
     m_pimpl->quaternionNormalized = m_pimpl->quaternion/(m_pimpl->quaternion.transpose() * m_pimpl->quaternion).pow(0.5);
     levi::Expression quaternionReal = m_pimpl->quaternionNormalized(0,0);
@@ -93,7 +170,7 @@ ExpressionsServer::ExpressionsServer(std::shared_ptr<TimelySharedKinDynComputati
     m_pimpl->crbi = levi::Null(6,6);
 
     for (iDynTree::LinkIndex l = 0; l < static_cast<int>(model().getNrOfLinks()); ++l) {
-        m_pimpl->crbi = m_pimpl->crbi + linkInertiaInBase(l) * adjointTransform(model().getLinkName(l), getFloatingBase());
+        m_pimpl->crbi = m_pimpl->crbi + linkInertiaInBase(l) * adjointTransform(l, m_pimpl->baseFrame);
     }
 
     m_pimpl->first = true;
@@ -123,24 +200,76 @@ ExpressionsServer::~ExpressionsServer()
     m_pimpl->crbi.clearDerivativesCache();
 }
 
+VariablesStamp ExpressionsServer::modelStamp(const iDynTree::Model &model, const std::string &floatingBase)
+{
+    VariablesStamp stamp = AddNameToStamp(0, floatingBase);
+
+    for (iDynTree::LinkIndex l = 0; l < static_cast<iDynTree::LinkIndex>(model.getNrOfLinks()); ++l) {
+        stamp = AddNameToStamp(stamp, model.getLinkName(l));
+        stamp = AddMatrixToStamp(stamp, model.getLink(l)->getInertia().asMatrix());
+    }
+
+    for (iDynTree::JointIndex j = 0; j < static_cast<iDynTree::JointIndex>(model.getNrOfJoints()); ++j) {
+        iDynTree::IJointConstPtr joint = model.getJoint(j);
+        iDynTree::LinkIndex parentLink = joint->getFirstAttachedLink();
+        iDynTree::LinkIndex childLink = joint->getSecondAttachedLink();
+        stamp = AddNameToStamp(stamp, model.getJointName(j));
+        stamp = MixStamp(stamp, static_cast<uint64_t>(parentLink));
+        stamp = MixStamp(stamp, static_cast<uint64_t>(childLink));
+        stamp = MixStamp(stamp, static_cast<uint64_t>(joint->getNrOfDOFs()));
+        stamp = AddMatrixToStamp(stamp, joint->getRestTransform(childLink, parentLink).asHomogeneousTransform());
+        for (unsigned int dof = 0; dof < joint->getNrOfDOFs(); ++dof) {
+            stamp = AddToStamp(stamp, iDynTree::toEigen(joint->getMotionSubspaceVector(dof, childLink, parentLink)));
+        }
+    }
+
+    for (iDynTree::FrameIndex f = static_cast<iDynTree::FrameIndex>(model.getNrOfLinks()); f < static_cast<iDynTree::FrameIndex>(model.getNrOfFrames()); ++f) {
+        stamp = AddNameToStamp(stamp, model.getFrameName(f));
+        stamp = MixStamp(stamp, static_cast<uint64_t>(model.getFrameLink(f)));
+        stamp = AddMatrixToStamp(stamp, model.getFrameTransform(f).asHomogeneousTransform());
+    }
+
+    return (stamp != 0) ? stamp : 1;
+}
+
+bool ExpressionsServer::setTimelySharedKinDyn(std::shared_ptr<TimelySharedKinDynComputations> timelySharedKinDyn)
+{
+    assert(timelySharedKinDyn);
+
+    if (modelStamp(timelySharedKinDyn->model(), timelySharedKinDyn->getFloatingBase()) != m_pimpl->modelStamp) {
+        return false;
+    }
+
+    m_pimpl->timelySharedKinDyn = timelySharedKinDyn;
+    m_pimpl->timeCursor = TimelySharedKinDynComputations::Cursor();
+    m_pimpl->kinDyn.reset();
+    m_pimpl->first = true;
+
+    return true;
+}
+
+void ExpressionsServer::enableHessians(bool enabled)
+{
+    m_pimpl->hessiansEnabled = enabled;
+}
+
+bool ExpressionsServer::hessiansEnabled() const
+{
+    return m_pimpl->hessiansEnabled;
+}
+
 bool ExpressionsServer::updateRobotState(double time, const RobotState &currentState)
 {
     m_pimpl->time = time;
-    m_pimpl->kinDyn = m_pimpl->timelySharedKinDyn->get(time);
+    m_pimpl->kinDyn = m_pimpl->timelySharedKinDyn->get(time, m_pimpl->timeCursor);
 
     if (m_pimpl->first || !(m_pimpl->kinDyn->sameState(currentState))) {
-        if (!(m_pimpl->kinDyn->updateRobotState(currentState))){
+        m_pimpl->robotState = currentState;
+        if (!(m_pimpl->kinDyn->updateRobotState(m_pimpl->robotState))){ //robotState gets the version of the stored state
             return false;
         }
 
-        m_pimpl->quaternion = iDynTree::toEigen(currentState.base_quaternion);
-        m_pimpl->basePositionExpr = iDynTree::toEigen(currentState.base_position);
-        m_pimpl->s = iDynTree::toEigen(currentState.s);
-        m_pimpl->s_dot = iDynTree::toEigen(currentState.s_dot);
-        m_pimpl->baseLinearVelocity = iDynTree::toEigen(currentState.base_linearVelocity);
-        m_pimpl->baseQuaternionVelocity = iDynTree::toEigen(currentState.base_quaternionVelocity);
-
-        m_pimpl->robotState = m_pimpl->kinDyn->currentState();
+        m_pimpl->assignVariables(m_pimpl->robotState);
 
         m_pimpl->first = false;
     }
@@ -151,18 +280,16 @@ bool ExpressionsServer::updateRobotState(double time, const RobotState &currentS
 bool ExpressionsServer::updateRobotState(double time)
 {
     m_pimpl->time = time;
-    m_pimpl->kinDyn = m_pimpl->timelySharedKinDyn->get(time);
+    m_pimpl->kinDyn = m_pimpl->timelySharedKinDyn->get(time, m_pimpl->timeCursor);
 
     if (m_pimpl->first || !(m_pimpl->kinDyn->sameState(m_pimpl->robotState))) {
 
-        m_pimpl->quaternion = iDynTree::toEigen(m_pimpl->kinDyn->currentState().base_quaternion);
-        m_pimpl->basePositionExpr = iDynTree::toEigen(m_pimpl->kinDyn->currentState().base_position);
-        m_pimpl->s = iDynTree::toEigen(m_pimpl->kinDyn->currentState().s);
-        m_pimpl->s_dot = iDynTree::toEigen(m_pimpl->kinDyn->currentState().s_dot);
-        m_pimpl->baseLinearVelocity = iDynTree::toEigen(m_pimpl->kinDyn->currentState().base_linearVelocity);
-        m_pimpl->baseQuaternionVelocity = iDynTree::toEigen(m_pimpl->kinDyn->currentState().base_quaternionVelocity);
-
         m_pimpl->robotState = m_pimpl->kinDyn->currentState();
+        if (!(m_pimpl->kinDyn->updateRobotState(m_pimpl->robotState))){ //the copy is not versioned, here it only gets the version of the stored state
+            return false;
+        }
+
+        m_pimpl->assignVariables(m_pimpl->robotState);
 
         m_pimpl->first = false;
     }
@@ -177,7 +304,7 @@ const RobotState &ExpressionsServer::currentState() const
 
 SharedKinDynComputationsPointer ExpressionsServer::currentKinDyn()
 {
-    return m_pimpl->timelySharedKinDyn->get(m_pimpl->time.evaluate());
+    return m_pimpl->timelySharedKinDyn->get(m_pimpl->time.evaluate(), m_pimpl->timeCursor);
 }
 
 const iDynTree::Model &ExpressionsServer::model() const
@@ -247,15 +374,15 @@ levi::Expression ExpressionsServer::comInBase()
 
 levi::Expression ExpressionsServer::comInBaseHessian(long column)
 {
-    std::string label = std::to_string(column);
+    size_t key = static_cast<size_t>(column);
 
-    ExpressionMap::iterator element = m_pimpl->comHessianMap.find(label);
+    ExpressionMap::iterator element = m_pimpl->comHessianMap.find(key);
 
     if (element != m_pimpl->comHessianMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = label;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
         newElement.second = CoMInBaseJointsDoubleDerivative(this, column);
         auto result = m_pimpl->comHessianMap.insert(newElement);
         assert(result.second);
@@ -265,17 +392,28 @@ levi::Expression ExpressionsServer::comInBaseHessian(long column)
 
 levi::Expression ExpressionsServer::adjointTransform(const std::string &baseFrame, const std::string &targetFrame)
 {
-    ExpressionMap::iterator element = m_pimpl->adjointMap.find(baseFrame+targetFrame);
+    iDynTree::FrameIndex baseFrameIndex = model().getFrameIndex(baseFrame);
+    assert(baseFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    iDynTree::FrameIndex targetFrameIndex = model().getFrameIndex(targetFrame);
+    assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    return adjointTransform(baseFrameIndex, targetFrameIndex);
+}
+
+levi::Expression ExpressionsServer::adjointTransform(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame)
+{
+    size_t key = m_pimpl->framesPairKey(baseFrame, targetFrame);
+
+    ExpressionMap::iterator element = m_pimpl->adjointMap.find(key);
 
     if (element != m_pimpl->adjointMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = baseFrame + targetFrame;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
         if (baseFrame == targetFrame) {
             newElement.second = levi::Identity(6,6);
         } else {
-            newElement.second = AdjointTransformExpression(this, baseFrame, targetFrame);
+            newElement.second = AdjointTransformExpression(this, model().getFrameName(baseFrame), model().getFrameName(targetFrame));
         }
         auto result = m_pimpl->adjointMap.insert(newElement);
         assert(result.second);
@@ -285,19 +423,28 @@ levi::Expression ExpressionsServer::adjointTransform(const std::string &baseFram
 
 levi::Expression ExpressionsServer::adjointTransformJointsDerivative(const std::string &baseFrame, const std::string &targetFrame, long column)
 {
-    std::string label = baseFrame + targetFrame + "__" + std::to_string(column);
+    iDynTree::FrameIndex baseFrameIndex = model().getFrameIndex(baseFrame);
+    assert(baseFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    iDynTree::FrameIndex targetFrameIndex = model().getFrameIndex(targetFrame);
+    assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    return adjointTransformJointsDerivative(baseFrameIndex, targetFrameIndex, column);
+}
+
+levi::Expression ExpressionsServer::adjointTransformJointsDerivative(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame, long column)
+{
+    size_t key = m_pimpl->columnKey(m_pimpl->framesPairKey(baseFrame, targetFrame), column);
 
-    ExpressionMap::iterator element = m_pimpl->adjointDerivativeMap.find(label);
+    ExpressionMap::iterator element = m_pimpl->adjointDerivativeMap.find(key);
 
     if (element != m_pimpl->adjointDerivativeMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = label;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
         if (baseFrame == targetFrame) {
             newElement.second = levi::Null(6, m_pimpl->s.rows());
         } else {
-            newElement.second = AdjointTransformExpressionJointsDerivative(this, baseFrame, targetFrame, column);
+            newElement.second = AdjointTransformExpressionJointsDerivative(this, model().getFrameName(baseFrame), model().getFrameName(targetFrame), column);
         }
         auto result = m_pimpl->adjointDerivativeMap.insert(newElement);
         assert(result.second);
@@ -307,17 +454,28 @@ levi::Expression ExpressionsServer::adjointTransformJointsDerivative(const std::
 
 levi::Expression ExpressionsServer::adjointTransformWrench(const std::string &baseFrame, const std::string &targetFrame)
 {
-    ExpressionMap::iterator element = m_pimpl->adjointWrenchMap.find(baseFrame+targetFrame);
+    iDynTree::FrameIndex baseFrameIndex = model().getFrameIndex(baseFrame);
+    assert(baseFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    iDynTree::FrameIndex targetFrameIndex = model().getFrameIndex(targetFrame);
+    assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    return adjointTransformWrench(baseFrameIndex, targetFrameIndex);
+}
+
+levi::Expression ExpressionsServer::adjointTransformWrench(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame)
+{
+    size_t key = m_pimpl->framesPairKey(baseFrame, targetFrame);
+
+    ExpressionMap::iterator element = m_pimpl->adjointWrenchMap.find(key);
 
     if (element != m_pimpl->adjointWrenchMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = baseFrame + targetFrame;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
         if (baseFrame == targetFrame) {
             newElement.second = levi::Identity(6, 6);
         } else {
-            newElement.second = AdjointTransformWrenchExpression(this, baseFrame, targetFrame);
+            newElement.second = AdjointTransformWrenchExpression(this, model().getFrameName(baseFrame), model().getFrameName(targetFrame));
         }
         auto result = m_pimpl->adjointWrenchMap.insert(newElement);
         assert(result.second);
@@ -327,19 +485,28 @@ levi::Expression ExpressionsServer::adjointTransformWrench(const std::string &ba
 
 levi::Expression ExpressionsServer::adjointTransformWrenchJointsDerivative(const std::string &baseFrame, const std::string &targetFrame, long column)
 {
-    std::string label = baseFrame + targetFrame + "__" + std::to_string(column);
+    iDynTree::FrameIndex baseFrameIndex = model().getFrameIndex(baseFrame);
+    assert(baseFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    iDynTree::FrameIndex targetFrameIndex = model().getFrameIndex(targetFrame);
+    assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    return adjointTransformWrenchJointsDerivative(baseFrameIndex, targetFrameIndex, column);
+}
+
+levi::Expression ExpressionsServer::adjointTransformWrenchJointsDerivative(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame, long column)
+{
+    size_t key = m_pimpl->columnKey(m_pimpl->framesPairKey(baseFrame, targetFrame), column);
 
-    ExpressionMap::iterator element = m_pimpl->adjointWrenchDerivativeMap.find(label);
+    ExpressionMap::iterator element = m_pimpl->adjointWrenchDerivativeMap.find(key);
 
     if (element != m_pimpl->adjointWrenchDerivativeMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = label;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
         if (baseFrame == targetFrame) {
             newElement.second = levi::Null(6, m_pimpl->s.rows());
         } else {
-            newElement.second = AdjointTransformWrenchExpressionJointsDerivative(this, baseFrame, targetFrame, column);
+            newElement.second = AdjointTransformWrenchExpressionJointsDerivative(this, model().getFrameName(baseFrame), model().getFrameName(targetFrame), column);
         }
         auto result = m_pimpl->adjointWrenchDerivativeMap.insert(newElement);
         assert(result.second);
@@ -349,17 +516,28 @@ levi::Expression ExpressionsServer::adjointTransformWrenchJointsDerivative(const
 
 levi::Expression ExpressionsServer::relativePosition(const std::string &baseFrame, const std::string &targetFrame)
 {
-    ExpressionMap::iterator element = m_pimpl->relativePositionsMap.find(baseFrame+targetFrame);
+    iDynTree::FrameIndex baseFrameIndex = model().getFrameIndex(baseFrame);
+    assert(baseFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    iDynTree::FrameIndex targetFrameIndex = model().getFrameIndex(targetFrame);
+    assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    return relativePosition(baseFrameIndex, targetFrameIndex);
+}
+
+levi::Expression ExpressionsServer::relativePosition(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame)
+{
+    size_t key = m_pimpl->framesPairKey(baseFrame, targetFrame);
+
+    ExpressionMap::iterator element = m_pimpl->relativePositionsMap.find(key);
 
     if (element != m_pimpl->relativePositionsMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = baseFrame + targetFrame;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
         if (baseFrame == targetFrame) {
             newElement.second = levi::Null(3, 1);
         } else {
-            newElement.second = RelativePositionExpression(this, baseFrame, targetFrame);
+            newElement.second = RelativePositionExpression(this, model().getFrameName(baseFrame), model().getFrameName(targetFrame));
         }
         auto result = m_pimpl->relativePositionsMap.insert(newElement);
         assert(result.second);
@@ -369,17 +547,28 @@ levi::Expression ExpressionsServer::relativePosition(const std::string &baseFram
 
 levi::Expression ExpressionsServer::relativeQuaternion(const std::string &baseFrame, const std::string &targetFrame)
 {
-    ExpressionMap::iterator element = m_pimpl->relativeQuaternionsMap.find(baseFrame+targetFrame);
+    iDynTree::FrameIndex baseFrameIndex = model().getFrameIndex(baseFrame);
+    assert(baseFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    iDynTree::FrameIndex targetFrameIndex = model().getFrameIndex(targetFrame);
+    assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    return relativeQuaternion(baseFrameIndex, targetFrameIndex);
+}
+
+levi::Expression ExpressionsServer::relativeQuaternion(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame)
+{
+    size_t key = m_pimpl->framesPairKey(baseFrame, targetFrame);
+
+    ExpressionMap::iterator element = m_pimpl->relativeQuaternionsMap.find(key);
 
     if (element != m_pimpl->relativeQuaternionsMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = baseFrame + targetFrame;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
         if (baseFrame == targetFrame) {
             newElement.second = levi::Identity(4,4).col(0);
         } else {
-            newElement.second = RelativeQuaternionExpression(this, baseFrame, targetFrame);
+            newElement.second = RelativeQuaternionExpression(this, model().getFrameName(baseFrame), model().getFrameName(targetFrame));
         }
         auto result = m_pimpl->relativeQuaternionsMap.insert(newElement);
         assert(result.second);
@@ -389,13 +578,24 @@ levi::Expression ExpressionsServer::relativeQuaternion(const std::string &baseFr
 
 levi::Expression ExpressionsServer::relativeRotation(const std::string &baseFrame, const std::string &targetFrame)
 {
-    ExpressionMap::iterator element = m_pimpl->relativeRotationsMap.find(baseFrame+targetFrame);
+    iDynTree::FrameIndex baseFrameIndex = model().getFrameIndex(baseFrame);
+    assert(baseFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    iDynTree::FrameIndex targetFrameIndex = model().getFrameIndex(targetFrame);
+    assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    return relativeRotation(baseFrameIndex, targetFrameIndex);
+}
+
+levi::Expression ExpressionsServer::relativeRotation(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame)
+{
+    size_t key = m_pimpl->framesPairKey(baseFrame, targetFrame);
+
+    ExpressionMap::iterator element = m_pimpl->relativeRotationsMap.find(key);
 
     if (element != m_pimpl->relativeRotationsMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = baseFrame + targetFrame;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
         if (baseFrame == targetFrame) {
             newElement.second = levi::Identity(3, 3);
         } else {
@@ -409,13 +609,24 @@ levi::Expression ExpressionsServer::relativeRotation(const std::string &baseFram
 
 TransformExpression ExpressionsServer::relativeTransform(const std::string &baseFrame, const std::string &targetFrame)
 {
-    TransformsMap::iterator element = m_pimpl->transformsMap.find(baseFrame+targetFrame);
+    iDynTree::FrameIndex baseFrameIndex = model().getFrameIndex(baseFrame);
+    assert(baseFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    iDynTree::FrameIndex targetFrameIndex = model().getFrameIndex(targetFrame);
+    assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    return relativeTransform(baseFrameIndex, targetFrameIndex);
+}
+
+TransformExpression ExpressionsServer::relativeTransform(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame)
+{
+    size_t key = m_pimpl->framesPairKey(baseFrame, targetFrame);
+
+    TransformsMap::iterator element = m_pimpl->transformsMap.find(key);
 
     if (element != m_pimpl->transformsMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, TransformExpression> newElement;
-        newElement.first = baseFrame + targetFrame;
+        std::pair<size_t, TransformExpression> newElement;
+        newElement.first = key;
         newElement.second = TransformExpression(relativePosition(baseFrame, targetFrame), relativeRotation(baseFrame, targetFrame));
         auto result = m_pimpl->transformsMap.insert(newElement);
         assert(result.second);
@@ -425,17 +636,28 @@ TransformExpression ExpressionsServer::relativeTransform(const std::string &base
 
 levi::Expression ExpressionsServer::relativeLeftJacobian(const std::string &baseFrame, const std::string &targetFrame)
 {
-    ExpressionMap::iterator element = m_pimpl->relativeJacobiansMap.find(baseFrame+targetFrame);
+    iDynTree::FrameIndex baseFrameIndex = model().getFrameIndex(baseFrame);
+    assert(baseFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    iDynTree::FrameIndex targetFrameIndex = model().getFrameIndex(targetFrame);
+    assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    return relativeLeftJacobian(baseFrameIndex, targetFrameIndex);
+}
+
+levi::Expression ExpressionsServer::relativeLeftJacobian(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame)
+{
+    size_t key = m_pimpl->framesPairKey(baseFrame, targetFrame);
+
+    ExpressionMap::iterator element = m_pimpl->relativeJacobiansMap.find(key);
 
     if (element != m_pimpl->relativeJacobiansMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = baseFrame + targetFrame;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
         if (baseFrame == targetFrame) {
             newElement.second = levi::Null(6, m_pimpl->s.rows());
         } else {
-            newElement.second = RelativeLeftJacobianExpression(this, baseFrame, targetFrame);
+            newElement.second = RelativeLeftJacobianExpression(this, model().getFrameName(baseFrame), model().getFrameName(targetFrame));
         }
         auto result = m_pimpl->relativeJacobiansMap.insert(newElement);
         assert(result.second);
@@ -445,17 +667,28 @@ levi::Expression ExpressionsServer::relativeLeftJacobian(const std::string &base
 
 levi::Expression ExpressionsServer::relativeVelocity(const std::string &baseFrame, const std::string &targetFrame)
 {
-    ExpressionMap::iterator element = m_pimpl->velocitiesMap.find(baseFrame+targetFrame);
+    iDynTree::FrameIndex baseFrameIndex = model().getFrameIndex(baseFrame);
+    assert(baseFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    iDynTree::FrameIndex targetFrameIndex = model().getFrameIndex(targetFrame);
+    assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    return relativeVelocity(baseFrameIndex, targetFrameIndex);
+}
+
+levi::Expression ExpressionsServer::relativeVelocity(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame)
+{
+    size_t key = m_pimpl->framesPairKey(baseFrame, targetFrame);
+
+    ExpressionMap::iterator element = m_pimpl->velocitiesMap.find(key);
 
     if (element != m_pimpl->velocitiesMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = baseFrame + targetFrame;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
         if (baseFrame == targetFrame) {
             newElement.second = levi::Null(6, 1);
         } else {
-            newElement.second = RelativeLeftVelocityExpression(this, baseFrame, targetFrame);
+            newElement.second = RelativeLeftVelocityExpression(this, model().getFrameName(baseFrame), model().getFrameName(targetFrame));
         }
         auto result = m_pimpl->velocitiesMap.insert(newElement);
         assert(result.second);
@@ -465,18 +698,26 @@ levi::Expression ExpressionsServer::relativeVelocity(const std::string &baseFram
 
 levi::Expression ExpressionsServer::absoluteVelocity(const std::string &targetFrame, const levi::Variable &baseTwist)
 {
-    std::string key = targetFrame + baseTwist.name();
+    iDynTree::FrameIndex targetFrameIndex = model().getFrameIndex(targetFrame);
+    assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    return absoluteVelocity(targetFrameIndex, baseTwist);
+}
+
+levi::Expression ExpressionsServer::absoluteVelocity(iDynTree::FrameIndex targetFrame, const levi::Variable &baseTwist)
+{
+    size_t key = m_pimpl->twistKey(baseTwist, targetFrame);
+
     ExpressionMap::iterator element = m_pimpl->absoluteVelocitiesMap.find(key);
 
     if (element != m_pimpl->absoluteVelocitiesMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
+        std::pair<size_t, levi::Expression> newElement;
         newElement.first = key;
-        if (targetFrame == getFloatingBase()) {
+        if (targetFrame == m_pimpl->baseFrame) {
             newElement.second = baseTwist;
         } else {
-            newElement.second = AbsoluteLeftVelocityExpression(this, baseTwist, targetFrame);
+            newElement.second = AbsoluteLeftVelocityExpression(this, baseTwist, model().getFrameName(targetFrame));
         }
         auto result = m_pimpl->absoluteVelocitiesMap.insert(newElement);
         assert(result.second);
@@ -491,19 +732,26 @@ levi::Expression ExpressionsServer::absoluteVelocity(const std::string &targetFr
 
 levi::Expression ExpressionsServer::absoluteVelocityJointsDerivative(const std::string &targetFrame, const levi::Variable &baseTwist)
 {
-    std::string label = targetFrame + baseTwist.name();
+    iDynTree::FrameIndex targetFrameIndex = model().getFrameIndex(targetFrame);
+    assert(targetFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    return absoluteVelocityJointsDerivative(targetFrameIndex, baseTwist);
+}
 
-    ExpressionMap::iterator element = m_pimpl->absoluteVelocitiesDerivativeMap.find(label);
+levi::Expression ExpressionsServer::absoluteVelocityJointsDerivative(iDynTree::FrameIndex targetFrame, const levi::Variable &baseTwist)
+{
+    size_t key = m_pimpl->twistKey(baseTwist, targetFrame);
+
+    ExpressionMap::iterator element = m_pimpl->absoluteVelocitiesDerivativeMap.find(key);
 
     if (element != m_pimpl->absoluteVelocitiesDerivativeMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = label;
-        if (targetFrame == getFloatingBase()) {
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
+        if (targetFrame == m_pimpl->baseFrame) {
             newElement.second = levi::Null(6, m_pimpl->s.rows());
         } else {
-            newElement.second = AbsoluteLeftVelocityJointsDerivativeExpression(this, baseTwist, targetFrame);
+            newElement.second = AbsoluteLeftVelocityJointsDerivativeExpression(this, baseTwist, model().getFrameName(targetFrame));
         }
         auto result = m_pimpl->absoluteVelocitiesDerivativeMap.insert(newElement);
         assert(result.second);
@@ -513,13 +761,17 @@ levi::Expression ExpressionsServer::absoluteVelocityJointsDerivative(const std::
 
 levi::Expression ExpressionsServer::quaternionError(const std::string &desiredFrame, const levi::Variable &desiredQuaternion)
 {
-    ExpressionMap::iterator element = m_pimpl->quaternionsErrorsMap.find(desiredFrame);
+    iDynTree::FrameIndex desiredFrameIndex = model().getFrameIndex(desiredFrame);
+    assert(desiredFrameIndex != iDynTree::FRAME_INVALID_INDEX);
+    size_t key = static_cast<size_t>(desiredFrameIndex);
+
+    ExpressionMap::iterator element = m_pimpl->quaternionsErrorsMap.find(key);
 
     if (element != m_pimpl->quaternionsErrorsMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = desiredFrame;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
         newElement.second = QuaternionError(desiredFrame, this, desiredQuaternion);
         auto result = m_pimpl->quaternionsErrorsMap.insert(newElement);
         assert(result.second);
@@ -529,14 +781,14 @@ levi::Expression ExpressionsServer::quaternionError(const std::string &desiredFr
 
 levi::Expression ExpressionsServer::motionSubSpaceVector(iDynTree::JointIndex joint, iDynTree::LinkIndex parentLink, iDynTree::LinkIndex childLink)
 {
-    std::string label = model().getJointName(joint) + std::to_string(parentLink) + std::to_string(childLink);
-    ExpressionMap::iterator element = m_pimpl->motionSubspacesMap.find(label);
+    size_t key = m_pimpl->motionSubspaceKey(joint, parentLink, childLink);
+    ExpressionMap::iterator element = m_pimpl->motionSubspacesMap.find(key);
 
     if (element != m_pimpl->motionSubspacesMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = label;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
 
         Eigen::Matrix<double, 6,1> motionSubSpace = iDynTree::toEigen(model().getJoint(joint)->getMotionSubspaceVector(0,
                                                                                                                         childLink,
@@ -551,14 +803,14 @@ levi::Expression ExpressionsServer::motionSubSpaceVector(iDynTree::JointIndex jo
 
 levi::Expression ExpressionsServer::motionSubSpaceAsCrossProduct(iDynTree::JointIndex joint, iDynTree::LinkIndex parentLink, iDynTree::LinkIndex childLink)
 {
-    std::string label = model().getJointName(joint) + std::to_string(parentLink) + std::to_string(childLink);
-    ExpressionMap::iterator element = m_pimpl->motionSubspacesMatrixMap.find(label);
+    size_t key = m_pimpl->motionSubspaceKey(joint, parentLink, childLink);
+    ExpressionMap::iterator element = m_pimpl->motionSubspacesMatrixMap.find(key);
 
     if (element != m_pimpl->motionSubspacesMatrixMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = label;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
 
         Eigen::Matrix<double, 6,6> motionSubSpaceAsCrossProduct =
             iDynTree::toEigen(model().getJoint(joint)->getMotionSubspaceVector(0,
@@ -574,14 +826,14 @@ levi::Expression ExpressionsServer::motionSubSpaceAsCrossProduct(iDynTree::Joint
 
 levi::Expression ExpressionsServer::motionSubSpaceAsCrossProductWrench(iDynTree::JointIndex joint, iDynTree::LinkIndex parentLink, iDynTree::LinkIndex childLink)
 {
-    std::string label = model().getJointName(joint) + std::to_string(parentLink) + std::to_string(childLink);
-    ExpressionMap::iterator element = m_pimpl->motionSubspacesWrenchMap.find(label);
+    size_t key = m_pimpl->motionSubspaceKey(joint, parentLink, childLink);
+    ExpressionMap::iterator element = m_pimpl->motionSubspacesWrenchMap.find(key);
 
     if (element != m_pimpl->motionSubspacesWrenchMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = label;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
 
         Eigen::Matrix<double, 6,6> motionSubSpaceAsCrossProductWrench =
             iDynTree::toEigen(model().getJoint(joint)->getMotionSubspaceVector(0,
@@ -597,14 +849,14 @@ levi::Expression ExpressionsServer::motionSubSpaceAsCrossProductWrench(iDynTree:
 
 levi::Expression ExpressionsServer::linkInertia(iDynTree::LinkIndex link)
 {
-    std::string label = model().getLinkName(link);
-    ExpressionMap::iterator element = m_pimpl->linkInertiaMap.find(label);
+    size_t key = static_cast<size_t>(link);
+    ExpressionMap::iterator element = m_pimpl->linkInertiaMap.find(key);
 
     if (element != m_pimpl->linkInertiaMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = label;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
 
         newElement.second = levi::Constant(iDynTree::toEigen(model().getLink(link)->getInertia().asMatrix()),"I_" + model().getLinkName(link));
         auto result = m_pimpl->linkInertiaMap.insert(newElement);
@@ -615,16 +867,16 @@ levi::Expression ExpressionsServer::linkInertia(iDynTree::LinkIndex link)
 
 levi::Expression ExpressionsServer::linkInertiaInBase(iDynTree::LinkIndex link)
 {
-    std::string label = model().getLinkName(link);
-    ExpressionMap::iterator element = m_pimpl->linkInertiaInBaseMap.find(label);
+    size_t key = static_cast<size_t>(link);
+    ExpressionMap::iterator element = m_pimpl->linkInertiaInBaseMap.find(key);
 
     if (element != m_pimpl->linkInertiaInBaseMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = label;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
 
-        newElement.second = adjointTransformWrench(getFloatingBase(), model().getLinkName(link)) * linkInertia(link);
+        newElement.second = adjointTransformWrench(m_pimpl->baseFrame, link) * linkInertia(link);
         auto result = m_pimpl->linkInertiaInBaseMap.insert(newElement);
         assert(result.second);
         return (result.first->second);
@@ -638,18 +890,69 @@ levi::Expression ExpressionsServer::compositeRigidBodyInertia()
 
 levi::Expression ExpressionsServer::momentumInBaseJointsDoubleDerivative(const levi::Variable &baseTwist, long column)
 {
-    std::string label = std::to_string(column);
+    size_t key = static_cast<size_t>(column);
 
-    ExpressionMap::iterator element = m_pimpl->momentumDoubleDerivativeMap.find(label);
+    ExpressionMap::iterator element = m_pimpl->momentumDoubleDerivativeMap.find(key);
 
     if (element != m_pimpl->momentumDoubleDerivativeMap.end()) {
         return (element->second);
     } else {
-        std::pair<std::string, levi::Expression> newElement;
-        newElement.first = label;
+        std::pair<size_t, levi::Expression> newElement;
+        newElement.first = key;
         newElement.second = MomentumInBaseExpressionJointsDoubleDerivativeExpression(this, baseTwist, column);
         auto result = m_pimpl->momentumDoubleDerivativeMap.insert(newElement);
         assert(result.second);
         return (result.first->second);
     }
 }
+
+const std::vector<size_t> &ExpressionsServer::chainJoints(iDynTree::FrameIndex baseFrame, iDynTree::FrameIndex targetFrame)
+{
+    size_t key = m_pimpl->framesPairKey(baseFrame, targetFrame);
+
+    auto element = m_pimpl->chainJointsMap.find(key);
+
+    if (element != m_pimpl->chainJointsMap.end()) {
+        return element->second;
+    }
+
+    std::vector<size_t> joints;
+    const iDynTree::Model& fullModel = model();
+    iDynTree::LinkIndex baseLink = fullModel.getFrameLink(baseFrame);
+    assert(baseLink != iDynTree::LINK_INVALID_INDEX);
+    iDynTree::LinkIndex visitedLink = fullModel.getFrameLink(targetFrame);
+    assert(visitedLink != iDynTree::LINK_INVALID_INDEX);
+
+    if (visitedLink != baseLink) {
+        iDynTree::Traversal traversal;
+        bool ok = fullModel.computeFullTreeTraversal(traversal, baseLink);
+        assert(ok);
+        static_cast<void>(ok);
+
+        while (visitedLink != baseLink) {
+            iDynTree::IJointConstPtr jointPtr = traversal.getParentJointFromLinkIndex(visitedLink);
+            assert(jointPtr);
+            for (unsigned int dof = 0; dof < jointPtr->getNrOfDOFs(); ++dof) {
+                joints.push_back(jointPtr->getDOFsOffset() + dof);
+            }
+            visitedLink = traversal.getParentLinkFromLinkIndex(visitedLink)->getIndex();
+        }
+
+        std::sort(joints.begin(), joints.end());
+    }
+
+    auto result = m_pimpl->chainJointsMap.insert(std::make_pair(key, joints));
+    assert(result.second);
+    return result.first->second;
+}
+
+levi::Expression ExpressionsServer::flatten(const levi::Expression &expression, const std::string &name)
+{
+#ifdef DPLANNER_SQUEEZE_EXPRESSIONS
+    levi::Expression toBeSqueezed = expression;
+    return toBeSqueezed.squeeze(name);
+#else
+    static_cast<void>(name);
+    return expression;
+#endif
+}
@@ -7,10 +7,10 @@
 
 #include <levi/levi.h>
 #include <DynamicalPlannerPrivate/Constraints/FeetLateralDistanceConstraint.h>
-#include <DynamicalPlannerPrivate/Utilities/CheckEqualVector.h>
 #include <DynamicalPlannerPrivate/Utilities/QuaternionUtils.h>
 #include <iDynTree/Core/EigenHelpers.h>
 #include <cassert>
+#include <iostream>
 
 using namespace DynamicalPlanner::Private;
 
@@ -30,15 +30,16 @@ public:
     std::shared_ptr<TimelySharedKinDynComputations> timedSharedKinDyn;
     std::shared_ptr<ExpressionsServer> expressionsServer;
 
-    bool updateDoneOnceConstraint = false;
-    bool updateDoneOnceStateJacobian = false;
-    double tolerance;
+    uint64_t constraintVersion = 0; //versions of the robot state used to compute the cached values
+    uint64_t stateJacobianVersion = 0;
 
     iDynTree::optimalcontrol::SparsityStructure stateSparsity, controlSparsity;
     iDynTree::optimalcontrol::SparsityStructure stateHessianSparsity, controlHessianSparsity, mixedHessianSparsity;
 
     levi::Expression asExpression, jointsDerivative;
     std::vector<levi::Expression> columnsHessian;
+    bool hessianExpressionsBuilt = false;
+    std::vector<size_t> chainJoints; //the joints between the two feet, the derivatives with respect to the other joints are zero
     iDynTree::VectorDynSize jointsHessianBuffer;
 
     void updateRobotState() {
@@ -50,22 +51,38 @@ public:
 
     }
 
-    bool sameVariables(bool updateDoneOnce) {
-        bool same = updateDoneOnce;
-        same = same && VectorsAreEqual(robotState.s, stateVariables(jointsPositionRange), tolerance);
+    bool sameVariables(uint64_t& lastVersion) { //Updates the robot state. True if its version is the one used to compute the cached values.
+        updateRobotState();
+        bool same = (robotState.version.value() != 0) && (robotState.version.value() == lastVersion);
+        lastVersion = robotState.version.value();
         return same;
     }
 
+    void buildHessianExpressions() { //The second derivatives are built only when first needed
+        if (hessianExpressionsBuilt) {
+            return;
+        }
+
+        for (size_t joint : chainJoints) {
+            columnsHessian.push_back(expressionsServer->flatten(jointsDerivative.getColumnDerivative(static_cast<Eigen::Index>(joint),
+                                                                                                    (expressionsServer->jointsPosition())),
+                                                                "feetLateralDistanceHessian_" + std::to_string(joint)));
+        }
+
+        hessianExpressionsBuilt = true;
+    }
+
     void setSparsity() {
         stateSparsity.clear();
         controlSparsity.clear();
 
-        iDynTree::IndexRange fullRange;
-        fullRange.offset = 0;
-        fullRange.size = 1;
-
-        stateSparsity.addDenseBlock(fullRange, jointsPositionRange);
-        stateHessianSparsity.addDenseBlock(jointsPositionRange, jointsPositionRange);
+        size_t jointsOffset = static_cast<size_t>(jointsPositionRange.offset);
+        for (size_t joint : chainJoints) {
+            stateSparsity.addDenseBlock(0, jointsOffset + joint, 1, 1);
+            for (size_t otherJoint : chainJoints) {
+                stateHessianSparsity.addDenseBlock(jointsOffset + joint, jointsOffset + otherJoint, 1, 1);
+            }
+        }
         mixedHessianSparsity.clear();
         controlHessianSparsity.clear();
     }
@@ -105,7 +122,6 @@ FeetLateralDistanceConstraint::FeetLateralDistanceConstraint(const VariablesLabe
     m_pimpl->controlJacobianBuffer.resize(1, static_cast<unsigned int>(controlVariables.size()));
     m_pimpl->controlJacobianBuffer.zero();
 
-    m_pimpl->tolerance = timelySharedKinDyn->getUpdateTolerance();
 
     m_lowerBound(0) = 0.1;
 
@@ -113,9 +129,11 @@ FeetLateralDistanceConstraint::FeetLateralDistanceConstraint(const VariablesLabe
     m_isUpperBounded = false;
     m_lowerBound.zero();
 
+    m_pimpl->expressionsServer = expressionsServer;
+    m_pimpl->chainJoints = expressionsServer->chainJoints(referenceFootFrame, otherFootFrame);
+
     m_pimpl->setSparsity();
 
-    m_pimpl->expressionsServer = expressionsServer;
     m_pimpl->jointsHessianBuffer.resize(static_cast<unsigned int>(m_pimpl->jointsPositionRange.size));
 
     std::string referenceFrameName = timelySharedKinDyn->model().getFrameName(referenceFootFrame);
@@ -123,9 +141,6 @@ FeetLateralDistanceConstraint::FeetLateralDistanceConstraint(const VariablesLabe
 
     m_pimpl->asExpression = (m_pimpl->expressionsServer->relativePosition(referenceFrameName, otherFootName)).row(lateralIndex);
     m_pimpl->jointsDerivative = m_pimpl->asExpression.getColumnDerivative(0, (m_pimpl->expressionsServer->jointsPosition()));
-    for (Eigen::Index i = 0; i < m_pimpl->jointsPositionRange.size; ++i) {
-        m_pimpl->columnsHessian.push_back(m_pimpl->jointsDerivative.getColumnDerivative(i, (m_pimpl->expressionsServer->jointsPosition())));
-    }
 
 }
 
@@ -154,10 +169,7 @@ bool FeetLateralDistanceConstraint::evaluateConstraint(double time, const iDynTr
 {
     m_pimpl->stateVariables = state;
     m_pimpl->sharedKinDyn = m_pimpl->timedSharedKinDyn->get(time);
-    if (!(m_pimpl->sameVariables(m_pimpl->updateDoneOnceConstraint))) {
-
-//        m_pimpl->updateDoneOnceConstraint = true;
-        m_pimpl->updateRobotState();
+    if (!(m_pimpl->sameVariables(m_pimpl->constraintVersion))) {
 
         m_pimpl->feetDistance = m_pimpl->sharedKinDyn->getRelativeTransform(m_pimpl->robotState,
                                                                    m_pimpl->referenceFootFrame,
@@ -172,10 +184,7 @@ bool FeetLateralDistanceConstraint::constraintJacobianWRTState(double time, cons
     m_pimpl->stateVariables = state;
     m_pimpl->sharedKinDyn = m_pimpl->timedSharedKinDyn->get(time);
 
-    if (!(m_pimpl->sameVariables(m_pimpl->updateDoneOnceStateJacobian))) {
-
-//        m_pimpl->updateDoneOnceStateJacobian = true;
-        m_pimpl->updateRobotState();
+    if (!(m_pimpl->sameVariables(m_pimpl->stateJacobianVersion))) {
 
         bool ok = m_pimpl->sharedKinDyn->getRelativeJacobian(m_pimpl->robotState, m_pimpl->referenceFootFrame,
                                                              m_pimpl->otherFootFrame, m_pimpl->relativeJacobianBuffer,
@@ -229,6 +238,13 @@ bool FeetLateralDistanceConstraint::constraintSecondPartialDerivativeWRTState(do
                                                                               const iDynTree::VectorDynSize &lambda,
                                                                               iDynTree::MatrixDynSize &hessian)
 {
+    if (!m_pimpl->expressionsServer->hessiansEnabled()) {
+        std::cerr << "[ERROR][FeetLateralDistanceConstraint::constraintSecondPartialDerivativeWRTState] The Hessians have been disabled." << std::endl;
+        return false;
+    }
+
+    m_pimpl->buildHessianExpressions();
+
     m_pimpl->stateVariables = state;
     m_pimpl->controlVariables = control;
 
@@ -243,12 +259,12 @@ bool FeetLateralDistanceConstraint::constraintSecondPartialDerivativeWRTState(do
     iDynTree::iDynTreeEigenVector jointsMap = iDynTree::toEigen(m_pimpl->jointsHessianBuffer);
     Eigen::Matrix<double, 1, 4> quaternionHessian;
 
-    for (Eigen::Index i = 0; i < m_pimpl->jointsPositionRange.size; ++i) {
-        jointsMap = (m_pimpl->columnsHessian[static_cast<size_t>(i)].evaluate()).transpose() *
+    for (size_t i = 0; i < m_pimpl->chainJoints.size(); ++i) {
+        jointsMap = (m_pimpl->columnsHessian[i].evaluate()).transpose() *
             lambdaMap;
 
-        hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->jointsPositionRange.offset + i, m_pimpl->jointsPositionRange.size, 1) =
-            jointsMap;
+        hessianMap.block(m_pimpl->jointsPositionRange.offset, m_pimpl->jointsPositionRange.offset + static_cast<Eigen::Index>(m_pimpl->chainJoints[i]),
+                         m_pimpl->jointsPositionRange.size, 1) = jointsMap;
     }
 
     return true;
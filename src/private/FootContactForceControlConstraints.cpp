@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+
+#include <DynamicalPlannerPrivate/Constraints/FootContactForceControlConstraints.h>
+#include <iDynTree/Core/MatrixDynSize.h>
+#include <cassert>
+#include <vector>
+
+using namespace DynamicalPlanner::Private;
+
+class FootContactForceControlConstraints::Implementation {
+public:
+    VariablesLabeller stateVariables, controlVariables;
+
+    std::string footName;
+    HyperbolicSecant activation;
+    double maximumNormalDerivative;
+    double dissipationRatio;
+
+    typedef struct {
+        unsigned int pz, fz, uz; //normal components of the position, force and force control of the point
+    } PointIndices;
+    std::vector<PointIndices> points;
+
+    iDynTree::optimalcontrol::SparsityStructure stateJacobianSparsity, controlJacobianSparsity;
+    iDynTree::optimalcontrol::SparsityStructure stateHessianSparsity, controlHessianSparsity, mixedHessianSparsity;
+};
+
+
+
+FootContactForceControlConstraints::FootContactForceControlConstraints(const VariablesLabeller &stateVariables, const VariablesLabeller &controlVariables,
+                                                                       const FootRanges &footRanges, const std::string &footName,
+                                                                       const HyperbolicSecant &forceActivation, double maximumNormalDerivative,
+                                                                       double dissipationRatio)
+    : iDynTree::optimalcontrol::Constraint (footRanges.forcePoints.size(), "ForceControlBounds" + footName)
+    , m_pimpl(std::make_unique<Implementation>())
+{
+    m_pimpl->stateVariables = stateVariables;
+    m_pimpl->controlVariables = controlVariables;
+
+    m_pimpl->footName = footName;
+    m_pimpl->activation = forceActivation;
+    m_pimpl->maximumNormalDerivative = maximumNormalDerivative;
+    m_pimpl->dissipationRatio = dissipationRatio;
+
+    m_pimpl->stateJacobianSparsity.clear();
+    m_pimpl->controlJacobianSparsity.clear();
+    m_pimpl->stateHessianSparsity.clear();
+
+    size_t numberOfPoints = footRanges.forcePoints.size();
+    assert(footRanges.positionPoints.size() == numberOfPoints);
+    assert(footRanges.forceControlPoints.size() == numberOfPoints);
+    m_pimpl->points.resize(numberOfPoints);
+
+    for (size_t i = 0; i < numberOfPoints; ++i) {
+        assert(footRanges.positionPoints[i].isValid() && footRanges.forcePoints[i].isValid() && footRanges.forceControlPoints[i].isValid());
+
+        Implementation::PointIndices& point = m_pimpl->points[i];
+        point.pz = static_cast<unsigned int>(footRanges.positionPoints[i].offset + 2);
+        point.fz = static_cast<unsigned int>(footRanges.forcePoints[i].offset + 2);
+        point.uz = static_cast<unsigned int>(footRanges.forceControlPoints[i].offset + 2);
+
+        m_pimpl->stateJacobianSparsity.add(i, point.pz);
+        m_pimpl->stateJacobianSparsity.add(i, point.fz);
+
+        m_pimpl->controlJacobianSparsity.add(i, point.uz);
+
+        m_pimpl->stateHessianSparsity.add(point.pz, point.pz);
+        m_pimpl->stateHessianSparsity.add(point.pz, point.fz);
+        m_pimpl->stateHessianSparsity.add(point.fz, point.pz);
+    }
+
+    m_isLowerBounded = false;
+    m_isUpperBounded = true;
+    m_upperBound.zero();
+
+    m_pimpl->controlHessianSparsity.clear();
+    m_pimpl->mixedHessianSparsity.clear();
+}
+
+FootContactForceControlConstraints::~FootContactForceControlConstraints()
+{ }
+
+bool FootContactForceControlConstraints::evaluateConstraint(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control,
+                                                            iDynTree::VectorDynSize &constraint)
+{
+    for (size_t i = 0; i < m_pimpl->points.size(); ++i) {
+        const Implementation::PointIndices& point = m_pimpl->points[i];
+        double delta = m_pimpl->activation.eval(state(point.pz));
+
+        constraint(static_cast<unsigned int>(i)) = control(point.uz) - delta * m_pimpl->maximumNormalDerivative +
+                (1 - delta) * m_pimpl->dissipationRatio * state(point.fz);
+    }
+
+    return true;
+}
+
+bool FootContactForceControlConstraints::constraintJacobianWRTState(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &,
+                                                                    iDynTree::MatrixDynSize &jacobian)
+{
+    for (size_t i = 0; i < m_pimpl->points.size(); ++i) {
+        const Implementation::PointIndices& point = m_pimpl->points[i];
+        unsigned int row = static_cast<unsigned int>(i);
+        double delta = m_pimpl->activation.eval(state(point.pz));
+        double deltaDerivative = m_pimpl->activation.evalDerivative(state(point.pz));
+
+        jacobian(row, point.pz) = -deltaDerivative * (m_pimpl->maximumNormalDerivative + m_pimpl->dissipationRatio * state(point.fz));
+        jacobian(row, point.fz) = (1 - delta) * m_pimpl->dissipationRatio;
+    }
+
+    return true;
+}
+
+bool FootContactForceControlConstraints::constraintJacobianWRTControl(double, const iDynTree::VectorDynSize &, const iDynTree::VectorDynSize &,
+                                                                      iDynTree::MatrixDynSize &jacobian)
+{
+    for (size_t i = 0; i < m_pimpl->points.size(); ++i) {
+        jacobian(static_cast<unsigned int>(i), m_pimpl->points[i].uz) = 1.0;
+    }
+
+    return true;
+}
+
+size_t FootContactForceControlConstraints::expectedStateSpaceSize() const
+{
+    return m_pimpl->stateVariables.size();
+}
+
+size_t FootContactForceControlConstraints::expectedControlSpaceSize() const
+{
+    return m_pimpl->controlVariables.size();
+}
+
+bool FootContactForceControlConstraints::constraintJacobianWRTStateSparsity(iDynTree::optimalcontrol::SparsityStructure &stateSparsity)
+{
+    stateSparsity = m_pimpl->stateJacobianSparsity;
+    return true;
+}
+
+bool FootContactForceControlConstraints::constraintJacobianWRTControlSparsity(iDynTree::optimalcontrol::SparsityStructure &controlSparsity)
+{
+    controlSparsity = m_pimpl->controlJacobianSparsity;
+    return true;
+}
+
+bool FootContactForceControlConstraints::constraintSecondPartialDerivativeWRTState(double /*time*/, const iDynTree::VectorDynSize &state,
+                                                                                   const iDynTree::VectorDynSize &/*control*/,
+                                                                                   const iDynTree::VectorDynSize &lambda, iDynTree::MatrixDynSize &hessian)
+{
+    for (size_t i = 0; i < m_pimpl->points.size(); ++i) {
+        const Implementation::PointIndices& point = m_pimpl->points[i];
+        double pointLambda = lambda(static_cast<unsigned int>(i));
+        double deltaDerivative = m_pimpl->activation.evalDerivative(state(point.pz));
+        double deltaDoubleDerivative = m_pimpl->activation.evalDoubleDerivative(state(point.pz));
+
+        hessian(point.pz, point.pz) = -pointLambda * deltaDoubleDerivative * (m_pimpl->maximumNormalDerivative + m_pimpl->dissipationRatio * state(point.fz));
+        hessian(point.pz, point.fz) = -pointLambda * deltaDerivative * m_pimpl->dissipationRatio;
+        hessian(point.fz, point.pz) = hessian(point.pz, point.fz);
+    }
+
+    return true;
+}
+
+bool FootContactForceControlConstraints::constraintSecondPartialDerivativeWRTControl(double /*time*/, const iDynTree::VectorDynSize &/*state*/,
+                                                                                     const iDynTree::VectorDynSize &/*control*/,
+                                                                                     const iDynTree::VectorDynSize &/*lambda*/,
+                                                                                     iDynTree::MatrixDynSize &/*hessian*/)
+{
+    return true;
+}
+
+bool FootContactForceControlConstraints::constraintSecondPartialDerivativeWRTStateControl(double /*time*/, const iDynTree::VectorDynSize &/*state*/,
+                                                                                          const iDynTree::VectorDynSize &/*control*/,
+                                                                                          const iDynTree::VectorDynSize &/*lambda*/,
+                                                                                          iDynTree::MatrixDynSize &/*hessian*/)
+{
+    return true;
+}
+
+bool FootContactForceControlConstraints::constraintSecondPartialDerivativeWRTStateSparsity(iDynTree::optimalcontrol::SparsityStructure &stateSparsity)
+{
+    stateSparsity = m_pimpl->stateHessianSparsity;
+    return true;
+}
+
+bool FootContactForceControlConstraints::constraintSecondPartialDerivativeWRTStateControlSparsity(iDynTree::optimalcontrol::SparsityStructure &stateControlSparsity)
+{
+    stateControlSparsity = m_pimpl->mixedHessianSparsity;
+    return true;
+}
+
+bool FootContactForceControlConstraints::constraintSecondPartialDerivativeWRTControlSparsity(iDynTree::optimalcontrol::SparsityStructure &controlSparsity)
+{
+    controlSparsity = m_pimpl->controlHessianSparsity;
+    return true;
+}
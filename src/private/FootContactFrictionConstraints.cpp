@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+
+#include <DynamicalPlannerPrivate/Constraints/FootContactFrictionConstraints.h>
+#include <iDynTree/Core/MatrixDynSize.h>
+#include <iDynTree/Core/EigenHelpers.h>
+#include <Eigen/Core>
+#include <cassert>
+#include <vector>
+
+using namespace DynamicalPlanner::Private;
+
+class FootContactFrictionConstraints::Implementation {
+public:
+    VariablesLabeller stateVariables, controlVariables;
+
+    std::string footName;
+    double frictionCoefficient;
+
+    std::vector<Eigen::Index> forceOffsets;
+
+    Eigen::Matrix<double, 3, Eigen::Dynamic> forces; //one column per point
+    Eigen::Array3d coefficients; //the Jacobian of each row is coefficients * force, the Hessian is diagonal with these coefficients
+
+    iDynTree::optimalcontrol::SparsityStructure stateJacobianSparsity, controlJacobianSparsity;
+    iDynTree::optimalcontrol::SparsityStructure stateHessianSparsity, controlHessianSparsity, mixedHessianSparsity;
+
+    void updateCoefficients() {
+        double squaredFriction = frictionCoefficient * frictionCoefficient;
+        coefficients << 2.0, 2.0, -2.0 * squaredFriction;
+    }
+
+    void gatherForces(const iDynTree::VectorDynSize &state) {
+        iDynTree::iDynTreeEigenConstVector stateMap = iDynTree::toEigen(state);
+        for (size_t i = 0; i < forceOffsets.size(); ++i) {
+            forces.col(static_cast<Eigen::Index>(i)) = stateMap.segment<3>(forceOffsets[i]);
+        }
+    }
+};
+
+
+
+FootContactFrictionConstraints::FootContactFrictionConstraints(const VariablesLabeller &stateVariables, const VariablesLabeller &controlVariables,
+                                                               const FootRanges &footRanges, const std::string &footName)
+    : iDynTree::optimalcontrol::Constraint (footRanges.forcePoints.size(), "ContactFriction" + footName)
+    , m_pimpl(std::make_unique<Implementation>())
+{
+    m_pimpl->stateVariables = stateVariables;
+    m_pimpl->controlVariables = controlVariables;
+
+    m_pimpl->footName = footName;
+
+    m_pimpl->stateJacobianSparsity.clear();
+    m_pimpl->controlJacobianSparsity.clear();
+    m_pimpl->stateHessianSparsity.clear();
+
+    size_t numberOfPoints = footRanges.forcePoints.size();
+    m_pimpl->forceOffsets.resize(numberOfPoints);
+    m_pimpl->forces.resize(3, static_cast<Eigen::Index>(numberOfPoints));
+
+    for (size_t i = 0; i < numberOfPoints; ++i) {
+        const iDynTree::IndexRange& forcePointRange = footRanges.forcePoints[i];
+        assert(forcePointRange.isValid());
+
+        m_pimpl->forceOffsets[i] = forcePointRange.offset;
+
+        size_t fCol = static_cast<size_t>(forcePointRange.offset);
+
+        m_pimpl->stateJacobianSparsity.addDenseBlock(i, fCol, 1, 3);
+        m_pimpl->stateHessianSparsity.addIdentityBlock(fCol, fCol, 3);
+    }
+
+    m_pimpl->frictionCoefficient = 0.3;
+    m_pimpl->updateCoefficients();
+
+    m_isLowerBounded = false;
+    m_isUpperBounded = true;
+    m_upperBound.zero();
+
+    m_pimpl->controlHessianSparsity.clear();
+    m_pimpl->mixedHessianSparsity.clear();
+}
+
+FootContactFrictionConstraints::~FootContactFrictionConstraints()
+{ }
+
+bool FootContactFrictionConstraints::setFrictionCoefficient(double frictionCoefficient)
+{
+    if (frictionCoefficient <= 0.0)
+        return false;
+
+    m_pimpl->frictionCoefficient = frictionCoefficient;
+    m_pimpl->updateCoefficients();
+    return true;
+}
+
+bool FootContactFrictionConstraints::evaluateConstraint(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &, iDynTree::VectorDynSize &constraint)
+{
+    m_pimpl->gatherForces(state);
+
+    //fx^2 + fy^2 - mu^2 fz^2, for all the points at once
+    iDynTree::toEigen(constraint) = (0.5 * m_pimpl->coefficients.matrix().transpose() * m_pimpl->forces.cwiseAbs2()).transpose();
+
+    return true;
+
+}
+
+bool FootContactFrictionConstraints::constraintJacobianWRTState(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &, iDynTree::MatrixDynSize &jacobian)
+{
+    m_pimpl->gatherForces(state);
+
+    iDynTree::iDynTreeEigenMatrixMap jacobianMap = iDynTree::toEigen(jacobian);
+
+    for (size_t i = 0; i < m_pimpl->forceOffsets.size(); ++i) {
+        Eigen::Index row = static_cast<Eigen::Index>(i);
+        jacobianMap.block<1, 3>(row, m_pimpl->forceOffsets[i]) =
+            (m_pimpl->coefficients * m_pimpl->forces.col(row).array()).matrix().transpose();
+    }
+
+    return true;
+}
+
+bool FootContactFrictionConstraints::constraintJacobianWRTControl(double, const iDynTree::VectorDynSize &, const iDynTree::VectorDynSize &, iDynTree::MatrixDynSize &/*jacobian*/)
+{
+    return true;
+}
+
+size_t FootContactFrictionConstraints::expectedStateSpaceSize() const
+{
+    return m_pimpl->stateVariables.size();
+}
+
+size_t FootContactFrictionConstraints::expectedControlSpaceSize() const
+{
+    return m_pimpl->controlVariables.size();
+}
+
+bool FootContactFrictionConstraints::constraintJacobianWRTStateSparsity(iDynTree::optimalcontrol::SparsityStructure &stateSparsity)
+{
+    stateSparsity = m_pimpl->stateJacobianSparsity;
+    return true;
+}
+
+bool FootContactFrictionConstraints::constraintJacobianWRTControlSparsity(iDynTree::optimalcontrol::SparsityStructure &controlSparsity)
+{
+    controlSparsity = m_pimpl->controlJacobianSparsity;
+    return true;
+}
+
+bool FootContactFrictionConstraints::constraintSecondPartialDerivativeWRTState(double /*time*/, const iDynTree::VectorDynSize &/*state*/,
+                                                                               const iDynTree::VectorDynSize &/*control*/,
+                                                                               const iDynTree::VectorDynSize &lambda, iDynTree::MatrixDynSize &hessian)
+{
+    iDynTree::iDynTreeEigenMatrixMap hessianMap = iDynTree::toEigen(hessian);
+
+    for (size_t i = 0; i < m_pimpl->forceOffsets.size(); ++i) {
+        hessianMap.block<3, 3>(m_pimpl->forceOffsets[i], m_pimpl->forceOffsets[i]).diagonal() =
+            (lambda(static_cast<unsigned int>(i)) * m_pimpl->coefficients).matrix();
+    }
+
+    return true;
+}
+
+bool FootContactFrictionConstraints::constraintSecondPartialDerivativeWRTControl(double /*time*/, const iDynTree::VectorDynSize &/*state*/,
+                                                                                 const iDynTree::VectorDynSize &/*control*/,
+                                                                                 const iDynTree::VectorDynSize &/*lambda*/,
+                                                                                 iDynTree::MatrixDynSize &/*hessian*/)
+{
+    return true;
+}
+
+bool FootContactFrictionConstraints::constraintSecondPartialDerivativeWRTStateControl(double /*time*/, const iDynTree::VectorDynSize &/*state*/,
+                                                                                      const iDynTree::VectorDynSize &/*control*/,
+                                                                                      const iDynTree::VectorDynSize &/*lambda*/,
+                                                                                      iDynTree::MatrixDynSize &/*hessian*/)
+{
+    return true;
+}
+
+bool FootContactFrictionConstraints::constraintSecondPartialDerivativeWRTStateSparsity(iDynTree::optimalcontrol::SparsityStructure &stateSparsity)
+{
+    stateSparsity = m_pimpl->stateHessianSparsity;
+    return true;
+}
+
+bool FootContactFrictionConstraints::constraintSecondPartialDerivativeWRTStateControlSparsity(iDynTree::optimalcontrol::SparsityStructure &stateControlSparsity)
+{
+    stateControlSparsity = m_pimpl->mixedHessianSparsity;
+    return true;
+}
+
+bool FootContactFrictionConstraints::constraintSecondPartialDerivativeWRTControlSparsity(iDynTree::optimalcontrol::SparsityStructure &controlSparsity)
+{
+    controlSparsity = m_pimpl->controlHessianSparsity;
+    return true;
+}
@@ -36,6 +36,7 @@ public:
     levi::Expression asExpression, quaternionDerivative, jointsDerivative, baseQuaternionVelocityDerivative, jointsVelocityDerivative,
         quaternionHessian, jointsHessian, quaternionJointsHessian, quaternionQuaternionDerivativeHessian,
         quaternionJointsVelocityHessian, jointsQuaternionDerivativeHessian, jointsJointsVelocityHessian;
+    bool hessianExpressionsBuilt = false;
 
     std::shared_ptr<iDynTree::optimalcontrol::TimeVaryingRotation> desiredTrajectory;
 
@@ -78,6 +79,12 @@ public:
         jointsDerivative = (velocityError.transpose() * velocityError.getColumnDerivative(0, expressionsServer->jointsPosition())).transpose();
         baseQuaternionVelocityDerivative = (velocityError.transpose() * velocityError.getColumnDerivative(0, expressionsServer->baseQuaternionVelocity())).transpose();
         jointsVelocityDerivative = (velocityError.transpose() * velocityError.getColumnDerivative(0, expressionsServer->jointsVelocity())).transpose();
+    }
+
+    void buildHessianExpressions() { //The second derivatives are built only when first needed
+        if (hessianExpressionsBuilt) {
+            return;
+        }
 
         quaternionHessian = quaternionDerivative.getColumnDerivative(0, expressionsServer->baseQuaternion());
         jointsHessian = jointsDerivative.getColumnDerivative(0, expressionsServer->jointsPosition());
@@ -86,6 +93,8 @@ public:
         quaternionJointsVelocityHessian = quaternionDerivative.getColumnDerivative(0, expressionsServer->jointsVelocity());
         jointsQuaternionDerivativeHessian = jointsDerivative.getColumnDerivative(0, expressionsServer->baseQuaternionVelocity());
         jointsJointsVelocityHessian = jointsDerivative.getColumnDerivative(0, expressionsServer->jointsVelocity());
+
+        hessianExpressionsBuilt = true;
     }
 
 };
@@ -156,13 +165,15 @@ FrameAngularVelocityCost::~FrameAngularVelocityCost()
     m_pimpl->jointsDerivative.clearDerivativesCache();
     m_pimpl->baseQuaternionVelocityDerivative.clearDerivativesCache();
     m_pimpl->jointsVelocityDerivative.clearDerivativesCache();
-    m_pimpl->quaternionHessian.clearDerivativesCache();
-    m_pimpl->quaternionJointsHessian.clearDerivativesCache();
-    m_pimpl->jointsHessian.clearDerivativesCache();
-    m_pimpl->quaternionQuaternionDerivativeHessian.clearDerivativesCache();
-    m_pimpl->quaternionJointsVelocityHessian.clearDerivativesCache();
-    m_pimpl->jointsQuaternionDerivativeHessian.clearDerivativesCache();
-    m_pimpl->jointsJointsVelocityHessian.clearDerivativesCache();
+    if (m_pimpl->hessianExpressionsBuilt) {
+        m_pimpl->quaternionHessian.clearDerivativesCache();
+        m_pimpl->quaternionJointsHessian.clearDerivativesCache();
+        m_pimpl->jointsHessian.clearDerivativesCache();
+        m_pimpl->quaternionQuaternionDerivativeHessian.clearDerivativesCache();
+        m_pimpl->quaternionJointsVelocityHessian.clearDerivativesCache();
+        m_pimpl->jointsQuaternionDerivativeHessian.clearDerivativesCache();
+        m_pimpl->jointsJointsVelocityHessian.clearDerivativesCache();
+    }
 }
 
 bool FrameAngularVelocityCost::setDesiredRotationTrajectory(std::shared_ptr<iDynTree::optimalcontrol::TimeVaryingRotation> desiredRotationTrajectory)
@@ -269,6 +280,13 @@ bool FrameAngularVelocityCost::costSecondPartialDerivativeWRTState(double time,
                                                                    const iDynTree::VectorDynSize &control,
                                                                    iDynTree::MatrixDynSize &partialDerivative)
 {
+    if (!m_pimpl->expressionsServer->hessiansEnabled()) {
+        std::cerr << "[ERROR][FrameAngularVelocityCost::costSecondPartialDerivativeWRTState] The Hessians have been disabled." << std::endl;
+        return false;
+    }
+
+    m_pimpl->buildHessianExpressions();
+
     m_pimpl->stateVariables = state;
     m_pimpl->controlVariables = control;
 
@@ -315,6 +333,13 @@ bool FrameAngularVelocityCost::costSecondPartialDerivativeWRTStateControl(double
                                                                           const iDynTree::VectorDynSize &control,
                                                                           iDynTree::MatrixDynSize &partialDerivative)
 {
+    if (!m_pimpl->expressionsServer->hessiansEnabled()) {
+        std::cerr << "[ERROR][FrameAngularVelocityCost::costSecondPartialDerivativeWRTStateControl] The Hessians have been disabled." << std::endl;
+        return false;
+    }
+
+    m_pimpl->buildHessianExpressions();
+
     m_pimpl->stateVariables = state;
     m_pimpl->controlVariables = control;
 
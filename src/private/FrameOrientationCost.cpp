@@ -9,7 +9,6 @@
 #include <iDynTree/Core/EigenHelpers.h>
 #include <DynamicalPlannerPrivate/Costs/FrameOrientationCost.h>
 #include <DynamicalPlannerPrivate/Utilities/QuaternionUtils.h>
-#include <DynamicalPlannerPrivate/Utilities/CheckEqualVector.h>
 #include <cassert>
 #include <iostream>
 
@@ -37,19 +36,35 @@ public:
     levi::Expression quaternionErrorExpression,
         asExpression, quaternionDerivative, jointsDerivative,
         quaternionHessian, jointsHessian, quaternionJointsHessian;
+    bool hessianExpressionsBuilt = false;
     levi::Variable desiredQuaternion;
 
     std::shared_ptr<iDynTree::optimalcontrol::TimeVaryingRotation> desiredTrajectory;
 
-    bool updateDoneOnceCost = false;
-    bool updateDoneOnceStateJacobian = false;
-    double lastUpdateTimeCost = -1;
-    double lastUpdateTimeStateJacobian = -1;
+    uint64_t costVersion = 0; //versions of the robot state used to compute the cached values
+    uint64_t stateJacobianVersion = 0;
+    double costTime = 0.0, stateJacobianTime = 0.0; //the desired rotation depends on the time
     double costBuffer;
-    double tolerance;
 
     iDynTree::optimalcontrol::SparsityStructure stateHessianSparsity, controlHessianSparsity, mixedHessianSparsity;
 
+    void buildHessianExpressions() { //The second derivatives are built only when first needed
+        if (hessianExpressionsBuilt) {
+            return;
+        }
+
+        std::string desiredFrameName = timedSharedKinDyn->model().getFrameName(desiredFrame);
+
+        quaternionHessian = expressionsServer->flatten(quaternionDerivative.getColumnDerivative(0, expressionsServer->baseQuaternion()),
+                                                       desiredFrameName + "_orientationQuaternionHessian");
+        jointsHessian = expressionsServer->flatten(jointsDerivative.getColumnDerivative(0, expressionsServer->jointsPosition()),
+                                                   desiredFrameName + "_orientationJointsHessian");
+        quaternionJointsHessian = expressionsServer->flatten(quaternionDerivative.getColumnDerivative(0, expressionsServer->jointsPosition()),
+                                                             desiredFrameName + "_orientationQuaternionJointsHessian");
+
+        hessianExpressionsBuilt = true;
+    }
+
     void updateRobotState() {
 
         robotState = sharedKinDyn->currentState();
@@ -68,13 +83,11 @@ public:
 
     }
 
-    bool sameVariables(bool updateDoneOnce, double newTime, double lastUpdateTime) {
-        bool same = updateDoneOnce;
-        same = same && iDynTree::checkDoublesAreEqual(lastUpdateTime, newTime, tolerance);
-        same = same && VectorsAreEqual(basePosition, stateVariables(basePositionRange), tolerance);
-        same = same && VectorsAreEqual(baseQuaternion, stateVariables(baseQuaternionRange), tolerance);
-        same = same && VectorsAreEqual(robotState.s, stateVariables(jointsPositionRange), tolerance);
-
+    bool sameVariables(uint64_t& lastVersion, double& lastTime, double newTime) { //Updates the robot state. True if its version and the time are those used to compute the cached values.
+        updateRobotState();
+        bool same = (robotState.version.value() != 0) && (robotState.version.value() == lastVersion) && (newTime == lastTime);
+        lastVersion = robotState.version.value();
+        lastTime = newTime;
         return same;
     }
 
@@ -134,10 +147,6 @@ FrameOrientationCost::FrameOrientationCost(const VariablesLabeller &stateVariabl
     m_pimpl->quaternionDerivative = (quaternionDifference.transpose() * quaternionDifference.getColumnDerivative(0, m_pimpl->expressionsServer->baseQuaternion())).transpose();
     m_pimpl->jointsDerivative = (quaternionDifference.transpose() * quaternionDifference.getColumnDerivative(0, m_pimpl->expressionsServer->jointsPosition())).transpose();
 
-    m_pimpl->quaternionHessian = m_pimpl->quaternionDerivative.getColumnDerivative(0, m_pimpl->expressionsServer->baseQuaternion());
-    m_pimpl->jointsHessian = m_pimpl->jointsDerivative.getColumnDerivative(0, m_pimpl->expressionsServer->jointsPosition());
-    m_pimpl->quaternionJointsHessian = m_pimpl->quaternionDerivative.getColumnDerivative(0, m_pimpl->expressionsServer->jointsPosition());
-
     m_pimpl->stateHessianSparsity.addDenseBlock(m_pimpl->baseQuaternionRange, m_pimpl->baseQuaternionRange);
     m_pimpl->stateHessianSparsity.addDenseBlock(m_pimpl->baseQuaternionRange, m_pimpl->jointsPositionRange);
     m_pimpl->stateHessianSparsity.addDenseBlock(m_pimpl->jointsPositionRange, m_pimpl->baseQuaternionRange);
@@ -152,14 +161,18 @@ FrameOrientationCost::~FrameOrientationCost()
 {
     m_pimpl->quaternionDerivative.clearDerivativesCache();
     m_pimpl->jointsDerivative.clearDerivativesCache();
-    m_pimpl->quaternionHessian.clearDerivativesCache();
-    m_pimpl->quaternionJointsHessian.clearDerivativesCache();
-    m_pimpl->jointsHessian.clearDerivativesCache();
+    if (m_pimpl->hessianExpressionsBuilt) {
+        m_pimpl->quaternionHessian.clearDerivativesCache();
+        m_pimpl->quaternionJointsHessian.clearDerivativesCache();
+        m_pimpl->jointsHessian.clearDerivativesCache();
+    }
 }
 
 void FrameOrientationCost::setDesiredRotation(const iDynTree::Rotation &desiredRotation)
 {
     m_pimpl->desiredTrajectory = std::make_shared<iDynTree::optimalcontrol::TimeInvariantRotation>(desiredRotation);
+    m_pimpl->costVersion = 0;
+    m_pimpl->stateJacobianVersion = 0;
 }
 
 bool FrameOrientationCost::setDesiredRotationTrajectory(std::shared_ptr<iDynTree::optimalcontrol::TimeVaryingRotation> desiredRotationTrajectory)
@@ -167,6 +180,8 @@ bool FrameOrientationCost::setDesiredRotationTrajectory(std::shared_ptr<iDynTree
     if (!desiredRotationTrajectory)
         return false;
     m_pimpl->desiredTrajectory = desiredRotationTrajectory;
+    m_pimpl->costVersion = 0;
+    m_pimpl->stateJacobianVersion = 0;
     return true;
 }
 
@@ -177,11 +192,7 @@ bool FrameOrientationCost::costEvaluation(double time, const iDynTree::VectorDyn
     m_pimpl->controlVariables = control;
     m_pimpl->sharedKinDyn = m_pimpl->timedSharedKinDyn->get(time);
 
-    if (!(m_pimpl->sameVariables(m_pimpl->updateDoneOnceCost, time, m_pimpl->lastUpdateTimeCost))) {
-
-//        m_pimpl->updateDoneOnceCost = true;
-        m_pimpl->lastUpdateTimeCost = time;
-        m_pimpl->updateRobotState();
+    if (!(m_pimpl->sameVariables(m_pimpl->costVersion, m_pimpl->costTime, time))) {
 
         bool isValid = false;
         const iDynTree::Rotation& desiredRotation = m_pimpl->desiredTrajectory->get(time, isValid);
@@ -189,6 +200,7 @@ bool FrameOrientationCost::costEvaluation(double time, const iDynTree::VectorDyn
         if (!isValid) {
             std::cerr << "[ERROR][FrameOrientationCost::costEvaluation] Unable to retrieve a valid rotation at time " << time
                       << "." << std::endl;
+            m_pimpl->costVersion = 0;
             return false;
         }
 
@@ -213,11 +225,7 @@ bool FrameOrientationCost::costFirstPartialDerivativeWRTState(double time, const
     m_pimpl->controlVariables = control;
     m_pimpl->sharedKinDyn = m_pimpl->timedSharedKinDyn->get(time);
 
-    if (!(m_pimpl->sameVariables(m_pimpl->updateDoneOnceStateJacobian, time, m_pimpl->lastUpdateTimeStateJacobian))) {
-
-//        m_pimpl->updateDoneOnceStateJacobian = true;
-        m_pimpl->lastUpdateTimeStateJacobian = time;
-        m_pimpl->updateRobotState();
+    if (!(m_pimpl->sameVariables(m_pimpl->stateJacobianVersion, m_pimpl->stateJacobianTime, time))) {
 
         bool isValid = false;
         const iDynTree::Rotation& desiredRotation = m_pimpl->desiredTrajectory->get(time, isValid);
@@ -225,6 +233,7 @@ bool FrameOrientationCost::costFirstPartialDerivativeWRTState(double time, const
         if (!isValid) {
             std::cerr << "[ERROR][FrameOrientationCost::costFirstPartialDerivativeWRTState] Unable to retrieve a valid rotation at time " << time
                       << "." << std::endl;
+            m_pimpl->stateJacobianVersion = 0;
             return false;
         }
 
@@ -284,6 +293,13 @@ bool FrameOrientationCost::costFirstPartialDerivativeWRTControl(double /*time*/,
 
 bool FrameOrientationCost::costSecondPartialDerivativeWRTState(double time, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::MatrixDynSize &partialDerivative)
 {
+    if (!m_pimpl->expressionsServer->hessiansEnabled()) {
+        std::cerr << "[ERROR][FrameOrientationCost::costSecondPartialDerivativeWRTState] The Hessians have been disabled." << std::endl;
+        return false;
+    }
+
+    m_pimpl->buildHessianExpressions();
+
     m_pimpl->stateVariables = state;
     m_pimpl->controlVariables = control;
 
@@ -164,7 +164,7 @@ public:
             linkPtr = model.getLink(l);
             visitedLink = l;
 
-            levi::Expression linkMomentum = expressionsServer->linkInertia(l) * expressionsServer->absoluteVelocity(model.getLinkName(l), baseTwist);
+            levi::Expression linkMomentum = expressionsServer->linkInertia(l) * expressionsServer->absoluteVelocity(l, baseTwist);
 
             while(visitedLink != baseLink) {
                 jointPtr = traversal.getParentJointFromLinkIndex(visitedLink);
@@ -177,18 +177,18 @@ public:
 
                 if (!jointInfo.motionVectorTimesChildVelocity.isValidExpression()) {
                     jointInfo.motionVectorTimesChildVelocity = expressionsServer->motionSubSpaceAsCrossProduct(jointPtr->getIndex(), parentLink, childLink) *
-                        expressionsServer->absoluteVelocity(model.getLinkName(childLink), baseTwist);
+                        expressionsServer->absoluteVelocity(childLink, baseTwist);
 
                     jointInfo.adjointWrenchTimesMotionVector = expressionsServer->adjointTransformWrench(baseFrame, model.getLinkName(childLink)) *
                         expressionsServer->motionSubSpaceAsCrossProductWrench(jointPtr->getIndex(), parentLink, childLink);
                 }
 
                 levi::Expression adjointWrenchDerivative = jointInfo.adjointWrenchTimesMotionVector *
-                    expressionsServer->adjointTransformWrench(model.getLinkName(childLink), model.getLinkName(l)) *
+                    expressionsServer->adjointTransformWrench(childLink, l) *
                     linkMomentum;
 
                 levi::Expression velocityDerivative = expressionsServer->linkInertiaInBase(l) *
-                    expressionsServer->adjointTransform(model.getLinkName(l), model.getLinkName(childLink)) *
+                    expressionsServer->adjointTransform(l, childLink) *
                     jointInfo.motionVectorTimesChildVelocity;
 
                 m_cols[jointIndex] = m_cols[jointIndex] + adjointWrenchDerivative - velocityDerivative;
@@ -353,7 +353,7 @@ public:
                 parentLink = traversal.getParentLinkIndexFromJointIndex(model, jointPtr->getIndex());
 
                 m_cols[jointIndex] = m_cols[jointIndex] + expressionsServer->linkInertiaInBase(l) *
-                        expressionsServer->adjointTransform(model.getLinkName(l), model.getLinkName(childLink)) *
+                        expressionsServer->adjointTransform(l, childLink) *
                         expressionsServer->motionSubSpaceVector(jointPtr->getIndex(), parentLink, childLink);
 
                 visitedLink = traversal.getParentLinkFromLinkIndex(visitedLink)->getIndex();
@@ -586,7 +586,7 @@ public:
                         es->motionSubSpaceAsCrossProduct(static_cast<iDynTree::JointIndex>(column), columnParent, columnChild) *
                         es->adjointTransform(columnChildName, model.getLinkName(l));
 
-                    levi::Expression linkVel = es->absoluteVelocity(model.getLinkName(l), baseTwist);
+                    levi::Expression linkVel = es->absoluteVelocity(l, baseTwist);
 
                     thisColumnExpressedInC = thisColumnExpressedInC + thisSWrench * inertiaInC * linkVel +
                         inertiaInC * linkVel.getColumnDerivative(0, es->jointsPosition()).col(column);
@@ -82,11 +82,11 @@ NormalVelocityControlConstraints::~NormalVelocityControlConstraints()
 
 bool NormalVelocityControlConstraints::evaluateConstraint(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::VectorDynSize &constraint)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
+    VariablesLabeller::ScopedWrap controlVariables(m_pimpl->controlVariables, control);
 
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
-    m_pimpl->pointVelocityControl = m_pimpl->controlVariables(m_pimpl->velocityControlRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointVelocityControl = controlVariables(m_pimpl->velocityControlRange);
     double deltaZ = m_pimpl->normalVelocityActivation.eval(m_pimpl->pointPosition(2));
 
     iDynTree::iDynTreeEigenVector constraintMap = iDynTree::toEigen(m_pimpl->constraintValues);
@@ -102,11 +102,11 @@ bool NormalVelocityControlConstraints::evaluateConstraint(double, const iDynTree
 
 bool NormalVelocityControlConstraints::constraintJacobianWRTState(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::MatrixDynSize &jacobian)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
+    VariablesLabeller::ScopedWrap controlVariables(m_pimpl->controlVariables, control);
 
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
-    m_pimpl->pointVelocityControl = m_pimpl->controlVariables(m_pimpl->velocityControlRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointVelocityControl = controlVariables(m_pimpl->velocityControlRange);
     double deltaZDerivative =  m_pimpl->normalVelocityActivation.evalDerivative(m_pimpl->pointPosition(2));
 
     unsigned int pzIndex = static_cast<unsigned int>(m_pimpl->positionPointRange.offset + 2);
@@ -119,11 +119,8 @@ bool NormalVelocityControlConstraints::constraintJacobianWRTState(double, const
 
 }
 
-bool NormalVelocityControlConstraints::constraintJacobianWRTControl(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::MatrixDynSize &jacobian)
+bool NormalVelocityControlConstraints::constraintJacobianWRTControl(double, const iDynTree::VectorDynSize &/*state*/, const iDynTree::VectorDynSize &/*control*/, iDynTree::MatrixDynSize &jacobian)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
-
     unsigned int velocityIndex = static_cast<unsigned int>(m_pimpl->velocityControlRange.offset + 2);
 
     m_pimpl->controlJacobianBuffer(0, velocityIndex) = -1.0;
@@ -161,10 +158,10 @@ bool NormalVelocityControlConstraints::constraintSecondPartialDerivativeWRTState
                                                                                  const iDynTree::VectorDynSize &lambda,
                                                                                  iDynTree::MatrixDynSize &hessian)
 {
-    m_pimpl->stateVariables = state;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
 
     unsigned int pzIndex = static_cast<unsigned int>(m_pimpl->positionPointRange.offset + 2);
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
     double deltaDoubleDerivative = m_pimpl->normalVelocityActivation.evalDoubleDerivative(m_pimpl->pointPosition(2));
 
     hessian(pzIndex, pzIndex) = (lambda(1)) * deltaDoubleDerivative * m_pimpl->maximumDerivative;
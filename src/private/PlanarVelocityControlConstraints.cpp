@@ -89,12 +89,12 @@ PlanarVelocityControlConstraints::~PlanarVelocityControlConstraints()
 
 bool PlanarVelocityControlConstraints::evaluateConstraint(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::VectorDynSize &constraint)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
+    VariablesLabeller::ScopedWrap controlVariables(m_pimpl->controlVariables, control);
 
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
-    m_pimpl->pointForce = m_pimpl->stateVariables(m_pimpl->forcePointRange);
-    m_pimpl->pointVelocityControl = m_pimpl->controlVariables(m_pimpl->velocityControlRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointForce = stateVariables(m_pimpl->forcePointRange);
+    m_pimpl->pointVelocityControl = controlVariables(m_pimpl->velocityControlRange);
     double deltaXY = m_pimpl->planarVelocityActivation.eval(m_pimpl->pointPosition(2));
 
     iDynTree::iDynTreeEigenVector constraintMap = iDynTree::toEigen(m_pimpl->constraintValues);
@@ -110,12 +110,12 @@ bool PlanarVelocityControlConstraints::evaluateConstraint(double, const iDynTree
 
 bool PlanarVelocityControlConstraints::constraintJacobianWRTState(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::MatrixDynSize &jacobian)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
+    VariablesLabeller::ScopedWrap controlVariables(m_pimpl->controlVariables, control);
 
-    m_pimpl->pointPosition = m_pimpl->stateVariables(m_pimpl->positionPointRange);
-    m_pimpl->pointForce = m_pimpl->stateVariables(m_pimpl->forcePointRange);
-    m_pimpl->pointVelocityControl = m_pimpl->controlVariables(m_pimpl->velocityControlRange);
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
+    m_pimpl->pointForce = stateVariables(m_pimpl->forcePointRange);
+    m_pimpl->pointVelocityControl = controlVariables(m_pimpl->velocityControlRange);
     double deltaXYDerivative = m_pimpl->planarVelocityActivation.evalDerivative(m_pimpl->pointPosition(2));
 
     iDynTree::iDynTreeEigenMatrixMap jacobianMap = iDynTree::toEigen(m_pimpl->stateJacobianBuffer);
@@ -130,11 +130,8 @@ bool PlanarVelocityControlConstraints::constraintJacobianWRTState(double, const
 
 }
 
-bool PlanarVelocityControlConstraints::constraintJacobianWRTControl(double, const iDynTree::VectorDynSize &state, const iDynTree::VectorDynSize &control, iDynTree::MatrixDynSize &jacobian)
+bool PlanarVelocityControlConstraints::constraintJacobianWRTControl(double, const iDynTree::VectorDynSize &/*state*/, const iDynTree::VectorDynSize &/*control*/, iDynTree::MatrixDynSize &jacobian)
 {
-    m_pimpl->stateVariables = state;
-    m_pimpl->controlVariables = control;
-
     iDynTree::toEigen(m_pimpl->controlJacobianBuffer).block<2,2>(0, m_pimpl->velocityControlRange.offset).setIdentity();
     iDynTree::toEigen(m_pimpl->controlJacobianBuffer).block<2,2>(0, m_pimpl->velocityControlRange.offset) *= -1;
 
@@ -167,11 +164,13 @@ bool PlanarVelocityControlConstraints::constraintJacobianWRTControlSparsity(iDyn
 }
 
 bool PlanarVelocityControlConstraints::constraintSecondPartialDerivativeWRTState(double /*time*/, const iDynTree::VectorDynSize &state,
-                                                                                 const iDynTree::VectorDynSize &control,
+                                                                                 const iDynTree::VectorDynSize &/*control*/,
                                                                                  const iDynTree::VectorDynSize &lambda,
                                                                                  iDynTree::MatrixDynSize &hessian)
 {
-    m_pimpl->stateVariables = state;
+    VariablesLabeller::ScopedWrap stateVariables(m_pimpl->stateVariables, state);
+
+    m_pimpl->pointPosition = stateVariables(m_pimpl->positionPointRange);
 
     unsigned int positionIndex = static_cast<unsigned int>(m_pimpl->positionPointRange.offset + 2);
     double deltaDoubleDerivative = m_pimpl->planarVelocityActivation.evalDoubleDerivative(m_pimpl->pointPosition(2));
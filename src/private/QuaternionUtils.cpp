@@ -7,6 +7,7 @@
 
 #include <DynamicalPlannerPrivate/Utilities/QuaternionUtils.h>
 #include <iDynTree/Core/EigenHelpers.h>
+#include <cassert>
 
 iDynTree::MatrixFixSize<4, 3> DynamicalPlanner::Private::QuaternionLeftTrivializedDerivative(const iDynTree::Vector4 &quaternion)
 {
@@ -42,6 +43,19 @@ iDynTree::Vector4 DynamicalPlanner::Private::NormalizedQuaternion(const iDynTree
     return normalized;
 }
 
+void DynamicalPlanner::Private::NormalizedQuaternionOrIdentity(iDynTree::Span<const double> quaternion, iDynTree::Vector4 &normalized)
+{
+    assert(quaternion.size() == 4);
+    double norm = iDynTree::toEigen(quaternion).norm();
+
+    if (norm > 0.0) {
+        iDynTree::toEigen(normalized) = iDynTree::toEigen(quaternion) / norm;
+    } else {
+        normalized.zero();
+        normalized(0) = 1.0;
+    }
+}
+
 double DynamicalPlanner::Private::QuaternionNorm(const iDynTree::Vector4 &quaternion)
 {
     return iDynTree::toEigen(quaternion).norm();
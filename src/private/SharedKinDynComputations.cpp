@@ -12,41 +12,121 @@
 #include <DynamicalPlannerPrivate/Utilities/CheckEqualVector.h>
 #include <DynamicalPlannerPrivate/Utilities/QuaternionUtils.h>
 #include <iDynTree/Core/EigenHelpers.h>
+#include <atomic>
 #include <cassert>
+#include <unordered_map>
 
 using namespace DynamicalPlanner::Private;
 
+static std::atomic<uint64_t> LastStateVersion(0);
+
+//Immutable data depending only on the model and on the floating base. It is shared among the copies (one for each knot).
+//The traversal and the joint pointers refer to the model stored here, so this object is never copied once built.
+class SharedKinDynComputations::ModelData {
+public:
+    iDynTree::Model model;
+    iDynTree::Traversal traversal;
+    iDynTree::LinkIndex baseIndex;
+    std::vector<JointInfos> jointsTopology; //only jointPtr, childIndex and parentIndex are filled
+    std::vector<iDynTree::SpatialForceVector> zeroDerivatives;
+    std::vector<iDynTree::SpatialMotionVector> motionSubspaces; //one per joint, expressed in the child link. It does not depend on the joint position
+    std::vector<iDynTree::SpatialInertia> linkInertias;
+
+    ModelData(const iDynTree::Model& inputModel)
+        : model(inputModel)
+        , baseIndex(iDynTree::LINK_INVALID_INDEX)
+    { }
+
+    ModelData(const ModelData& other) = delete;
+
+    bool setFloatingBase(iDynTree::LinkIndex newBase) {
+        if (!model.isValidLinkIndex(newBase)) {
+            return false;
+        }
+
+        if (!model.computeFullTreeTraversal(traversal, newBase)) {
+            return false;
+        }
+
+        baseIndex = newBase;
+
+        jointsTopology.resize(model.getNrOfDOFs());
+        motionSubspaces.resize(model.getNrOfDOFs());
+        for (size_t j = 0; j < jointsTopology.size(); ++j) {
+            iDynTree::JointIndex jointIndex = static_cast<iDynTree::JointIndex>(j);
+            assert(model.isValidJointIndex(jointIndex));
+            jointsTopology[j].jointPtr = model.getJoint(jointIndex);
+            assert(jointsTopology[j].jointPtr->getNrOfDOFs() == 1);
+            jointsTopology[j].childIndex =  traversal.getChildLinkIndexFromJointIndex(model, jointIndex);
+            jointsTopology[j].parentIndex =  traversal.getParentLinkIndexFromJointIndex(model, jointIndex);
+            motionSubspaces[j] = jointsTopology[j].jointPtr->getMotionSubspaceVector(0, jointsTopology[j].childIndex, jointsTopology[j].parentIndex);
+        }
+
+        linkInertias.resize(model.getNrOfLinks());
+        for (size_t l = 0; l < linkInertias.size(); ++l) {
+            linkInertias[l] = model.getLink(static_cast<iDynTree::LinkIndex>(l))->getInertia();
+        }
+
+        zeroDerivatives.resize(model.getNrOfDOFs(), iDynTree::SpatialForceVector::Zero());
+
+        return true;
+    }
+};
+
 class SharedKinDynComputations::Data {
 public:
     iDynTree::KinDynComputations kinDyn;
+    std::shared_ptr<const ModelData> shared;
     std::mutex mutex;
     RobotState state;
+    uint64_t stateVersion = 0; //Version of state, 0 until the first update
     iDynTree::Vector3 gravity;
     std::vector<JointInfos> jointsInfos;
     iDynTree::LinkWrenches linkStaticWrenches;
-    iDynTree::Traversal traversal;
     iDynTree::FreeFloatingAcc invDynGeneralizedProperAccs;
     iDynTree::Vector3 gravityAccInBaseLinkFrame;
     iDynTree::FreeFloatingPos pos;
     iDynTree::FreeFloatingVel invDynZeroVel;
     iDynTree::LinkVelArray invDynZeroLinkVel;
     iDynTree::LinkProperAccArray invDynLinkProperAccs;
+    bool properAccsValid; //invDynLinkProperAccs are consistent with pos.jointPos() and properAccsGravity
+    iDynTree::Vector3 properAccsGravity;
+    std::vector<bool> dirtyLinks;
     iDynTree::FreeFloatingGeneralizedTorques generalizedStaticTorques;
     std::vector<std::vector<iDynTree::SpatialForceVector>> childrenForceDerivatives;
-    std::vector<iDynTree::SpatialForceVector> zeroDerivatives;
     iDynTree::Transform baseTransform;
     iDynTree::Rotation baseRotation;
     iDynTree::Position basePosition;
     iDynTree::Vector4 quaternionNormalized;
 
+    //Frame Jacobians depend only on the positions. They are computed once per positions version and shared by all the callers.
+    class CachedJacobian {
+    public:
+        uint64_t version = 0;
+        iDynTree::MatrixDynSize jacobian;
+    };
+    uint64_t positionsVersion = 0;
+    std::unordered_map<size_t, CachedJacobian> frameJacobians, relativeJacobians;
+
     bool updateNecessary;
     double tol;
+
+    size_t jacobianKey(size_t frameKey, iDynTree::FrameVelocityRepresentation trivialization) const {
+        return frameKey * 3 + static_cast<size_t>(trivialization);
+    }
 };
 
 bool SharedKinDynComputations::sameStatePrivate(const RobotState &other) const
 {
-    if (!(m_data->updateNecessary)
-            && VectorsAreEqual(other.base_position, m_data->state.base_position, m_data->tol)
+    if (m_data->updateNecessary) {
+        return false;
+    }
+
+    if ((other.version.value() != 0) && (other.version.value() == m_data->stateVersion)) {
+        return true;
+    }
+
+    if (VectorsAreEqual(other.base_position, m_data->state.base_position, m_data->tol)
             && VectorsAreEqual(other.base_quaternion, m_data->state.base_quaternion, m_data->tol)
             && VectorsAreEqual(other.s, m_data->state.s, m_data->tol)
             && VectorsAreEqual(other.base_linearVelocity, m_data->state.base_linearVelocity, m_data->tol)
@@ -61,6 +141,11 @@ bool SharedKinDynComputations::updateRobotStatePrivate(const RobotState &current
 {
     if (!sameStatePrivate(currentState)) {
 
+        bool samePositions = !m_data->updateNecessary
+                && VectorsAreEqual(currentState.base_position, m_data->state.base_position, m_data->tol)
+                && VectorsAreEqual(currentState.base_quaternion, m_data->state.base_quaternion, m_data->tol)
+                && VectorsAreEqual(currentState.s, m_data->state.s, m_data->tol);
+
         iDynTree::toEigen(m_data->quaternionNormalized) = iDynTree::toEigen(currentState.base_quaternion).normalized();
 
         m_data->baseRotation.fromQuaternion(m_data->quaternionNormalized);
@@ -81,21 +166,24 @@ bool SharedKinDynComputations::updateRobotStatePrivate(const RobotState &current
         }
         m_data->updateNecessary = false;
         m_data->state = currentState;
+        m_data->stateVersion = ++LastStateVersion;
+
+        if (!samePositions) {
+            m_data->positionsVersion++; //invalidates the cached Jacobians
+        }
     }
     return true;
 }
 
 void SharedKinDynComputations::fillJointsInfo()
 {
-    const iDynTree::Model& model = m_data->kinDyn.model();
-    m_data->childrenForceDerivatives.resize(model.getNrOfLinks());
+    const ModelData& shared = *(m_data->shared);
+    m_data->jointsInfos.resize(shared.jointsTopology.size());
+    m_data->childrenForceDerivatives.resize(shared.model.getNrOfLinks());
     for (size_t j = 0; j < m_data->jointsInfos.size(); ++j) {
-        iDynTree::JointIndex jointIndex = static_cast<iDynTree::JointIndex>(j);
-        assert(model.isValidJointIndex(jointIndex));
-        m_data->jointsInfos[j].jointPtr = model.getJoint(jointIndex);
-        assert(m_data->jointsInfos[j].jointPtr->getNrOfDOFs() == 1);
-        m_data->jointsInfos[j].childIndex =  m_data->traversal.getChildLinkIndexFromJointIndex(model, jointIndex);
-        m_data->jointsInfos[j].parentIndex =  m_data->traversal.getParentLinkIndexFromJointIndex(model, jointIndex);
+        m_data->jointsInfos[j].jointPtr = shared.jointsTopology[j].jointPtr;
+        m_data->jointsInfos[j].childIndex = shared.jointsTopology[j].childIndex;
+        m_data->jointsInfos[j].parentIndex = shared.jointsTopology[j].parentIndex;
         size_t childIndex = static_cast<size_t>(m_data->jointsInfos[j].childIndex);
         m_data->childrenForceDerivatives[childIndex].resize(m_data->jointsInfos.size(), iDynTree::SpatialForceVector::Zero());
     }
@@ -103,14 +191,12 @@ void SharedKinDynComputations::fillJointsInfo()
 
 void SharedKinDynComputations::updateChildBuffersForMomentumDerivative()
 {
-    iDynTree::LinkIndex baseIndex = m_data->kinDyn.model().getLinkIndex(m_data->kinDyn.getFloatingBase());
+    iDynTree::LinkIndex baseIndex = m_data->shared->baseIndex;
     assert(baseIndex != iDynTree::LINK_INVALID_INDEX);
 
     for (size_t j = 0; j < m_data->jointsInfos.size(); ++j) {
 
-        m_data->jointsInfos[j].motionVectorTimesChildVelocity = m_data->jointsInfos[j].jointPtr->getMotionSubspaceVector(0,
-                                                                                                m_data->jointsInfos[j].childIndex,
-                                                                                                m_data->jointsInfos[j].parentIndex).cross(
+        m_data->jointsInfos[j].motionVectorTimesChildVelocity = m_data->shared->motionSubspaces[j].cross(
                     -m_data->kinDyn.getFrameVel(m_data->jointsInfos[j].childIndex));
 
         m_data->jointsInfos[j].childVelocity = m_data->kinDyn.getFrameVel(m_data->jointsInfos[j].childIndex);
@@ -122,27 +208,59 @@ void SharedKinDynComputations::updateChildBuffersForMomentumDerivative()
 void SharedKinDynComputations::computeChildStaticForceDerivative(const iDynTree::LinkWrenches &linkStaticForces)
 {
 
-    iDynTree::LinkIndex childLink, parentLink;
+    iDynTree::LinkIndex childLink;
     size_t childIndex;
     for (size_t j = 0; j < m_data->jointsInfos.size(); ++j) {
 
         childLink = m_data->jointsInfos[j].childIndex;
-        parentLink = m_data->jointsInfos[j].parentIndex;
 
         JointInfos& jInfo = m_data->jointsInfos[j];
 
-        jInfo.childStaticForceDerivative = jInfo.jointPtr->getMotionSubspaceVector(0,
-                                                                                   childLink,
-                                                                                   parentLink).cross(
-                    linkStaticForces(childLink));
+        const iDynTree::SpatialMotionVector& motionSubspace = m_data->shared->motionSubspaces[j];
+
+        jInfo.childStaticForceDerivative = motionSubspace.cross(linkStaticForces(childLink));
 
-        jInfo.motionVectorTimesChildAcceleration = jInfo.jointPtr->getMotionSubspaceVector(0,
-                                                                                           childLink,
-                                                                                           parentLink).cross(
-                    m_data->invDynLinkProperAccs(childLink));
+        jInfo.motionVectorTimesChildAcceleration = motionSubspace.cross(m_data->invDynLinkProperAccs(childLink));
 
         childIndex = static_cast<size_t>(childLink);
-        m_data->childrenForceDerivatives[childIndex] = m_data->zeroDerivatives;
+        m_data->childrenForceDerivatives[childIndex] = m_data->shared->zeroDerivatives;
+    }
+}
+
+void SharedKinDynComputations::updateDirtyProperAccelerations(const iDynTree::VectorDynSize &jointsPosition)
+{
+    const iDynTree::Traversal& traversal = m_data->shared->traversal;
+    iDynTree::JointPosDoubleArray& cachedPosition = m_data->pos.jointPos();
+
+    //The traversal visits the parents before the children, so a link is dirty if its parent joint moved or if its parent is dirty
+    for (unsigned int el = 0; el < traversal.getNrOfVisitedLinks(); ++el) {
+        iDynTree::LinkIndex visitedLink = traversal.getLink(el)->getIndex();
+        size_t visitedIndex = static_cast<size_t>(visitedLink);
+        iDynTree::LinkConstPtr parentLink = traversal.getParentLink(el);
+
+        if (!parentLink) {
+            m_data->dirtyLinks[visitedIndex] = false; //the base acceleration depends only on the gravity
+            continue;
+        }
+
+        iDynTree::IJointConstPtr parentJoint = traversal.getParentJoint(el);
+        bool dirty = m_data->dirtyLinks[static_cast<size_t>(parentLink->getIndex())];
+
+        for (unsigned int dof = 0; dof < parentJoint->getNrOfDOFs(); ++dof) {
+            unsigned int dofIndex = static_cast<unsigned int>(parentJoint->getDOFsOffset()) + dof;
+            if (cachedPosition(dofIndex) != jointsPosition(dofIndex)) {
+                cachedPosition(dofIndex) = jointsPosition(dofIndex);
+                dirty = true;
+            }
+        }
+
+        m_data->dirtyLinks[visitedIndex] = dirty;
+
+        if (dirty) {
+            parentJoint->computeChildAcc(cachedPosition, m_data->invDynZeroVel.jointVel(), m_data->invDynZeroLinkVel,
+                                         m_data->invDynGeneralizedProperAccs.jointAcc(), m_data->invDynLinkProperAccs,
+                                         visitedLink, parentLink->getIndex());
+        }
     }
 }
 
@@ -168,19 +286,28 @@ bool SharedKinDynComputations::computeStaticForces(const RobotState &currentStat
     m_data->invDynGeneralizedProperAccs.jointAcc().zero();
 
     m_data->pos.worldBasePos() = baseTransform;
-    iDynTree::toEigen(m_data->pos.jointPos()) = iDynTree::toEigen(currentState.s);
+
+    bool ok = true;
 
     // Run inverse dynamics
-    bool ok = iDynTree::ForwardAccKinematics(m_data->kinDyn.model(),
-                                             m_data->traversal,
-                                             m_data->pos,
-                                             m_data->invDynZeroVel,
-                                             m_data->invDynGeneralizedProperAccs,
-                                             m_data->invDynZeroLinkVel,
-                                             m_data->invDynLinkProperAccs);
-
-    ok = ok && iDynTree::RNEADynamicPhase(m_data->kinDyn.model(),
-                                          m_data->traversal,
+    if (m_data->properAccsValid && (iDynTree::toEigen(m_data->properAccsGravity) == iDynTree::toEigen(m_data->gravityAccInBaseLinkFrame))) {
+        updateDirtyProperAccelerations(currentState.s); //With zero velocities, the accelerations depend only on the gravity in base frame and on the joints positions
+    } else {
+        iDynTree::toEigen(m_data->pos.jointPos()) = iDynTree::toEigen(currentState.s);
+
+        ok = iDynTree::ForwardAccKinematics(m_data->shared->model,
+                                            m_data->shared->traversal,
+                                            m_data->pos,
+                                            m_data->invDynZeroVel,
+                                            m_data->invDynGeneralizedProperAccs,
+                                            m_data->invDynZeroLinkVel,
+                                            m_data->invDynLinkProperAccs);
+        m_data->properAccsValid = ok;
+        m_data->properAccsGravity = m_data->gravityAccInBaseLinkFrame;
+    }
+
+    ok = ok && iDynTree::RNEADynamicPhase(m_data->shared->model,
+                                          m_data->shared->traversal,
                                           m_data->pos.jointPos(),
                                           m_data->invDynZeroLinkVel,
                                           m_data->invDynLinkProperAccs,
@@ -201,6 +328,7 @@ SharedKinDynComputations::SharedKinDynComputations()
     m_data->gravity.zero();
     m_data->gravity(2) = -9.81;
     m_data->updateNecessary = true;
+    m_data->properAccsValid = false;
     m_data->tol = iDynTree::DEFAULT_TOL;
 }
 
@@ -216,12 +344,17 @@ SharedKinDynComputations::SharedKinDynComputations(const DynamicalPlanner::Priva
     m_data->state.base_quaternionVelocity.zero();
     m_data->gravity = other.gravity();
     m_data->updateNecessary = true;
+    m_data->properAccsValid = false;
+    m_data->tol = other.getUpdateTolerance();
 
-    loadRobotModel(other.model());
-
-    setToleranceForUpdate(other.getUpdateTolerance());
+    //iDynTree::KinDynComputations keeps its own copy of the model, while the traversal and the joints topology are shared
+    bool ok = m_data->kinDyn.loadRobotModel(other.model());
+    ok = ok && m_data->kinDyn.setFloatingBase(other.getFloatingBase());
+    assert(ok);
 
-    setFloatingBase(other.getFloatingBase());
+    m_data->shared = other.m_data->shared;
+    resizeBuffers();
+    fillJointsInfo();
 
     assert(isValid());
 }
@@ -234,17 +367,31 @@ bool SharedKinDynComputations::loadRobotModel(const iDynTree::Model &model)
     std::lock_guard<std::mutex> guard(m_data->mutex);
     bool ok = m_data->kinDyn.loadRobotModel(model);
 
-    if (ok) {
-        m_data->state.s.resize(m_data->kinDyn.getNrOfDegreesOfFreedom());
-        m_data->state.s.zero();
-        m_data->state.s_dot.resize(m_data->kinDyn.getNrOfDegreesOfFreedom());
-        m_data->state.s_dot.zero();
-        m_data->jointsInfos.resize(m_data->kinDyn.getNrOfDegreesOfFreedom());
-        bool okTraversal = m_data->kinDyn.model().computeFullTreeTraversal(m_data->traversal);
-        if (!okTraversal)
-            return false;
-        fillJointsInfo();
+    if (!ok) {
+        return false;
+    }
+
+    auto newShared = std::make_shared<ModelData>(model);
+    if (!newShared->setFloatingBase(newShared->model.getDefaultBaseLink())) {
+        return false;
     }
+    m_data->shared = newShared;
+
+    resizeBuffers();
+    fillJointsInfo();
+
+    return true;
+}
+
+void SharedKinDynComputations::resizeBuffers()
+{
+    const iDynTree::Model& model = m_data->shared->model;
+
+    m_data->state.s.resize(static_cast<unsigned int>(model.getNrOfDOFs()));
+    m_data->state.s.zero();
+    m_data->state.s_dot.resize(static_cast<unsigned int>(model.getNrOfDOFs()));
+    m_data->state.s_dot.zero();
+    m_data->stateVersion = 0;
 
     m_data->linkStaticWrenches.resize(model);
     m_data->invDynGeneralizedProperAccs.resize(model);
@@ -261,9 +408,8 @@ bool SharedKinDynComputations::loadRobotModel(const iDynTree::Model &model)
     }
 
     m_data->generalizedStaticTorques.resize(model);
-    m_data->zeroDerivatives.resize(m_data->kinDyn.getNrOfDegreesOfFreedom(), iDynTree::SpatialForceVector::Zero());
-
-    return ok;
+    m_data->dirtyLinks.resize(model.getNrOfLinks());
+    m_data->properAccsValid = false;
 }
 
 const iDynTree::Model &SharedKinDynComputations::model() const
@@ -318,9 +464,13 @@ bool SharedKinDynComputations::setFloatingBase(const std::string &floatingBaseNa
         return false;
     }
 
-    bool okTraversal = m_data->kinDyn.model().computeFullTreeTraversal(m_data->traversal, m_data->kinDyn.model().getLinkIndex(m_data->kinDyn.getFloatingBase()));
-    if (!okTraversal)
+    //The shared data is immutable, hence a new one is built. The copies built before keep using the old one.
+    auto newShared = std::make_shared<ModelData>(m_data->shared->model);
+    if (!newShared->setFloatingBase(newShared->model.getLinkIndex(m_data->kinDyn.getFloatingBase()))) {
         return false;
+    }
+    m_data->shared = newShared;
+    m_data->properAccsValid = false;
 
     fillJointsInfo();
 
@@ -334,7 +484,7 @@ std::string SharedKinDynComputations::getFloatingBase() const
 
 const iDynTree::Traversal &SharedKinDynComputations::traversal() const
 {
-    return m_data->traversal;
+    return m_data->shared->traversal;
 }
 
 bool SharedKinDynComputations::sameState(const RobotState &other) const
@@ -344,11 +494,23 @@ bool SharedKinDynComputations::sameState(const RobotState &other) const
     return sameStatePrivate(other);
 }
 
-bool SharedKinDynComputations::updateRobotState(const RobotState &currentState)
+bool SharedKinDynComputations::updateRobotState(RobotState &currentState)
 {
     std::lock_guard<std::mutex> guard(m_data->mutex);
 
-    return updateRobotStatePrivate(currentState);
+    if (!updateRobotStatePrivate(currentState)) {
+        return false;
+    }
+
+    currentState.version.m_value = m_data->stateVersion;
+    return true;
+}
+
+uint64_t SharedKinDynComputations::stateVersion() const
+{
+    std::lock_guard<std::mutex> guard(m_data->mutex);
+
+    return m_data->stateVersion;
 }
 
 const RobotState &SharedKinDynComputations::currentState() const
@@ -379,7 +541,7 @@ bool SharedKinDynComputations::getCenterOfMassJacobian(const RobotState &current
 
 }
 
-iDynTree::Transform SharedKinDynComputations::getWorldTransform(const RobotState &currentState, std::string frameName)
+iDynTree::Transform SharedKinDynComputations::getWorldTransform(const RobotState &currentState, const std::string &frameName)
 {
     std::lock_guard<std::mutex> guard(m_data->mutex);
 
@@ -429,9 +591,22 @@ bool SharedKinDynComputations::getFrameFreeFloatingJacobian(const RobotState &cu
     if (!updateRobotStatePrivate(currentState))
         return false;
 
-    m_data->kinDyn.setFrameVelocityRepresentation(trivialization);
+    Data::CachedJacobian& cached = m_data->frameJacobians[m_data->jacobianKey(static_cast<size_t>(frameIndex), trivialization)];
+
+    if (cached.version != m_data->positionsVersion) {
+        m_data->kinDyn.setFrameVelocityRepresentation(trivialization);
+
+        if (!m_data->kinDyn.getFrameFreeFloatingJacobian(frameIndex, cached.jacobian)) {
+            cached.version = 0;
+            return false;
+        }
+
+        cached.version = m_data->positionsVersion;
+    }
 
-    return m_data->kinDyn.getFrameFreeFloatingJacobian(frameIndex, outJacobian);
+    outJacobian = cached.jacobian;
+
+    return true;
 }
 
 iDynTree::Transform SharedKinDynComputations::getRelativeTransform(const RobotState &currentState,
@@ -465,9 +640,23 @@ bool SharedKinDynComputations::getRelativeJacobian(const RobotState &currentStat
     if (!updateRobotStatePrivate(currentState))
         return false;
 
-    m_data->kinDyn.setFrameVelocityRepresentation(trivialization);
+    size_t framesKey = static_cast<size_t>(refFrameIndex) * m_data->kinDyn.model().getNrOfFrames() + static_cast<size_t>(frameIndex);
+    Data::CachedJacobian& cached = m_data->relativeJacobians[m_data->jacobianKey(framesKey, trivialization)];
+
+    if (cached.version != m_data->positionsVersion) {
+        m_data->kinDyn.setFrameVelocityRepresentation(trivialization);
+
+        if (!m_data->kinDyn.getRelativeJacobian(refFrameIndex, frameIndex, cached.jacobian)) {
+            cached.version = 0;
+            return false;
+        }
+
+        cached.version = m_data->positionsVersion;
+    }
 
-    return m_data->kinDyn.getRelativeJacobian(refFrameIndex, frameIndex, outJacobian);
+    outJacobian = cached.jacobian;
+
+    return true;
 }
 
 iDynTree::Twist SharedKinDynComputations::getFrameVel(const RobotState &currentState, const std::string &frameName, iDynTree::FrameVelocityRepresentation trivialization)
@@ -512,7 +701,7 @@ bool SharedKinDynComputations::getFrameVelJointsDerivative(const RobotState &cur
 
     const iDynTree::Model& model = m_data->kinDyn.model();
     iDynTree::LinkIndex linkIndex = model.getFrameLink(frameIdx);
-    iDynTree::LinkIndex baseIndex = model.getLinkIndex(m_data->kinDyn.getFloatingBase());
+    iDynTree::LinkIndex baseIndex = m_data->shared->baseIndex;
     assert(baseIndex != iDynTree::LINK_INVALID_INDEX);
 
     if (linkIndex == iDynTree::LINK_INVALID_INDEX) {
@@ -525,17 +714,15 @@ bool SharedKinDynComputations::getFrameVelJointsDerivative(const RobotState &cur
     iDynTree::LinkIndex visitedLink = linkIndex;
     iDynTree::Twist jointDerivative, childVelocity;
     while (visitedLink != baseIndex) {
-        jointPtr = m_data->traversal.getParentJointFromLinkIndex(visitedLink);
+        jointPtr = m_data->shared->traversal.getParentJointFromLinkIndex(visitedLink);
         jointIndex = static_cast<size_t>(jointPtr->getIndex());
 
         childVelocity = m_data->kinDyn.getFrameVel(m_data->jointsInfos[jointIndex].childIndex);
         jointDerivative = m_data->kinDyn.getRelativeTransform(frameIdx, m_data->jointsInfos[jointIndex].childIndex) *
-                m_data->jointsInfos[jointIndex].jointPtr->getMotionSubspaceVector(0,
-                                                                            m_data->jointsInfos[jointIndex].childIndex,
-                                                                            m_data->jointsInfos[jointIndex].parentIndex).cross(-childVelocity);
+                m_data->shared->motionSubspaces[jointIndex].cross(-childVelocity);
 
         derivativeMap.col(static_cast<Eigen::Index>(jointIndex)) = iDynTree::toEigen(jointDerivative);
-        visitedLink = m_data->traversal.getParentLinkFromLinkIndex(visitedLink)->getIndex();
+        visitedLink = m_data->shared->traversal.getParentLinkFromLinkIndex(visitedLink)->getIndex();
     }
 
     return true;
@@ -586,50 +773,46 @@ bool SharedKinDynComputations::getLinearAngularMomentumJointsDerivative(const Ro
     iDynTree::iDynTreeEigenMatrixMap derivativeMap = iDynTree::toEigen(linAngMomentumDerivative);
 
     const iDynTree::Model& model = m_data->kinDyn.model();
-    iDynTree::LinkIndex baseIndex = model.getLinkIndex(m_data->kinDyn.getFloatingBase());
+    iDynTree::LinkIndex baseIndex = m_data->shared->baseIndex;
     assert(baseIndex != iDynTree::LINK_INVALID_INDEX);
 
     iDynTree::IJointConstPtr jointPtr;
     iDynTree::LinkIndex linkIndex;
-    iDynTree::LinkConstPtr linkPtr;
     size_t jointIndex;
     iDynTree::SpatialMomentum linkMomentum, linkMomentumInChildFrame, jointMomentumDerivative;
     iDynTree::SpatialMomentum transformDerivative, velocityDerivative;
-    iDynTree::LinkIndex visitedLink, childLink, parentLink;
+    iDynTree::LinkIndex visitedLink, childLink;
     iDynTree::Transform b_T_link;
     iDynTree::Twist childVelocity;
 
     for (size_t l = 0; l < model.getNrOfLinks(); ++l) {
         linkIndex = static_cast<iDynTree::LinkIndex>(l);
         assert(model.isValidLinkIndex(linkIndex));
-        linkPtr = model.getLink(linkIndex);
-        linkMomentum = linkPtr->getInertia() * m_data->kinDyn.getFrameVel(linkIndex);
+        const iDynTree::SpatialInertia& linkInertia = m_data->shared->linkInertias[l];
+        linkMomentum = linkInertia * m_data->kinDyn.getFrameVel(linkIndex);
         b_T_link = m_data->kinDyn.getRelativeTransform(baseIndex, linkIndex);
 
         visitedLink = linkIndex;
         while(visitedLink != baseIndex) {
-            jointPtr = m_data->traversal.getParentJointFromLinkIndex(visitedLink);
+            jointPtr = m_data->shared->traversal.getParentJointFromLinkIndex(visitedLink);
             jointIndex = static_cast<size_t>(jointPtr->getIndex());
 
             childLink = m_data->jointsInfos[jointIndex].childIndex;
-            parentLink = m_data->jointsInfos[jointIndex].parentIndex;
 
             childVelocity = m_data->jointsInfos[jointIndex].childVelocity;
             linkMomentumInChildFrame = m_data->kinDyn.getRelativeTransform(childLink, linkIndex) * linkMomentum;
 
             transformDerivative = m_data->jointsInfos[jointIndex].baseTC *
-                    jointPtr->getMotionSubspaceVector(0,
-                                                      childLink,
-                                                      parentLink).cross(linkMomentumInChildFrame);
+                    m_data->shared->motionSubspaces[jointIndex].cross(linkMomentumInChildFrame);
 
-            velocityDerivative = b_T_link * (linkPtr->getInertia() * (m_data->kinDyn.getRelativeTransform(linkIndex, childLink) *
-                                                                      m_data->jointsInfos[jointIndex].motionVectorTimesChildVelocity));
+            velocityDerivative = b_T_link * (linkInertia * (m_data->kinDyn.getRelativeTransform(linkIndex, childLink) *
+                                                            m_data->jointsInfos[jointIndex].motionVectorTimesChildVelocity));
 
             jointMomentumDerivative = transformDerivative + velocityDerivative;
 
             derivativeMap.col(static_cast<Eigen::Index>(jointIndex)) += iDynTree::toEigen(jointMomentumDerivative);
 
-            visitedLink = m_data->traversal.getParentLinkFromLinkIndex(visitedLink)->getIndex();
+            visitedLink = m_data->shared->traversal.getParentLinkFromLinkIndex(visitedLink)->getIndex();
         }
     }
     return true;
@@ -684,28 +867,26 @@ bool SharedKinDynComputations::getStaticForcesJointsDerivative(const RobotState
     staticTorquesDerivatives.resize(static_cast<unsigned int>(m_data->jointsInfos.size()), static_cast<unsigned int>(m_data->jointsInfos.size()));
     staticTorquesDerivatives.zero();
 
-    const iDynTree::Model& model = m_data->kinDyn.model();
-    iDynTree::LinkIndex baseIndex = model.getLinkIndex(m_data->kinDyn.getFloatingBase());
+    iDynTree::LinkIndex baseIndex = m_data->shared->baseIndex;
     assert(baseIndex != iDynTree::LINK_INVALID_INDEX);
 
     iDynTree::LinkIndex parentLinkIndex, associatedLinkIndex;
     iDynTree::LinkConstPtr ancestor_ptr;
     iDynTree::TraversalIndex elIndex;
     iDynTree::IJointConstPtr visitedJoint, associatedJoint_ptr;
-    iDynTree::SpatialInertia linkInertia;
     size_t visitedJointIndex, associatedJoint, parentLink, associatedLink, ancestorLink;
     iDynTree::Transform l_T_c, p_T_c, ancestor_T_associated;
 
-    for (unsigned int el = m_data->traversal.getNrOfVisitedLinks() -1; el > 0; el--) {
+    for (unsigned int el = m_data->shared->traversal.getNrOfVisitedLinks() -1; el > 0; el--) {
 
         elIndex = static_cast<iDynTree::TraversalIndex>(el);
-        associatedJoint_ptr = m_data->traversal.getParentJoint(elIndex);
+        associatedJoint_ptr = m_data->shared->traversal.getParentJoint(elIndex);
         associatedJoint = static_cast<size_t>(associatedJoint_ptr->getIndex());
-        associatedLinkIndex = m_data->traversal.getLink(elIndex)->getIndex();
-        linkInertia = model.getLink(associatedLinkIndex)->getInertia();
+        associatedLinkIndex = m_data->shared->traversal.getLink(elIndex)->getIndex();
         associatedLink = static_cast<size_t>(associatedLinkIndex);
+        const iDynTree::SpatialInertia& linkInertia = m_data->shared->linkInertias[associatedLink];
 
-        parentLinkIndex = m_data->traversal.getParentLink(elIndex)->getIndex();
+        parentLinkIndex = m_data->shared->traversal.getParentLink(elIndex)->getIndex();
         parentLink = static_cast<size_t>(parentLinkIndex);
 
         p_T_c = m_data->kinDyn.getRelativeTransform(parentLinkIndex, associatedLinkIndex);
@@ -723,31 +904,29 @@ bool SharedKinDynComputations::getStaticForcesJointsDerivative(const RobotState
             if (parentLinkIndex != baseIndex) {
                 m_data->childrenForceDerivatives[parentLink][visitedJointIndex] = m_data->childrenForceDerivatives[parentLink][visitedJointIndex] + (p_T_c * m_data->childrenForceDerivatives[associatedLink][visitedJointIndex]);
             }
-            visitedJoint = m_data->traversal.getParentJointFromLinkIndex(m_data->jointsInfos[visitedJointIndex].parentIndex);
+            visitedJoint = m_data->shared->traversal.getParentJointFromLinkIndex(m_data->jointsInfos[visitedJointIndex].parentIndex);
         }
 
         if (parentLinkIndex != baseIndex) {
             //Propagate associated joint to the top, otherwise the partial derivative of the last joint is not included in the first joint
-            ancestor_ptr = m_data->traversal.getParentLinkFromLinkIndex(parentLinkIndex);
+            ancestor_ptr = m_data->shared->traversal.getParentLinkFromLinkIndex(parentLinkIndex);
 
             while (ancestor_ptr && (ancestor_ptr->getIndex() != baseIndex)) {
                 ancestorLink = static_cast<size_t>(ancestor_ptr->getIndex());
                 ancestor_T_associated = m_data->kinDyn.getRelativeTransform(ancestor_ptr->getIndex(), associatedLinkIndex);
                 m_data->childrenForceDerivatives[ancestorLink][associatedJoint] = m_data->childrenForceDerivatives[ancestorLink][associatedJoint] + (ancestor_T_associated * m_data->childrenForceDerivatives[associatedLink][associatedJoint]);
-                ancestor_ptr = m_data->traversal.getParentLinkFromLinkIndex(ancestor_ptr->getIndex());
+                ancestor_ptr = m_data->shared->traversal.getParentLinkFromLinkIndex(ancestor_ptr->getIndex());
             }
 
         }
     }
 
-    iDynTree::LinkIndex jLink, parentOfJ;
-    iDynTree::SpatialMotionVector sJ;
+    iDynTree::LinkIndex jLink;
     for (size_t j = 0; j < m_data->jointsInfos.size(); ++j) {
 
         JointInfos& jInfo = m_data->jointsInfos[j];
         jLink = jInfo.childIndex;
-        parentOfJ = jInfo.parentIndex;
-        sJ = jInfo.jointPtr->getMotionSubspaceVector(0, jLink, parentOfJ);
+        const iDynTree::SpatialMotionVector& sJ = m_data->shared->motionSubspaces[j];
 
         for (size_t z = 0; z < m_data->jointsInfos.size(); ++z) {
             staticTorquesDerivatives(static_cast<unsigned int>(j), static_cast<unsigned int>(z)) = sJ.dot(m_data->childrenForceDerivatives[static_cast<size_t>(jLink)][z]);
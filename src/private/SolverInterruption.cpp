@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+
+#include <DynamicalPlannerPrivate/Utilities/SolverInterruption.h>
+
+using namespace DynamicalPlanner::Private;
+
+SolverInterruption::SolverInterruption()
+{
+    reset();
+}
+
+SolverInterruption::~SolverInterruption()
+{ }
+
+void SolverInterruption::reset()
+{
+    m_cancelRequested = false;
+    m_deadline = std::chrono::steady_clock::time_point::max().time_since_epoch().count();
+}
+
+void SolverInterruption::setDeadline(const std::chrono::steady_clock::time_point &deadline)
+{
+    m_deadline = deadline.time_since_epoch().count();
+}
+
+void SolverInterruption::cancel()
+{
+    m_cancelRequested = true;
+}
+
+bool SolverInterruption::cancelRequested() const
+{
+    return m_cancelRequested;
+}
+
+bool SolverInterruption::deadlineReached() const
+{
+    return std::chrono::steady_clock::now().time_since_epoch().count() >= m_deadline;
+}
+
+bool SolverInterruption::isInterrupted() const
+{
+    return cancelRequested() || deadlineReached();
+}
@@ -8,6 +8,7 @@
 #include <levi/levi.h>
 #include <DynamicalPlannerPrivate/Costs/StaticTorquesCost.h>
 #include <DynamicalPlannerPrivate/Utilities/QuaternionUtils.h>
+#include <DynamicalPlannerPrivate/Utilities/VariablesLayout.h>
 
 #include <iDynTree/Core/EigenHelpers.h>
 #include <cassert>
@@ -64,8 +65,8 @@ public:
     }
 
 
-    void prepareFootVariables(const std::string& footName, const iDynTree::FrameIndex & footFrame, const std::vector<iDynTree::Position> &pointsLocalPositions, FootVariables& foot) {
-        getFootRanges(footName, foot);
+    void prepareFootVariables(const FootRanges& footRanges, const iDynTree::FrameIndex & footFrame, const std::vector<iDynTree::Position> &pointsLocalPositions, FootVariables& foot) {
+        setFootRanges(footRanges, foot);
         setFootTransforms(footFrame, pointsLocalPositions, foot);
     }
 
@@ -149,22 +150,13 @@ private:
         }
     }
 
-    void getFootRanges(const std::string& footName, FootVariables& foot) {
+    void setFootRanges(const FootRanges& footRanges, FootVariables& foot) {
 
-        size_t forcePoints = 0;
-        for (auto& label : stateVariables.listOfLabels()) {
-            if (label.find(footName + "ForcePoint") != std::string::npos) {
-                ++forcePoints;
-            }
-        }
-
-        foot.forcePointsRanges.resize(forcePoints);
-        foot.pointForces.resize(forcePoints);
+        foot.forcePointsRanges = footRanges.forcePoints;
+        foot.pointForces.resize(foot.forcePointsRanges.size());
 
-        for (size_t p = 0; p < forcePoints; ++p) {
-            foot.forcePointsRanges[p] = stateVariables.getIndexRange(footName + "ForcePoint" + std::to_string(p));
-            assert(foot.forcePointsRanges[p].isValid());
-            foot.pointForces[p].zero();
+        for (auto& pointForce : foot.pointForces) {
+            pointForce.zero();
         }
 
     }
@@ -205,7 +197,7 @@ private:
 
 
 
-StaticTorquesCost::StaticTorquesCost(const VariablesLabeller &stateVariables, const VariablesLabeller &controlVariables, std::shared_ptr<TimelySharedKinDynComputations> timelySharedKinDyn,
+StaticTorquesCost::StaticTorquesCost(const VariablesLabeller &stateVariables, const VariablesLabeller &controlVariables, const VariablesRanges &ranges, std::shared_ptr<TimelySharedKinDynComputations> timelySharedKinDyn,
                                      const iDynTree::FrameIndex &leftFootFrame, const iDynTree::FrameIndex &rightFootFrame, const std::vector<iDynTree::Position> &positionsInLeftFoot,
                                      const std::vector<iDynTree::Position> &positionsInRightFoot)
     : iDynTree::optimalcontrol::Cost ("StaticTorques")
@@ -218,17 +210,12 @@ StaticTorquesCost::StaticTorquesCost(const VariablesLabeller &stateVariables, co
     assert(timelySharedKinDyn->isValid());
     m_pimpl->timedSharedKinDyn = timelySharedKinDyn;
 
-    m_pimpl->basePositionRange = m_pimpl->stateVariables.getIndexRange("BasePosition");
-    assert(m_pimpl->basePositionRange.isValid());
-
-    m_pimpl->baseQuaternionRange = m_pimpl->stateVariables.getIndexRange("BaseQuaternion");
-    assert(m_pimpl->baseQuaternionRange.isValid());
-
-    m_pimpl->jointsPositionRange = m_pimpl->stateVariables.getIndexRange("JointsPosition");
-    assert(m_pimpl->jointsPositionRange.isValid());
+    m_pimpl->basePositionRange = ranges.basePosition;
+    m_pimpl->baseQuaternionRange = ranges.baseQuaternion;
+    m_pimpl->jointsPositionRange = ranges.jointsPosition;
 
-    m_pimpl->prepareFootVariables("Left", leftFootFrame, positionsInLeftFoot, m_pimpl->leftVariables);
-    m_pimpl->prepareFootVariables("Right", rightFootFrame, positionsInRightFoot, m_pimpl->rightVariables);
+    m_pimpl->prepareFootVariables(ranges.left, leftFootFrame, positionsInLeftFoot, m_pimpl->leftVariables);
+    m_pimpl->prepareFootVariables(ranges.right, rightFootFrame, positionsInRightFoot, m_pimpl->rightVariables);
 
     m_pimpl->contactWrenches.resize(timelySharedKinDyn->model());
     m_pimpl->generalizedStaticTorques.resize(timelySharedKinDyn->model());
@@ -8,6 +8,7 @@
 #include <levi/levi.h>
 #include <DynamicalPlannerPrivate/Utilities/TimelySharedKinDynComputations.h>
 #include <iDynTree/Core/Utils.h>
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 
@@ -15,71 +16,84 @@ using namespace DynamicalPlanner::Private;
 
 
 
-size_t TimelySharedKinDynComputations::getClosestIndex(double time)
+void TimelySharedKinDynComputations::buildBuckets()
 {
-    // Corner cases
-    if (time <= m_pointerContainer[0].time) {
-        m_previousIndex = 0;
-        return 0;
+    m_buckets.clear();
+    m_bucketsOrigin = 0.0;
+    m_inverseBucketWidth = 0.0;
+
+    if (m_pointerContainer.size() < 2) {
+        return;
     }
-    if (time >= m_pointerContainer.back().time) {
-        m_previousIndex = m_pointerContainer.size() - 1;
-        return m_pointerContainer.size() - 1;
+
+    double initialTime = m_pointerContainer.front().time;
+    double finalTime = m_pointerContainer.back().time;
+
+    if (!(finalTime > initialTime)) {
+        return;
     }
 
-    if (iDynTree::checkDoublesAreEqual(time, m_pointerContainer[m_previousIndex].time)) {
-        return m_previousIndex;
+    //Two buckets per knot, so that a bucket contains few knots also when the mesh is not uniform
+    size_t numberOfBuckets = 2 * m_pointerContainer.size();
+    m_bucketsOrigin = initialTime;
+    m_inverseBucketWidth = numberOfBuckets / (finalTime - initialTime);
+    m_buckets.resize(numberOfBuckets);
+
+    size_t knot = 0;
+    for (size_t b = 0; b < numberOfBuckets; ++b) {
+        double bucketStart = initialTime + b / m_inverseBucketWidth;
+        while (((knot + 1) < m_pointerContainer.size()) && (m_pointerContainer[knot + 1].time <= bucketStart)) {
+            knot++;
+        }
+        m_buckets[b] = knot;
     }
+}
+
+size_t TimelySharedKinDynComputations::getLowerIndex(double time) const
+{
+    size_t index = 0;
 
-    if (((m_previousIndex + 1) < m_pointerContainer.size()) && (iDynTree::checkDoublesAreEqual(time, m_pointerContainer[m_previousIndex + 1].time))) {
-        m_previousIndex++;
-        return m_previousIndex;
+    if (m_buckets.size()) {
+        double bucket = std::floor((time - m_bucketsOrigin) * m_inverseBucketWidth);
+        index = m_buckets[std::min(static_cast<size_t>(std::max(bucket, 0.0)), m_buckets.size() - 1)];
     }
 
-    // Doing binary search
-    size_t i = 0, j = m_pointerContainer.size(), mid = 0;
-    while (i < j) {
-        mid = (i + j) / 2;
+    while (((index + 1) < m_pointerContainer.size()) && (m_pointerContainer[index + 1].time <= time)) {
+        index++;
+    }
 
-        if (iDynTree::checkDoublesAreEqual(time, m_pointerContainer[mid].time)) {
-            m_previousIndex = mid;
-            return mid;
-        }
+    return index;
+}
 
-        /* If target is less than array element,
-             then search in left */
-        if (time < m_pointerContainer[mid].time) {
+size_t TimelySharedKinDynComputations::getClosestIndex(size_t lowerIndex, double time) const
+{
+    if ((lowerIndex + 1) >= m_pointerContainer.size()) {
+        return lowerIndex;
+    }
 
-            // If target is greater than previous
-            // to mid, return closest of two
-            if (time > m_pointerContainer[mid - 1].time) {
-                m_previousIndex =  ((time - m_pointerContainer[mid - 1].time) >= (m_pointerContainer[mid].time - time)) ? mid : mid - 1;
-                return m_previousIndex;
-            }
+    size_t upperIndex = lowerIndex + 1;
 
-            /* Repeat for left half */
-            j = mid;
-        }
+    return ((time - m_pointerContainer[lowerIndex].time) >= (m_pointerContainer[upperIndex].time - time)) ? upperIndex : lowerIndex;
+}
 
-        // If target is greater than mid
-        else {
-            if (time < m_pointerContainer[mid + 1].time) {
-                m_previousIndex = ((time - m_pointerContainer[mid].time) >= (m_pointerContainer[mid + 1].time - time)) ? mid + 1 : mid;
-                return m_previousIndex;
-            }
-            // update i
-            i = mid + 1;
-        }
+size_t TimelySharedKinDynComputations::getClosestIndex(double time) const
+{
+    //No state is stored between calls, so that different threads can query different times
+    // Corner cases
+    if (time <= m_pointerContainer[0].time) {
+        return 0;
+    }
+    if (time >= m_pointerContainer.back().time) {
+        return m_pointerContainer.size() - 1;
     }
 
-    // Only single element left after search
-    m_previousIndex = mid;
-    return mid;
+    return getClosestIndex(getLowerIndex(time), time);
 }
 
 TimelySharedKinDynComputations::TimelySharedKinDynComputations()
     : m_timingsSet(false)
-    , m_previousIndex(0)
+    , m_bucketsOrigin(0.0)
+    , m_inverseBucketWidth(0.0)
 {
     m_sharedTemplate = std::make_shared<SharedKinDynComputations>();
 }
@@ -150,11 +164,13 @@ bool TimelySharedKinDynComputations::setTimings(const std::vector<double> &timin
         }
     }
 
+    buildBuckets();
+
     m_timingsSet = true;
     return true;
 }
 
-SharedKinDynComputationsPointer TimelySharedKinDynComputations::get(double time)
+SharedKinDynComputationsPointer TimelySharedKinDynComputations::get(double time) const
 {
     assert(isValid());
 
@@ -164,3 +180,31 @@ SharedKinDynComputationsPointer TimelySharedKinDynComputations::get(double time)
 
     return m_pointerContainer[getClosestIndex(time)].pointer;
 }
+
+SharedKinDynComputationsPointer TimelySharedKinDynComputations::get(double time, TimelySharedKinDynComputations::Cursor &cursor) const
+{
+    assert(isValid());
+
+    if (!m_timingsSet) {
+        return m_sharedTemplate;
+    }
+
+    if (time <= m_pointerContainer[0].time) {
+        cursor.m_lowerIndex = 0;
+        return m_pointerContainer[0].pointer;
+    }
+
+    if (time >= m_pointerContainer.back().time) {
+        cursor.m_lowerIndex = m_pointerContainer.size() - 1;
+        return m_pointerContainer.back().pointer;
+    }
+
+    size_t lower = cursor.m_lowerIndex;
+
+    if (!((lower + 1) < m_pointerContainer.size() && (m_pointerContainer[lower].time <= time) && (time < m_pointerContainer[lower + 1].time))) {
+        lower = getLowerIndex(time);
+        cursor.m_lowerIndex = lower;
+    }
+
+    return m_pointerContainer[getClosestIndex(lower, time)].pointer;
+}
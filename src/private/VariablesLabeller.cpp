@@ -8,17 +8,51 @@
 #include <iostream>
 #include <DynamicalPlannerPrivate/Utilities/VariablesLabeller.h>
 #include <iDynTree/Core/EigenHelpers.h>
+#include <cassert>
+#include <algorithm>
 
 using namespace DynamicalPlanner::Private;
 
+const double *VariablesLabeller::data() const
+{
+    return m_wrappedData ? m_wrappedData : m_fullVector.data();
+}
+
 VariablesLabeller::VariablesLabeller()
+    : m_wrappedData(nullptr)
 {
 }
 
+VariablesLabeller::VariablesLabeller(const VariablesLabeller &other)
+    : m_fullVector(other.m_fullVector)
+    , m_wrappedData(nullptr)
+    , m_labelsList(other.m_labelsList)
+    , m_labelMap(other.m_labelMap)
+{
+    if (other.m_wrappedData) {
+        std::copy(other.m_wrappedData, other.m_wrappedData + m_fullVector.size(), m_fullVector.data());
+    }
+}
+
 VariablesLabeller::~VariablesLabeller()
 {
 }
 
+VariablesLabeller &VariablesLabeller::operator=(const VariablesLabeller &other)
+{
+    assert(!m_wrappedData);
+
+    m_fullVector = other.m_fullVector;
+    m_labelsList = other.m_labelsList;
+    m_labelMap = other.m_labelMap;
+
+    if (other.m_wrappedData) {
+        std::copy(other.m_wrappedData, other.m_wrappedData + m_fullVector.size(), m_fullVector.data());
+    }
+
+    return *this;
+}
+
 bool VariablesLabeller::addLabel(const std::string &name, size_t dimension)
 {
     std::pair<LabelMap::const_iterator, bool> output;
@@ -31,6 +65,7 @@ bool VariablesLabeller::addLabel(const std::string &name, size_t dimension)
         std::cerr << "[ERROR][VariablesLabeller::addLabel] The label " << name << " seems to be already existing." << std::endl;
         return false;
     }
+    assert(!m_wrappedData);
     m_fullVector.resize(static_cast<unsigned int>(m_fullVector.size() + dimension));
     iDynTree::toEigen(m_fullVector).bottomRows(static_cast<Eigen::Index>(dimension)).setZero();
     m_labelsList.push_back(name);
@@ -50,6 +85,7 @@ iDynTree::IndexRange VariablesLabeller::addLabelAndGetIndexRange(const std::stri
         std::cerr << "[ERROR][VariablesLabeller::addLabelAndGetIndex] The label " << name << " seems to be already existing." << std::endl;
         return iDynTree::IndexRange::InvalidRange();
     }
+    assert(!m_wrappedData);
     m_fullVector.resize(static_cast<unsigned int>(m_fullVector.size() + dimension));
     iDynTree::toEigen(m_fullVector).bottomRows(static_cast<Eigen::Index>(dimension)).setZero();
     m_labelsList.push_back(name);
@@ -64,33 +100,38 @@ size_t VariablesLabeller::size() const
 
 iDynTree::Span<double> VariablesLabeller::values()
 {
+    assert(!m_wrappedData);
     return iDynTree::make_span(m_fullVector);
 }
 
 iDynTree::Span<const double> VariablesLabeller::values() const
 {
-    return iDynTree::make_span(m_fullVector);
+    return iDynTree::Span<const double>(data(), static_cast<long>(m_fullVector.size()));
 }
 
 void VariablesLabeller::zero()
 {
+    assert(!m_wrappedData);
     m_fullVector.zero();
 }
 
 iDynTree::Span<double> VariablesLabeller::operator()(const iDynTree::IndexRange& indexRange)
 {
     assert(indexRange.isValid());
+    assert(!m_wrappedData);
     return iDynTree::make_span(m_fullVector).subspan(indexRange.offset, indexRange.size);
 }
 
 iDynTree::Span<const double> VariablesLabeller::operator()(const iDynTree::IndexRange &indexRange) const
 {
     assert(indexRange.isValid());
-    return iDynTree::make_span(m_fullVector).subspan(indexRange.offset, indexRange.size);
+    return values().subspan(indexRange.offset, indexRange.size);
 }
 
 iDynTree::Span<double> VariablesLabeller::operator()(const std::string &labelName)
 {
+    assert(!m_wrappedData);
+
     LabelMap::const_iterator label = m_labelMap.find(labelName);
 
     long offset = 0;
@@ -116,28 +157,36 @@ iDynTree::Span<const double> VariablesLabeller::operator()(const std::string &la
         dimension = label->second.size;
     }
 
-    return iDynTree::make_span(m_fullVector).subspan(offset, dimension);
+    return values().subspan(offset, dimension);
 }
 
 double VariablesLabeller::operator()(unsigned int index) const
 {
-    return m_fullVector(index);
+    assert(index < m_fullVector.size());
+    return data()[index];
 }
 
 double &VariablesLabeller::operator()(const unsigned int index)
 {
+    assert(!m_wrappedData);
     return m_fullVector(index);
 }
 
 VariablesLabeller &VariablesLabeller::operator=(const iDynTree::VectorDynSize &iDynVector)
 {
     assert(iDynVector.size() == m_fullVector.size());
+    assert(!m_wrappedData);
 
     m_fullVector = iDynVector;
 
     return *this;
 }
 
+bool VariablesLabeller::isWrapping() const
+{
+    return m_wrappedData != nullptr;
+}
+
 iDynTree::IndexRange VariablesLabeller::getIndexRange(const std::string &labelName) const
 {
     LabelMap::const_iterator label = m_labelMap.find(labelName);
@@ -161,7 +210,34 @@ const std::vector<std::string> &VariablesLabeller::listOfLabels() const
 
 void VariablesLabeller::clear()
 {
+    assert(!m_wrappedData);
     m_fullVector.resize(0);
     m_labelMap.clear();
     m_labelsList.clear();
 }
+
+VariablesLabeller::ScopedWrap::ScopedWrap(VariablesLabeller &labeller, const iDynTree::VectorDynSize &vector)
+    : m_labeller(labeller)
+{
+    assert(!labeller.m_wrappedData);
+    assert(vector.size() == labeller.m_fullVector.size());
+
+    m_labeller.m_wrappedData = vector.data();
+}
+
+VariablesLabeller::ScopedWrap::~ScopedWrap()
+{
+    m_labeller.m_wrappedData = nullptr;
+}
+
+iDynTree::Span<const double> VariablesLabeller::ScopedWrap::operator()(const iDynTree::IndexRange &indexRange) const
+{
+    const VariablesLabeller& labeller = m_labeller;
+    return labeller(indexRange);
+}
+
+iDynTree::Span<const double> VariablesLabeller::ScopedWrap::operator()(const std::string &labelName) const
+{
+    const VariablesLabeller& labeller = m_labeller;
+    return labeller(labelName);
+}
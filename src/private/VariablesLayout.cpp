@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+
+#include <DynamicalPlannerPrivate/Utilities/VariablesLayout.h>
+#include <iostream>
+
+using namespace DynamicalPlanner;
+using namespace DynamicalPlanner::Private;
+
+static bool AddFootVariables(const std::string& footName, size_t numberOfPoints, VariablesLabeller& stateVariables,
+                             VariablesLabeller& controlVariables, FootRanges& foot) {
+    foot.forcePoints.resize(numberOfPoints);
+    foot.positionPoints.resize(numberOfPoints);
+    foot.velocityControlPoints.resize(numberOfPoints);
+    foot.forceControlPoints.resize(numberOfPoints);
+
+    for (size_t i = 0; i < numberOfPoints; ++i) {
+        foot.forcePoints[i] = stateVariables.addLabelAndGetIndexRange(footName + "ForcePoint" + std::to_string(i), 3);
+        if (!foot.forcePoints[i].isValid()) {
+            return false;
+        }
+        foot.positionPoints[i] = stateVariables.addLabelAndGetIndexRange(footName + "PositionPoint" + std::to_string(i), 3);
+        if (!foot.positionPoints[i].isValid()) {
+            return false;
+        }
+        foot.velocityControlPoints[i] = controlVariables.addLabelAndGetIndexRange(footName + "VelocityControlPoint" + std::to_string(i), 3);
+        if (!foot.velocityControlPoints[i].isValid()) {
+            return false;
+        }
+        foot.forceControlPoints[i] = controlVariables.addLabelAndGetIndexRange(footName + "ForceControlPoint" + std::to_string(i), 3);
+        if (!foot.forceControlPoints[i].isValid()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool GetRange(const VariablesLabeller& variables, const std::string& labelName, const std::string& variablesType, iDynTree::IndexRange& range) {
+    range = variables.getIndexRange(labelName);
+    if (!range.isValid()) {
+        std::cerr << "[ERROR][GetVariablesLayout] Variable " << labelName << " not available among " << variablesType << " variables." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool DynamicalPlanner::Private::AddVariablesLayout(size_t numberOfDofs, size_t numberOfPoints, VariablesLabeller &stateVariables,
+                                                   VariablesLabeller &controlVariables, VariablesRanges &ranges)
+{
+    if (stateVariables.size() || controlVariables.size()) {
+        std::cerr << "[ERROR][AddVariablesLayout] The labellers are expected to be empty." << std::endl;
+        return false;
+    }
+
+    if (!AddFootVariables("Left", numberOfPoints, stateVariables, controlVariables, ranges.left)) {
+        return false;
+    }
+
+    if (!AddFootVariables("Right", numberOfPoints, stateVariables, controlVariables, ranges.right)) {
+        return false;
+    }
+
+    ranges.momentum = stateVariables.addLabelAndGetIndexRange("Momentum", 6);
+    if (!ranges.momentum.isValid()) {
+        return false;
+    }
+
+    ranges.comPosition = stateVariables.addLabelAndGetIndexRange("CoMPosition", 3);
+    if (!ranges.comPosition.isValid()) {
+        return false;
+    }
+
+    ranges.basePosition = stateVariables.addLabelAndGetIndexRange("BasePosition", 3);
+    if (!ranges.basePosition.isValid()) {
+        return false;
+    }
+
+    ranges.baseQuaternion = stateVariables.addLabelAndGetIndexRange("BaseQuaternion", 4);
+    if (!ranges.baseQuaternion.isValid()) {
+        return false;
+    }
+
+    ranges.jointsPosition = stateVariables.addLabelAndGetIndexRange("JointsPosition", numberOfDofs);
+    if (!ranges.jointsPosition.isValid()) {
+        return false;
+    }
+
+    ranges.baseLinearVelocity = controlVariables.addLabelAndGetIndexRange("BaseLinearVelocity", 3);
+    if (!ranges.baseLinearVelocity.isValid()) {
+        return false;
+    }
+
+    ranges.baseQuaternionDerivative = controlVariables.addLabelAndGetIndexRange("BaseQuaternionDerivative", 4);
+    if (!ranges.baseQuaternionDerivative.isValid()) {
+        return false;
+    }
+
+    ranges.jointsVelocity = controlVariables.addLabelAndGetIndexRange("JointsVelocity", numberOfDofs);
+    if (!ranges.jointsVelocity.isValid()) {
+        return false;
+    }
+
+    return true;
+}
+
+size_t DynamicalPlanner::Private::NumberOfFootPoints(const VariablesLabeller &stateVariables, const std::string &footName)
+{
+    size_t numberOfPoints = 0;
+    while (stateVariables.getIndexRange(footName + "ForcePoint" + std::to_string(numberOfPoints)).isValid()) {
+        numberOfPoints++;
+    }
+    return numberOfPoints;
+}
+
+bool DynamicalPlanner::Private::GetFootRanges(const VariablesLabeller &stateVariables, const VariablesLabeller &controlVariables,
+                                              const std::string &footName, FootRanges &foot)
+{
+    size_t numberOfPoints = NumberOfFootPoints(stateVariables, footName);
+
+    foot.forcePoints.resize(numberOfPoints);
+    foot.positionPoints.resize(numberOfPoints);
+    foot.velocityControlPoints.resize(numberOfPoints);
+    foot.forceControlPoints.resize(numberOfPoints);
+
+    bool ok = true;
+    for (size_t i = 0; i < numberOfPoints; ++i) {
+        ok = ok && GetRange(stateVariables, footName + "ForcePoint" + std::to_string(i), "state", foot.forcePoints[i]);
+        ok = ok && GetRange(stateVariables, footName + "PositionPoint" + std::to_string(i), "state", foot.positionPoints[i]);
+        ok = ok && GetRange(controlVariables, footName + "VelocityControlPoint" + std::to_string(i), "control", foot.velocityControlPoints[i]);
+        ok = ok && GetRange(controlVariables, footName + "ForceControlPoint" + std::to_string(i), "control", foot.forceControlPoints[i]);
+    }
+
+    return ok;
+}
+
+bool DynamicalPlanner::Private::GetVariablesLayout(const VariablesLabeller &stateVariables, const VariablesLabeller &controlVariables, VariablesRanges &ranges)
+{
+    bool ok = GetFootRanges(stateVariables, controlVariables, "Left", ranges.left);
+    ok = ok && GetFootRanges(stateVariables, controlVariables, "Right", ranges.right);
+
+    ok = ok && GetRange(stateVariables, "Momentum", "state", ranges.momentum);
+    ok = ok && GetRange(stateVariables, "CoMPosition", "state", ranges.comPosition);
+    ok = ok && GetRange(stateVariables, "BasePosition", "state", ranges.basePosition);
+    ok = ok && GetRange(stateVariables, "BaseQuaternion", "state", ranges.baseQuaternion);
+    ok = ok && GetRange(stateVariables, "JointsPosition", "state", ranges.jointsPosition);
+
+    ok = ok && GetRange(controlVariables, "BaseLinearVelocity", "control", ranges.baseLinearVelocity);
+    ok = ok && GetRange(controlVariables, "BaseQuaternionDerivative", "control", ranges.baseQuaternionDerivative);
+    ok = ok && GetRange(controlVariables, "JointsVelocity", "control", ranges.jointsVelocity);
+
+    return ok;
+}
@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+
+#include <DynamicalPlanner/Solver.h>
+#include <DynamicalPlanner/RectangularFoot.h>
+#include <iDynTree/Core/TestUtils.h>
+#include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/ModelIO/ModelLoader.h>
+#include <iDynTree/KinDynComputations.h>
+#include <URDFdir.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+static std::atomic<bool> countAllocations(false);
+static std::atomic<size_t> allocationsCounter(0);
+
+static void countAllocation() {
+    if (countAllocations) {
+        allocationsCounter++;
+    }
+}
+
+#if defined(__GLIBC__)
+
+//Hooking malloc counts also the allocations not passing through operator new, like those of Eigen's aligned_malloc
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t number, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+
+    void* malloc(size_t size) noexcept {
+        countAllocation();
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t number, size_t size) noexcept {
+        countAllocation();
+        return __libc_calloc(number, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept {
+        countAllocation();
+        return __libc_realloc(pointer, size);
+    }
+
+    int posix_memalign(void** pointer, size_t alignment, size_t size) noexcept {
+        countAllocation();
+        *pointer = __libc_memalign(alignment, size);
+        return *pointer ? 0 : ENOMEM;
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept {
+        countAllocation();
+        return __libc_memalign(alignment, size);
+    }
+}
+
+#else
+
+//Only the allocations passing through operator new can be counted
+void* operator new(std::size_t size) {
+    countAllocation();
+    void* pointer = std::malloc(size ? size : 1);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+#endif
+
+//The buffers are allocated at the first solve. In the following ones, only the evaluations of the problem are counted.
+class OptimizerTest : public iDynTree::optimization::Optimizer {
+
+    iDynTree::VectorDynSize m_variables, m_constraints, m_costGradient, m_multipliers;
+    iDynTree::MatrixDynSize m_jacobian, m_costHessian, m_constraintsHessian;
+    bool m_buffersAllocated = false;
+
+public:
+    size_t evaluationAllocations = 0;
+
+    OptimizerTest() {}
+
+    virtual ~OptimizerTest() override;
+
+    virtual bool isAvailable() const override{
+        return true;
+    }
+
+    virtual bool solve() override {
+        double cost;
+        ASSERT_IS_TRUE(m_problem != nullptr);
+        ASSERT_IS_TRUE(m_problem->prepare());
+
+        if (!m_buffersAllocated) {
+            m_variables.resize(m_problem->numberOfVariables());
+            m_costGradient.resize(m_problem->numberOfVariables());
+            m_constraints.resize(m_problem->numberOfConstraints());
+            m_multipliers.resize(m_problem->numberOfConstraints());
+            m_jacobian.resize(m_problem->numberOfConstraints(), m_problem->numberOfVariables());
+            m_costHessian.resize(m_problem->numberOfVariables(), m_problem->numberOfVariables());
+            m_constraintsHessian.resize(m_problem->numberOfVariables(), m_problem->numberOfVariables());
+            m_jacobian.zero();
+            m_costHessian.zero();
+            m_constraintsHessian.zero();
+            iDynTree::getRandomVector(m_multipliers);
+            m_buffersAllocated = true;
+        }
+
+        ASSERT_IS_TRUE(m_problem->getGuess(m_variables));
+
+        size_t initialCount = allocationsCounter;
+        bool wasCounting = countAllocations;
+        countAllocations = true;
+
+        ASSERT_IS_TRUE(m_problem->setVariables(m_variables));
+        ASSERT_IS_TRUE(m_problem->evaluateCostFunction(cost));
+        ASSERT_IS_TRUE(m_problem->evaluateCostGradient(m_costGradient));
+        ASSERT_IS_TRUE(m_problem->evaluateCostHessian(m_costHessian));
+        ASSERT_IS_TRUE(m_problem->evaluateConstraints(m_constraints));
+        ASSERT_IS_TRUE(m_problem->evaluateConstraintsJacobian(m_jacobian));
+        ASSERT_IS_TRUE(m_problem->evaluateConstraintsHessian(m_multipliers, m_constraintsHessian));
+
+        countAllocations = wasCounting;
+        evaluationAllocations = allocationsCounter - initialCount;
+
+        return true;
+    }
+
+    virtual bool getPrimalVariables(iDynTree::VectorDynSize &primalVariables) override {
+        ASSERT_IS_TRUE(m_problem != nullptr);
+        primalVariables = m_variables;
+        return true;
+    }
+
+    virtual bool getDualVariables(iDynTree::VectorDynSize &constraintsMultipliers,
+                                  iDynTree::VectorDynSize &lowerBoundsMultipliers,
+                                  iDynTree::VectorDynSize &upperBoundsMultipliers) override {
+        ASSERT_IS_TRUE(m_problem != nullptr);
+        constraintsMultipliers.resize(m_problem->numberOfConstraints());
+        lowerBoundsMultipliers.resize(m_problem->numberOfVariables());
+        upperBoundsMultipliers.resize(m_problem->numberOfVariables());
+        return true;
+    }
+};
+OptimizerTest::~OptimizerTest(){}
+
+void fillInitialState(const iDynTree::Model& model, const DynamicalPlanner::SettingsStruct settings,
+                      const iDynTree::VectorDynSize desiredJoints, DynamicalPlanner::RectangularFoot &foot,
+                      DynamicalPlanner::State &initialState) {
+
+    iDynTree::KinDynComputations kinDyn;
+
+    bool ok = kinDyn.loadRobotModel(model);
+    ASSERT_IS_TRUE(ok);
+
+    ok = kinDyn.setFloatingBase(model.getLinkName(model.getFrameLink(model.getFrameIndex(settings.leftFrameName))));
+    ASSERT_IS_TRUE(ok);
+
+    iDynTree::Vector3 gravity;
+    gravity.zero();
+    gravity(2) = -9.81;
+
+    ok = kinDyn.setRobotState(model.getFrameTransform(model.getFrameIndex(settings.leftFrameName)).inverse(), desiredJoints,
+                              iDynTree::Twist::Zero(), iDynTree::VectorDynSize(desiredJoints.size()), gravity);
+    ASSERT_IS_TRUE(ok);
+
+    initialState.comPosition = kinDyn.getCenterOfMassPosition();
+
+    initialState.jointsConfiguration = desiredJoints;
+
+    kinDyn.setFrameVelocityRepresentation(iDynTree::FrameVelocityRepresentation::MIXED_REPRESENTATION);
+    initialState.momentumInCoM = kinDyn.getCentroidalTotalMomentum().asVector();
+
+    initialState.time = 0.0;
+
+    initialState.worldToBaseTransform = kinDyn.getWorldTransform(settings.floatingBaseName);
+
+    iDynTree::Transform leftTransform = kinDyn.getWorldTransform(settings.leftFrameName);
+    iDynTree::Transform rightTransform = kinDyn.getWorldTransform(settings.rightFrameName);
+
+    double totalMass = 0.0;
+
+    for(size_t l=0; l < model.getNrOfLinks(); l++)
+    {
+        totalMass += model.getLink(static_cast<iDynTree::LinkIndex>(l))->getInertia().getMass();
+    }
+
+    double normalForce = totalMass * 9.81;
+
+    for (size_t i = 0; i < settings.leftPointsPosition.size(); ++i) {
+        initialState.leftContactPointsState[i].pointPosition = leftTransform * settings.leftPointsPosition[i];
+        initialState.rightContactPointsState[i].pointPosition = rightTransform * settings.rightPointsPosition[i];
+    }
+
+    iDynTree::Wrench leftWrench, rightWrench;
+    leftWrench.zero();
+    rightWrench.zero();
+
+    leftWrench(2) = normalForce/2.0;
+    rightWrench(2) = normalForce/2.0;
+
+    std::vector<iDynTree::Force> leftPointForces, rightPointForces;
+
+    ok = foot.getForces(leftWrench, leftPointForces);
+    ASSERT_IS_TRUE(ok);
+
+    ok = foot.getForces(rightWrench, rightPointForces);
+    ASSERT_IS_TRUE(ok);
+
+    for (size_t i = 0; i < settings.leftPointsPosition.size(); ++i) {
+        initialState.leftContactPointsState[i].pointForce = leftPointForces[i];
+        initialState.rightContactPointsState[i].pointForce = rightPointForces[i];
+    }
+}
+
+int main() {
+
+    DynamicalPlanner::Solver solver;
+    DynamicalPlanner::Settings settings;
+
+    std::vector<std::string> vectorList({"torso_pitch", "torso_roll", "torso_yaw", "l_shoulder_pitch", "l_shoulder_roll",
+                                         "l_shoulder_yaw", "l_elbow", "r_shoulder_pitch", "r_shoulder_roll", "r_shoulder_yaw",
+                                         "r_elbow", "l_hip_pitch", "l_hip_roll", "l_hip_yaw", "l_knee", "l_ankle_pitch",
+                                         "l_ankle_roll", "r_hip_pitch", "r_hip_roll", "r_hip_yaw", "r_knee", "r_ankle_pitch", "r_ankle_roll"});
+
+    iDynTree::ModelLoader modelLoader;
+    bool ok = modelLoader.loadModelFromFile(getAbsModelPath("iCubGenova04.urdf"));
+    ASSERT_IS_TRUE(ok);
+    ok = modelLoader.loadReducedModelFromFullModel(modelLoader.model(), vectorList);
+    ASSERT_IS_TRUE(ok);
+
+    DynamicalPlanner::SettingsStruct settingsStruct = DynamicalPlanner::Settings::Defaults(modelLoader.model());
+
+    DynamicalPlanner::RectangularFoot foot;
+
+    double d = 0.08;
+    double l = 0.188;
+
+    iDynTree::Position topLeftPosition(0.125,  0.04, 0.0);
+    ok = foot.setFoot(l, d, topLeftPosition);
+    ASSERT_IS_TRUE(ok);
+
+    ok = foot.getPoints(iDynTree::Transform::Identity(), settingsStruct.leftPointsPosition);
+    ASSERT_IS_TRUE(ok);
+
+    settingsStruct.rightPointsPosition = settingsStruct.leftPointsPosition;
+
+    DynamicalPlanner::State initialState;
+
+    initialState.resize(vectorList.size(), settingsStruct.leftPointsPosition.size());
+
+    iDynTree::VectorDynSize desiredInitialJoints(static_cast<unsigned int>(modelLoader.model().getNrOfDOFs()));
+
+    iDynTree::toEigen(desiredInitialJoints) << 15, 0, 0, -7, 22, 11, 30, -7, 22, 11, 30, 5.082, 0.406, -0.131,
+                                              -45.249, -26.454, -0.351, 5.082, 0.406, -0.131, -45.249, -26.454, -0.351;
+
+    iDynTree::toEigen(desiredInitialJoints) *= iDynTree::deg2rad(1.0);
+
+    fillInitialState(modelLoader.model(), settingsStruct, desiredInitialJoints, foot, initialState);
+
+    settingsStruct.desiredCoMTrajectory  = std::make_shared<iDynTree::optimalcontrol::TimeInvariantVector>(initialState.comPosition);
+    settingsStruct.desiredJointsTrajectory = std::make_shared<iDynTree::optimalcontrol::TimeInvariantVector>(desiredInitialJoints);
+
+    settingsStruct.minimumDt = 0.1;
+    settingsStruct.controlPeriod = 0.1;
+    settingsStruct.maximumDt = 1.0;
+    settingsStruct.horizon = 1.0;
+
+    ok = settings.setFromStruct(settingsStruct);
+    ASSERT_IS_TRUE(ok);
+
+    auto optimizerTest = std::make_shared<OptimizerTest>();
+
+    ok = solver.setOptimizer(optimizerTest);
+    ASSERT_IS_TRUE(ok);
+
+    ok = solver.specifySettings(settings);
+    ASSERT_IS_TRUE(ok);
+
+    ok = solver.setInitialState(initialState);
+    ASSERT_IS_TRUE(ok);
+
+    auto stateGuesses = std::make_shared<DynamicalPlanner::TimeInvariantState>(initialState);
+    auto controlGuesses = std::make_shared<DynamicalPlanner::TimeInvariantControl>(DynamicalPlanner::Control(vectorList.size(), settingsStruct.leftPointsPosition.size()));
+
+    ok = solver.setGuesses(stateGuesses, controlGuesses);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.solve(); //warm-up, here the buffers are allocated
+    ASSERT_IS_TRUE(ok);
+
+    //No absolute bound is asserted: the allocations inside iDynTree and levi have not been measured yet.
+    //Only the growth from one solve to the next is checked.
+    size_t solveAllocations = 0, evaluationAllocations = 0;
+
+    for (size_t i = 0; i < 2; ++i) {
+        ok = solver.setGuesses(stateGuesses, controlGuesses);
+        ASSERT_IS_TRUE(ok);
+
+        allocationsCounter = 0;
+        countAllocations = true;
+        ok = solver.solve();
+        countAllocations = false;
+        ASSERT_IS_TRUE(ok);
+
+        std::cout << "Allocations during the evaluation of the problem: " << optimizerTest->evaluationAllocations << std::endl;
+        std::cout << "Allocations during the whole solve: " << allocationsCounter << std::endl;
+
+        ASSERT_IS_TRUE((i == 0) || (optimizerTest->evaluationAllocations <= evaluationAllocations));
+        ASSERT_IS_TRUE((i == 0) || (allocationsCounter <= solveAllocations));
+
+        evaluationAllocations = optimizerTest->evaluationAllocations;
+        solveAllocations = allocationsCounter;
+    }
+
+    const DynamicalPlanner::StateTrajectoryView& statesView = solver.optimalStatesView();
+    ASSERT_IS_TRUE(statesView.size() > 0);
+
+    return EXIT_SUCCESS;
+}
@@ -7,6 +7,7 @@
 
 #include <levi/levi.h>
 #include <DynamicalPlannerPrivate/Utilities/VariablesLabeller.h>
+#include <DynamicalPlannerPrivate/Utilities/VariablesLayout.h>
 #include <DynamicalPlannerPrivate/Utilities/TimelySharedKinDynComputations.h>
 #include <DynamicalPlannerPrivate/Utilities/ExpressionsServer.h>
 #include <DynamicalPlannerPrivate/Constraints.h>
@@ -33,6 +34,8 @@ typedef struct {
     std::vector<std::shared_ptr<PlanarVelocityControlConstraints>> leftPlanarVelocityControl, rightPlanarVelocityControl;
     std::vector<std::shared_ptr<ContactForceControlConstraints>> leftContactsForceControl, rightContactsForceControl;
     std::vector<std::shared_ptr<ContactFrictionConstraint>> leftContactsFriction, rightContactsFriction;
+    std::shared_ptr<FootContactFrictionConstraints> leftFootFriction, rightFootFriction;
+    std::shared_ptr<FootContactForceControlConstraints> leftFootForceControl, rightFootForceControl;
     std::vector<std::shared_ptr<ContactPositionConsistencyConstraint>> leftContactsPosition, rightContactsPosition;
     std::shared_ptr<FeetLateralDistanceConstraint> feetLateralDistance;
     std::shared_ptr<QuaternionNormConstraint> quaternionNorm;
@@ -156,7 +159,11 @@ void initializeConstraints(ConstraintSet& constraints, const std::vector<iDynTre
 
 
     bool ok = false;
-    constraints.dynamical = std::make_shared<DynamicalConstraints>(stateVariables, controlVariables, timelySharedKinDyn, expressionsServer, velocityActivationXY, forceActivation, forceDissipationRatios);
+    VariablesRanges ranges;
+    ok = GetVariablesLayout(stateVariables, controlVariables, ranges);
+    ASSERT_IS_TRUE(ok);
+
+    constraints.dynamical = std::make_shared<DynamicalConstraints>(stateVariables, controlVariables, ranges, timelySharedKinDyn, expressionsServer, velocityActivationXY, forceActivation, forceDissipationRatios);
     ok = ocProblem.setDynamicalSystemConstraint(constraints.dynamical);
     ASSERT_IS_TRUE(ok);
 
@@ -181,7 +188,7 @@ void initializeConstraints(ConstraintSet& constraints, const std::vector<iDynTre
         ok = ocProblem.addConstraint(constraints.leftContactsForceControl[i]);
         ASSERT_IS_TRUE(ok);
 
-        constraints.leftContactsFriction[i] = std::make_shared<ContactFrictionConstraint>(stateVariables, controlVariables, "Left", i);
+        constraints.leftContactsFriction[i] = std::make_shared<ContactFrictionConstraint>(stateVariables, controlVariables, ranges.left, "Left", i);
         ok = ocProblem.addConstraint(constraints.leftContactsFriction[i]);
         ASSERT_IS_TRUE(ok);
 
@@ -223,7 +230,7 @@ void initializeConstraints(ConstraintSet& constraints, const std::vector<iDynTre
         ok = ocProblem.addConstraint(constraints.rightContactsForceControl[i]);
         ASSERT_IS_TRUE(ok);
 
-        constraints.rightContactsFriction[i] = std::make_shared<ContactFrictionConstraint>(stateVariables, controlVariables, "Right", i);
+        constraints.rightContactsFriction[i] = std::make_shared<ContactFrictionConstraint>(stateVariables, controlVariables, ranges.right, "Right", i);
         ok = ocProblem.addConstraint(constraints.rightContactsFriction[i]);
         ASSERT_IS_TRUE(ok);
 
@@ -246,6 +253,26 @@ void initializeConstraints(ConstraintSet& constraints, const std::vector<iDynTre
         ASSERT_IS_TRUE(ok);
     }
 
+    constraints.leftFootFriction = std::make_shared<FootContactFrictionConstraints>(stateVariables, controlVariables, ranges.left, "Left");
+    ok = ocProblem.addConstraint(constraints.leftFootFriction);
+    ASSERT_IS_TRUE(ok);
+
+    constraints.rightFootFriction = std::make_shared<FootContactFrictionConstraints>(stateVariables, controlVariables, ranges.right, "Right");
+    ok = ocProblem.addConstraint(constraints.rightFootFriction);
+    ASSERT_IS_TRUE(ok);
+
+    constraints.leftFootForceControl = std::make_shared<FootContactForceControlConstraints>(stateVariables, controlVariables, ranges.left, "Left",
+                                                                                            forceActivation, forceMaximumDerivative,
+                                                                                            forceDissipationRatios);
+    ok = ocProblem.addConstraint(constraints.leftFootForceControl);
+    ASSERT_IS_TRUE(ok);
+
+    constraints.rightFootForceControl = std::make_shared<FootContactForceControlConstraints>(stateVariables, controlVariables, ranges.right, "Right",
+                                                                                             forceActivation, forceMaximumDerivative,
+                                                                                             forceDissipationRatios);
+    ok = ocProblem.addConstraint(constraints.rightFootForceControl);
+    ASSERT_IS_TRUE(ok);
+
     constraints.centroidalMomentum = std::make_shared<CentroidalMomentumConstraint>(stateVariables, controlVariables,
                                                                                     timelySharedKinDyn, expressionsServer);
     ok = ocProblem.addConstraint(constraints.centroidalMomentum);
@@ -7,6 +7,7 @@
 
 #include <levi/levi.h>
 #include <DynamicalPlannerPrivate/Utilities/VariablesLabeller.h>
+#include <DynamicalPlannerPrivate/Utilities/VariablesLayout.h>
 #include <DynamicalPlannerPrivate/Utilities/TimelySharedKinDynComputations.h>
 #include <DynamicalPlannerPrivate/Costs.h>
 #include <DynamicalPlannerPrivate/Constraints/DynamicalConstraints.h>
@@ -111,7 +112,11 @@ void configureCosts(const VariablesLabeller& stateVariables, const VariablesLabe
     iDynTree::getRandomVector(swingWeights);
 
 
-    auto dynamical = std::make_shared<DynamicalConstraints>(stateVariables, controlVariables, timelySharedKinDyn, expressionsServer, velocityActivationXY, forceActivation, forceDissipationRatios);
+    VariablesRanges ranges;
+    ok = GetVariablesLayout(stateVariables, controlVariables, ranges);
+    ASSERT_IS_TRUE(ok);
+
+    auto dynamical = std::make_shared<DynamicalConstraints>(stateVariables, controlVariables, ranges, timelySharedKinDyn, expressionsServer, velocityActivationXY, forceActivation, forceDissipationRatios);
     ok = ocProblem.setDynamicalSystemConstraint(dynamical);
     ASSERT_IS_TRUE(ok);
 
@@ -176,7 +181,7 @@ void configureCosts(const VariablesLabeller& stateVariables, const VariablesLabe
 
 //    iDynTree::FrameIndex leftFrame = timelySharedKinDyn->model().getFrameIndex("l_sole"),
 //            rightFrame = timelySharedKinDyn->model().getFrameIndex("r_sole");
-//    staticTorquesCost = std::make_shared<StaticTorquesCost>(stateVariables, controlVariables, timelySharedKinDyn, leftFrame, rightFrame, leftPositions, rightPositions);
+//    staticTorquesCost = std::make_shared<StaticTorquesCost>(stateVariables, controlVariables, ranges, timelySharedKinDyn, leftFrame, rightFrame, leftPositions, rightPositions);
 //    ok = ocProblem.addLagrangeTerm(0.5, staticTorquesCost);
 //    ASSERT_IS_TRUE(ok);
 
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+
+#include <DynamicalPlannerPrivate/Utilities/SharedKinDynComputations.h>
+#include <iDynTree/Core/TestUtils.h>
+#include <iDynTree/Core/EigenHelpers.h>
+#include <iDynTree/ModelIO/ModelLoader.h>
+#include <URDFdir.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+using namespace DynamicalPlanner::Private;
+
+void configureSharedKinDyn(std::shared_ptr<SharedKinDynComputations> sharedKinDyn, iDynTree::LinkNetExternalWrenches& linkExtForces) {
+    std::vector<std::string> vectorList({"torso_pitch", "torso_roll", "torso_yaw", "l_shoulder_pitch", "l_shoulder_roll",
+                                         "l_shoulder_yaw", "l_elbow", "r_shoulder_pitch", "r_shoulder_roll", "r_shoulder_yaw",
+                                         "r_elbow", "l_hip_pitch", "l_hip_roll", "l_hip_yaw", "l_knee", "l_ankle_pitch",
+                                         "l_ankle_roll", "r_hip_pitch", "r_hip_roll", "r_hip_yaw", "r_knee", "r_ankle_pitch", "r_ankle_roll"});
+
+    iDynTree::ModelLoader modelLoader;
+    bool ok = modelLoader.loadModelFromFile(getAbsModelPath("iCubGenova04.urdf"));
+    ASSERT_IS_TRUE(ok);
+    ok = modelLoader.loadReducedModelFromFullModel(modelLoader.model(), vectorList);
+    ASSERT_IS_TRUE(ok);
+    assert(sharedKinDyn);
+    ok = sharedKinDyn->loadRobotModel(modelLoader.model());
+    ASSERT_IS_TRUE(ok);
+    linkExtForces.resize(modelLoader.model());
+    for (size_t l = 0; l < modelLoader.model().getNrOfLinks(); ++l) {
+        linkExtForces(static_cast<iDynTree::LinkIndex>(l)).zero();
+    }
+}
+
+void randomizeJoints(RobotState& robotState) {
+    iDynTree::getRandomVector(robotState.s);
+}
+
+int main() {
+
+    std::shared_ptr<SharedKinDynComputations> sharedKinDyn = std::make_shared<SharedKinDynComputations>();
+    iDynTree::LinkNetExternalWrenches linkExtForces;
+    configureSharedKinDyn(sharedKinDyn, linkExtForces);
+
+    RobotState robotState, perturbedState;
+
+    iDynTree::getRandomVector(robotState.base_linearVelocity, -1.0, 1.0);
+    iDynTree::getRandomVector(robotState.base_quaternionVelocity, -1.0, 1.0);
+    robotState.s.resize(static_cast<unsigned int>(sharedKinDyn->model().getNrOfDOFs()));
+    robotState.s_dot.resize(static_cast<unsigned int>(sharedKinDyn->model().getNrOfDOFs()));
+    iDynTree::getRandomVector(robotState.s_dot);
+    iDynTree::Transform randomTransform = iDynTree::getRandomTransform();
+    robotState.base_position = randomTransform.getPosition();
+    robotState.base_quaternion = randomTransform.getRotation().asQuaternion();
+
+    iDynTree::Wrench footWrench;
+    iDynTree::getRandomVector(footWrench, -10, 10);
+    linkExtForces(sharedKinDyn->model().getFrameLink(sharedKinDyn->model().getFrameIndex("l_sole"))) = footWrench;
+    iDynTree::getRandomVector(footWrench, -10, 10);
+    linkExtForces(sharedKinDyn->model().getFrameLink(sharedKinDyn->model().getFrameIndex("r_sole"))) = footWrench;
+
+    const unsigned int iterations = 10;
+    const double perturbationValue = 1e-6;
+    iDynTree::MatrixDynSize momentumDerivative, staticTorquesDerivative, finiteDifferences, torquesFiniteDifferences;
+    iDynTree::SpatialMomentum originalMomentum, perturbedMomentum;
+    iDynTree::FreeFloatingGeneralizedTorques generalizedTorques;
+    iDynTree::VectorDynSize originalTorques;
+    finiteDifferences.resize(6, static_cast<unsigned int>(robotState.s.size()));
+    torquesFiniteDifferences.resize(static_cast<unsigned int>(robotState.s.size()), static_cast<unsigned int>(robotState.s.size()));
+
+    // The joints derivatives use the joints motion subspaces and the link inertias cached at setup. Check them against finite differences.
+    for (unsigned int i = 0; i < iterations; ++i) {
+        randomizeJoints(robotState);
+        ASSERT_IS_TRUE(sharedKinDyn->getLinearAngularMomentumJointsDerivative(robotState, momentumDerivative));
+        ASSERT_IS_TRUE(sharedKinDyn->getStaticForcesJointsDerivative(robotState, linkExtForces, staticTorquesDerivative));
+
+        originalMomentum = sharedKinDyn->getLinearAngularMomentum(robotState, iDynTree::FrameVelocityRepresentation::BODY_FIXED_REPRESENTATION);
+        ASSERT_IS_TRUE(sharedKinDyn->getStaticForces(robotState, linkExtForces, generalizedTorques));
+        originalTorques = generalizedTorques.jointTorques();
+        for (unsigned int j = 0; j < robotState.s.size(); ++j) {
+            perturbedState = robotState;
+            perturbedState.s(j) += perturbationValue;
+            perturbedMomentum = sharedKinDyn->getLinearAngularMomentum(perturbedState, iDynTree::FrameVelocityRepresentation::BODY_FIXED_REPRESENTATION);
+            iDynTree::toEigen(finiteDifferences).col(static_cast<Eigen::Index>(j)) = (iDynTree::toEigen(perturbedMomentum) - iDynTree::toEigen(originalMomentum)) / perturbationValue;
+            ASSERT_IS_TRUE(sharedKinDyn->getStaticForces(perturbedState, linkExtForces, generalizedTorques));
+            iDynTree::toEigen(torquesFiniteDifferences).col(static_cast<Eigen::Index>(j)) = (iDynTree::toEigen(generalizedTorques.jointTorques()) - iDynTree::toEigen(originalTorques)) / perturbationValue;
+        }
+
+        ASSERT_EQUAL_MATRIX_TOL(momentumDerivative, finiteDifferences, 1e-3);
+        ASSERT_EQUAL_MATRIX_TOL(staticTorquesDerivative, torquesFiniteDifferences, 1e-3);
+    }
+
+    // The frame Jacobians are cached per positions version, hence they have to follow the state changes
+    iDynTree::FrameIndex footFrame = sharedKinDyn->model().getFrameIndex("l_sole");
+    iDynTree::MatrixDynSize footJacobian, perturbedFootJacobian, cachedFootJacobian;
+    ASSERT_IS_TRUE(sharedKinDyn->getFrameFreeFloatingJacobian(robotState, footFrame, footJacobian, iDynTree::FrameVelocityRepresentation::MIXED_REPRESENTATION));
+    perturbedState = robotState;
+    perturbedState.s(0) += 0.1;
+    ASSERT_IS_TRUE(sharedKinDyn->getFrameFreeFloatingJacobian(perturbedState, footFrame, perturbedFootJacobian, iDynTree::FrameVelocityRepresentation::MIXED_REPRESENTATION));
+    ASSERT_IS_TRUE(!iDynTree::toEigen(perturbedFootJacobian).isApprox(iDynTree::toEigen(footJacobian)));
+    ASSERT_IS_TRUE(sharedKinDyn->getFrameFreeFloatingJacobian(robotState, footFrame, cachedFootJacobian, iDynTree::FrameVelocityRepresentation::MIXED_REPRESENTATION));
+    ASSERT_EQUAL_MATRIX(cachedFootJacobian, footJacobian);
+
+    // A copy of the current state, once edited, has to be recognized as a different state
+    iDynTree::Transform footTransform = sharedKinDyn->getWorldTransform(robotState, footFrame);
+    RobotState editedState = sharedKinDyn->currentState();
+    editedState.s(0) += 0.1;
+    iDynTree::Transform editedFootTransform = sharedKinDyn->getWorldTransform(editedState, footFrame);
+    ASSERT_IS_TRUE(!iDynTree::toEigen(editedFootTransform.getPosition()).isApprox(iDynTree::toEigen(footTransform.getPosition())));
+    ASSERT_EQUAL_TRANSFORM(editedFootTransform, sharedKinDyn->getWorldTransform(perturbedState, footFrame));
+
+    // The version is given by updateRobotState and it is not copied. It changes only when the stored state changes.
+    ASSERT_IS_TRUE(sharedKinDyn->updateRobotState(robotState));
+    ASSERT_IS_TRUE(robotState.version.value() == sharedKinDyn->stateVersion());
+    RobotState versionedCopy = robotState;
+    ASSERT_IS_TRUE(versionedCopy.version.value() == 0);
+    ASSERT_IS_TRUE(sharedKinDyn->updateRobotState(versionedCopy));
+    ASSERT_IS_TRUE(versionedCopy.version.value() == robotState.version.value());
+    versionedCopy = robotState;
+    versionedCopy.s(0) += 0.1;
+    ASSERT_IS_TRUE(sharedKinDyn->updateRobotState(versionedCopy));
+    ASSERT_IS_TRUE(versionedCopy.version.value() > robotState.version.value());
+    ASSERT_IS_TRUE(!sharedKinDyn->sameState(robotState));
+
+    // Benchmark: frame Jacobians queried with a versioned state, hence cached, against iDynTree's KinDynComputations, which computes them at every call
+    const unsigned int benchmarkIterations = 1000;
+    std::vector<iDynTree::FrameIndex> benchmarkFrames = {sharedKinDyn->model().getFrameIndex("l_sole"), sharedKinDyn->model().getFrameIndex("r_sole"),
+                                                         sharedKinDyn->model().getFrameIndex("l_hand"), sharedKinDyn->model().getFrameIndex("r_hand")};
+    iDynTree::MatrixDynSize cachedJacobian, genericJacobian;
+    iDynTree::KinDynComputations genericKinDyn;
+    ASSERT_IS_TRUE(genericKinDyn.loadRobotModel(sharedKinDyn->model()));
+    ASSERT_IS_TRUE(genericKinDyn.setFloatingBase(sharedKinDyn->getFloatingBase()));
+    ASSERT_IS_TRUE(genericKinDyn.setFrameVelocityRepresentation(iDynTree::FrameVelocityRepresentation::MIXED_REPRESENTATION));
+    iDynTree::Twist zeroBaseVelocity;
+    zeroBaseVelocity.zero();
+
+    ASSERT_IS_TRUE(sharedKinDyn->updateRobotState(robotState));
+    ASSERT_IS_TRUE(genericKinDyn.setRobotState(sharedKinDyn->getBaseTransform(robotState), robotState.s, zeroBaseVelocity, robotState.s_dot, sharedKinDyn->gravity()));
+    for (iDynTree::FrameIndex frame : benchmarkFrames) {
+        ASSERT_IS_TRUE(sharedKinDyn->getFrameFreeFloatingJacobian(robotState, frame, cachedJacobian, iDynTree::FrameVelocityRepresentation::MIXED_REPRESENTATION));
+        ASSERT_IS_TRUE(genericKinDyn.getFrameFreeFloatingJacobian(frame, genericJacobian));
+        ASSERT_EQUAL_MATRIX(cachedJacobian, genericJacobian);
+    }
+
+    bool ok = true;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < benchmarkIterations; ++i) {
+        for (iDynTree::FrameIndex frame : benchmarkFrames) {
+            ok = ok && sharedKinDyn->getFrameFreeFloatingJacobian(robotState, frame, cachedJacobian, iDynTree::FrameVelocityRepresentation::MIXED_REPRESENTATION);
+        }
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    ASSERT_IS_TRUE(ok);
+    double cachedTime = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / static_cast<double>(benchmarkIterations);
+
+    begin = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < benchmarkIterations; ++i) {
+        for (iDynTree::FrameIndex frame : benchmarkFrames) {
+            ok = ok && genericKinDyn.getFrameFreeFloatingJacobian(frame, genericJacobian);
+        }
+    }
+    end = std::chrono::steady_clock::now();
+    ASSERT_IS_TRUE(ok);
+    double genericTime = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() / static_cast<double>(benchmarkIterations);
+
+    std::cout << "Frame Jacobians (SharedKinDynComputations, cached): " << cachedTime << " us for " << benchmarkFrames.size() << " frames." << std::endl;
+    std::cout << "Frame Jacobians (KinDynComputations, computed at every call): " << genericTime << " us for " << benchmarkFrames.size() << " frames." << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -361,8 +361,18 @@ int main() {
     ok = solver.setOptimizer(optimizerTest);
     ASSERT_IS_TRUE(ok);
 
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
     ok = solver.specifySettings(settings);
     ASSERT_IS_TRUE(ok);
+    std::chrono::steady_clock::time_point end= std::chrono::steady_clock::now();
+    std::cout << "Elapsed time specifySettings (1st): " << (std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count())/1000.0 <<std::endl;
+
+    //Same model, hence the expressions derived by the first call are reused
+    begin = std::chrono::steady_clock::now();
+    ok = solver.specifySettings(settings);
+    ASSERT_IS_TRUE(ok);
+    end= std::chrono::steady_clock::now();
+    std::cout << "Elapsed time specifySettings (2nd): " << (std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count())/1000.0 <<std::endl;
 
     ok = solver.setInitialState(initialState);
     ASSERT_IS_TRUE(ok);
@@ -375,10 +385,10 @@ int main() {
     std::vector<DynamicalPlanner::State> optimalStates;
     std::vector<DynamicalPlanner::Control> optimalControls;
 
-    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    begin = std::chrono::steady_clock::now();
     ok = solver.solve(optimalStates, optimalControls);
     ASSERT_IS_TRUE(ok);
-    std::chrono::steady_clock::time_point end= std::chrono::steady_clock::now();
+    end= std::chrono::steady_clock::now();
     std::cout << "Elapsed time (1st): " << (std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count())/1000.0 <<std::endl;
 
     return EXIT_SUCCESS;
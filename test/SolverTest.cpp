@@ -20,7 +20,9 @@
 #include <FolderPath.h>
 #include <chrono>
 #include <ctime>
+#include <fstream>
 #include <sstream>
+#include <string>
 #include <iDynTree/Core/Utils.h>
 
 
@@ -454,6 +456,27 @@ public:
     }
 };
 
+size_t lastIpoptIterations(const std::string& outputFile) { //Ipopt writes the number of iterations in the summary of each solve
+    std::ifstream file(outputFile);
+    ASSERT_IS_TRUE(file.is_open());
+
+    const std::string key = "Number of Iterations....:";
+    std::string line;
+    size_t iterations = 0;
+    bool found = false;
+
+    while (std::getline(file, line)) {
+        size_t position = line.find(key);
+        if (position != std::string::npos) {
+            iterations = std::stoul(line.substr(position + key.size()));
+            found = true;
+        }
+    }
+
+    ASSERT_IS_TRUE(found);
+    return iterations;
+}
+
 int main() {
 
     DynamicalPlanner::Solver solver;
@@ -763,7 +786,6 @@ int main() {
     ok = ipoptSolver->setIpoptOption("warm_start_mult_bound_push", 1e-2);
     ok = ipoptSolver->setIpoptOption("warm_start_slack_bound_frac", 1e-2);
     ok = ipoptSolver->setIpoptOption("warm_start_slack_bound_push", 1e-2);
-    ok = ipoptSolver->setIpoptOption("warm_start_init_point", "yes");
 //    ok = ipoptSolver->setIpoptOption("warm_start_same_structure", "no");
 //    ok = ipoptSolver->setIpoptOption("expect_infeasible_problem", "yes");
     ok = ipoptSolver->setIpoptOption("required_infeasibility_reduction", 0.8);
@@ -815,10 +837,12 @@ int main() {
 //    ASSERT_IS_TRUE(ok);
 
     ok = solver.setOptimizer(ipoptSolver);
+    solver.usePrimalDualWarmStart(true);
     ASSERT_IS_TRUE(ok);
 
     ok = solver.specifySettings(settings);
     ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(solver.optimalStates().empty() && solver.optimalControls().empty()); //nothing has been solved yet
 
     ok = solver.setInitialState(initialState);
     ASSERT_IS_TRUE(ok);
@@ -905,6 +929,7 @@ int main() {
     visualizer.setCameraPosition(iDynTree::Position(2.0, 0.5, 0.5));
     double runningMean = 0;
     double currentDuration;
+    double elapsedTime = 0.0;
     for (size_t i = 0; i < 200; ++i) {
         double initialTime;
         initialState = mpcStates.back();
@@ -912,6 +937,8 @@ int main() {
         reconstructState(kinDyn, settingsStruct, initialState);
         ok = solver.setInitialState(initialState);
         ASSERT_IS_TRUE(ok);
+        ok = solver.setGuessesFromPreviousSolution(elapsedTime);
+        ASSERT_IS_TRUE(ok);
 //        iDynTree::toEigen(comReference->get()) += iDynTree::toEigen(iDynTree::Position(0.005, 0.005, 0.0));
         begin = std::chrono::steady_clock::now();
         ok = solver.solve(optimalStates, optimalControls);
@@ -924,6 +951,8 @@ int main() {
         std::cout << "Complementarity: " << maximumComplementarity(optimalStates.front()) << std::endl;
         std::cout << "Mean Time: " << runningMean << std::endl;
 
+        elapsedTime = optimalStates.front().time;
+
         mpcStates.push_back(optimalStates.front());
         mpcStates.back().time += initialTime;
         mpcControls.push_back(optimalControls.front());
@@ -981,6 +1010,183 @@ int main() {
 
     }
 
+    //Primal-dual warm start benchmark. The number of iterations of each solve is read from the Ipopt output file.
+    const std::string ipoptOutputFile = "SolverTestIpopt.out";
+    ok = ipoptSolver->setIpoptOption("output_file", ipoptOutputFile);
+    ASSERT_IS_TRUE(ok);
+    ok = ipoptSolver->setIpoptOption("file_print_level", 3);
+    ASSERT_IS_TRUE(ok);
+
+    initialState = mpcStates.back();
+    reconstructState(kinDyn, settingsStruct, initialState);
+    ok = solver.setInitialState(initialState);
+    ASSERT_IS_TRUE(ok);
+
+    size_t coldStartIterations = 0;
+    for (bool useMultipliers : {false, true}) {
+        solver.usePrimalDualWarmStart(useMultipliers);
+        if (!useMultipliers) {
+            std::string warmStartOption;
+            ok = ipoptSolver->getIpoptOption("warm_start_init_point", warmStartOption);
+            ASSERT_IS_TRUE(ok && (warmStartOption == "no"));
+        }
+        double benchmarkMean = 0;
+        size_t benchmarkSolves = 5;
+        size_t iterations = 0;
+        for (size_t i = 0; i < benchmarkSolves; ++i) {
+            ok = solver.setGuessesFromPreviousSolution(0.0);
+            ASSERT_IS_TRUE(ok);
+            begin = std::chrono::steady_clock::now();
+            ok = solver.solve(optimalStates, optimalControls);
+            ASSERT_IS_TRUE(ok);
+            end = std::chrono::steady_clock::now();
+            benchmarkMean += (std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count())/1000.0/benchmarkSolves;
+            iterations += lastIpoptIterations(ipoptOutputFile);
+        }
+        std::cout << "Mean time " << (useMultipliers ? "with" : "without") << " primal-dual warm start: " << benchmarkMean << std::endl;
+        std::cout << "Total iterations " << (useMultipliers ? "with" : "without") << " primal-dual warm start: " << iterations << std::endl;
+        if (useMultipliers) {
+            ASSERT_IS_TRUE(iterations <= coldStartIterations);
+        } else {
+            coldStartIterations = iterations;
+        }
+    }
+
+    //The multipliers cannot be shifted, hence they are not used together with a shifted guess
+    ok = solver.setGuessesFromPreviousSolution(settingsStruct.minimumDt);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.solve(optimalStates, optimalControls);
+    ASSERT_IS_TRUE(ok);
+    std::string shiftedWarmStartOption;
+    ok = ipoptSolver->getIpoptOption("warm_start_init_point", shiftedWarmStartOption);
+    ASSERT_IS_TRUE(ok && (shiftedWarmStartOption == "no"));
+
+    //Asynchronous solve: the solver rejects calls while running, and the last iterate is available after an interruption
+    ok = solver.setGuessesFromPreviousSolution(0.0);
+    ASSERT_IS_TRUE(ok);
+    std::future<DynamicalPlanner::SolutionStatus> asyncSolution = solver.solveAsync();
+    ASSERT_IS_TRUE(!solver.solve());
+    ASSERT_IS_TRUE(!solver.updateSettings(settings));
+    ASSERT_IS_TRUE(!solver.specifySettings(settings));
+    ASSERT_IS_TRUE(solver.solveAsync().get() == DynamicalPlanner::SolutionStatus::Failed);
+    solver.cancel();
+    ASSERT_IS_TRUE(asyncSolution.get() == DynamicalPlanner::SolutionStatus::Cancelled);
+    ASSERT_IS_TRUE(solver.lastSolutionStatus() == DynamicalPlanner::SolutionStatus::Cancelled);
+
+    ok = solver.setGuessesFromPreviousSolution(0.0);
+    ASSERT_IS_TRUE(ok);
+    asyncSolution = solver.solveAsync(std::chrono::steady_clock::now());
+    ASSERT_IS_TRUE(asyncSolution.get() == DynamicalPlanner::SolutionStatus::DeadlineReached);
+    ASSERT_IS_TRUE(solver.lastSolutionStatus() == DynamicalPlanner::SolutionStatus::DeadlineReached);
+
+    const std::vector<DynamicalPlanner::State>& interruptedStates = solver.optimalStates();
+    ASSERT_IS_TRUE(interruptedStates.size() == solver.optimalStatesView().size());
+    for (const DynamicalPlanner::State& state : interruptedStates) {
+        ASSERT_IS_TRUE(iDynTree::toEigen(state.comPosition).allFinite() && iDynTree::toEigen(state.jointsConfiguration).allFinite());
+    }
+    ok = solver.setGuessesFromPreviousSolution(0.0);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.solve(optimalStates, optimalControls);
+    ASSERT_IS_TRUE(ok);
+
+    //Real-time iterations: stopping at the iterations limit is fine, but an unusable iterate is not
+    ok = solver.setRealTimeIterations(1);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.setGuessesFromPreviousSolution(0.0);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.solve(optimalStates, optimalControls);
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE((solver.lastSolutionStatus() == DynamicalPlanner::SolutionStatus::IterationsLimitReached) ||
+                   (solver.lastSolutionStatus() == DynamicalPlanner::SolutionStatus::Solved));
+
+    DynamicalPlanner::State unreachableState = initialState;
+    unreachableState.comPosition(2) += 1.0;
+    ok = solver.setInitialState(unreachableState);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.setGuessesFromPreviousSolution(0.0);
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(!solver.solve());
+    ASSERT_IS_TRUE(solver.lastSolutionStatus() == DynamicalPlanner::SolutionStatus::Failed);
+
+    ok = solver.setRealTimeIterations(0);
+    ASSERT_IS_TRUE(ok);
+    std::string rtiWarmStartOption;
+    ok = ipoptSolver->getIpoptOption("warm_start_init_point", rtiWarmStartOption);
+    ASSERT_IS_TRUE(ok && (rtiWarmStartOption == "no")); //the multipliers of the failed solve are not used
+    ok = solver.setInitialState(initialState);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.setGuessesFromPreviousSolution(0.0); //the previous solution survives the failure
+    ASSERT_IS_TRUE(ok);
+    ok = solver.solve(optimalStates, optimalControls);
+    ASSERT_IS_TRUE(ok);
+
+    //Changing optimizer during the real-time iterations restores the iterations limit of the previous one
+    ok = solver.setRealTimeIterations(1);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.setOptimizer(std::make_shared<iDynTree::optimization::IpoptInterface>());
+    ASSERT_IS_TRUE(ok);
+    int restoredIterations = 0;
+    ok = ipoptSolver->getIpoptOption("max_iter", restoredIterations);
+    ASSERT_IS_TRUE(ok && (restoredIterations == 4000));
+    ok = solver.setOptimizer(ipoptSolver);
+    ASSERT_IS_TRUE(ok);
+
+    //Weights, references and friction are patched in place, hence the previous solution is still available
+    DynamicalPlanner::SettingsStruct updatedStruct = settingsStruct;
+    updatedStruct.comWeights(2) = 2.0 * settingsStruct.comWeights(2) + 1.0;
+    iDynTree::toEigen(comPointReference) += iDynTree::toEigen(iDynTree::Position(0.05, 0.0, 0.0));
+    updatedStruct.desiredCoMTrajectory = std::make_shared<iDynTree::optimalcontrol::TimeInvariantVector>(comPointReference);
+    updatedStruct.frictionCoefficient = 0.5;
+    DynamicalPlanner::Settings updatedSettings;
+    ok = updatedSettings.setFromStruct(updatedStruct);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.updateSettings(updatedSettings);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.setInitialState(initialState);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.setGuessesFromPreviousSolution(0.0);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.solve(optimalStates, optimalControls);
+    ASSERT_IS_TRUE(ok);
+
+    //Changing the number of points needs a new problem, as if specifySettings was called
+    size_t reducedPoints = settingsStruct.leftPointsPosition.size() - 1;
+    updatedStruct.leftPointsPosition.resize(reducedPoints);
+    updatedStruct.rightPointsPosition.resize(reducedPoints);
+    updatedStruct.desiredLeftRatios.assign(reducedPoints, 1.0 / reducedPoints);
+    updatedStruct.desiredRightRatios.assign(reducedPoints, 1.0 / reducedPoints);
+    ok = updatedSettings.setFromStruct(updatedStruct);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.updateSettings(updatedSettings);
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(!solver.setGuessesFromPreviousSolution(0.0));
+    ASSERT_IS_TRUE(!solver.setInitialState(initialState));
+
+    DynamicalPlanner::State reducedState = initialState;
+    reducedState.resize(vectorList.size(), reducedPoints);
+    ok = solver.setInitialState(reducedState);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.setGuesses(std::make_shared<StateGuess>(updatedStruct.desiredCoMTrajectory, reducedState),
+                           std::make_shared<DynamicalPlanner::TimeInvariantControl>(DynamicalPlanner::Control(vectorList.size(), reducedPoints)));
+    ASSERT_IS_TRUE(ok);
+    std::vector<DynamicalPlanner::State> reducedStates;
+    std::vector<DynamicalPlanner::Control> reducedControls;
+    ok = solver.solve(reducedStates, reducedControls);
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(reducedStates.size() && (reducedStates.front().leftContactPointsState.size() == reducedPoints));
+
+    //Without the exact Hessians, Ipopt approximates them. The other optimizers are rejected.
+    updatedStruct.useExactHessians = false;
+    ok = updatedSettings.setFromStruct(updatedStruct);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.updateSettings(updatedSettings);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.setGuessesFromPreviousSolution(0.0);
+    ASSERT_IS_TRUE(ok);
+    ok = solver.solve(reducedStates, reducedControls);
+    ASSERT_IS_TRUE(ok);
+    ASSERT_IS_TRUE(!solver.setOptimizer(worhpSolver));
+
     timeNow = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
     timeStruct = *std::localtime(&timeNow);
     timeString << timeStruct.tm_year + 1900 << "-" << timeStruct.tm_mon + 1<< "-";
@@ -64,6 +64,11 @@ void validateStaticForcesDerivative(RobotState& robotState, std::shared_ptr<Shar
         ASSERT_IS_TRUE(ok);
         jointTorquesPerturbed = generalizedTorques.jointTorques();
 
+        SharedKinDynComputations referenceKinDyn(*sharedKinDyn); //computes the accelerations of all the links from scratch
+        ok = referenceKinDyn.getStaticForces(perturbedState, linkExtForces, generalizedTorques);
+        ASSERT_IS_TRUE(ok);
+        ASSERT_EQUAL_VECTOR(jointTorquesPerturbed, generalizedTorques.jointTorques());
+
         firstOrderTaylor = jointTorques;
         iDynTree::toEigen(firstOrderTaylor) += iDynTree::toEigen(jointsDerivative) * (iDynTree::toEigen(perturbedState.s) -
                                                                                                iDynTree::toEigen(robotState.s));
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2018 Fondazione Istituto Italiano di Tecnologia
+ * Authors: Stefano Dafarra
+ * CopyPolicy: Released under the terms of the LGPLv2.1 or later, see LGPL.TXT
+ *
+ */
+
+#include <DynamicalPlanner/Trajectory.h>
+#include <iDynTree/Core/TestUtils.h>
+#include <iDynTree/Core/EigenHelpers.h>
+
+using namespace DynamicalPlanner;
+
+int main()
+{
+    const size_t knots = 5, dofs = 23, points = 4;
+
+    std::vector<State> states(knots, State(dofs, points)), obtainedStates;
+    std::vector<Control> controls(knots, Control(dofs, points)), obtainedControls;
+
+    for (size_t k = 0; k < knots; ++k) {
+        for (size_t i = 0; i < points; ++i) {
+            iDynTree::getRandomVector(states[k].leftContactPointsState[i].pointPosition);
+            iDynTree::getRandomVector(states[k].leftContactPointsState[i].pointForce);
+            iDynTree::getRandomVector(states[k].rightContactPointsState[i].pointPosition);
+            iDynTree::getRandomVector(states[k].rightContactPointsState[i].pointForce);
+            iDynTree::getRandomVector(controls[k].leftContactPointsControl[i].pointForceControl);
+            iDynTree::getRandomVector(controls[k].leftContactPointsControl[i].pointVelocityControl);
+            iDynTree::getRandomVector(controls[k].rightContactPointsControl[i].pointForceControl);
+            iDynTree::getRandomVector(controls[k].rightContactPointsControl[i].pointVelocityControl);
+        }
+        iDynTree::getRandomVector(states[k].momentumInCoM);
+        iDynTree::getRandomVector(states[k].comPosition);
+        states[k].worldToBaseTransform = iDynTree::getRandomTransform();
+        iDynTree::getRandomVector(states[k].jointsConfiguration);
+        states[k].time = 0.1 * k;
+
+        iDynTree::getRandomVector(controls[k].baseLinearVelocity);
+        iDynTree::getRandomVector(controls[k].baseQuaternionDerivative);
+        iDynTree::getRandomVector(controls[k].jointsVelocity);
+        controls[k].time = 0.1 * k;
+    }
+
+    StateTrajectory stateTrajectory;
+    ASSERT_IS_TRUE(stateTrajectory.fromStates(states));
+    ASSERT_IS_TRUE(stateTrajectory.size() == knots);
+    ASSERT_IS_TRUE(stateTrajectory.jointsConfigurationOverTime().size() == static_cast<long>(dofs * knots));
+
+    iDynTree::Vector3 comPosition;
+    for (size_t k = 0; k < knots; ++k) {
+        comPosition = stateTrajectory.comPositionOverTime().subspan(static_cast<long>(3 * k), 3);
+        ASSERT_EQUAL_VECTOR(comPosition, states[k].comPosition);
+        ASSERT_EQUAL_DOUBLE(stateTrajectory.timeOverTime()(static_cast<long>(k)), states[k].time);
+    }
+
+    stateTrajectory.toStates(obtainedStates);
+    ASSERT_IS_TRUE(obtainedStates.size() == knots);
+    for (size_t k = 0; k < knots; ++k) {
+        for (size_t i = 0; i < points; ++i) {
+            ASSERT_EQUAL_VECTOR(obtainedStates[k].leftContactPointsState[i].pointPosition, states[k].leftContactPointsState[i].pointPosition);
+            ASSERT_EQUAL_VECTOR(obtainedStates[k].rightContactPointsState[i].pointForce, states[k].rightContactPointsState[i].pointForce);
+        }
+        ASSERT_EQUAL_VECTOR(obtainedStates[k].momentumInCoM, states[k].momentumInCoM);
+        ASSERT_EQUAL_TRANSFORM_TOL(obtainedStates[k].worldToBaseTransform, states[k].worldToBaseTransform, 1e-10);
+        ASSERT_EQUAL_VECTOR(obtainedStates[k].jointsConfiguration, states[k].jointsConfiguration);
+        ASSERT_EQUAL_DOUBLE(obtainedStates[k].time, states[k].time);
+    }
+
+    State zeroQuaternionState;
+    iDynTree::toEigen(stateTrajectory.baseQuaternion(0)).setZero();
+    stateTrajectory.getState(0, zeroQuaternionState);
+    ASSERT_EQUAL_MATRIX(zeroQuaternionState.worldToBaseTransform.getRotation(), iDynTree::Rotation::Identity());
+
+    ControlTrajectory controlTrajectory;
+    ASSERT_IS_TRUE(controlTrajectory.fromControls(controls));
+    iDynTree::toEigen(controlTrajectory.jointsVelocity(2)).setZero();
+    controls[2].jointsVelocity.zero();
+
+    controlTrajectory.toControls(obtainedControls);
+    for (size_t k = 0; k < knots; ++k) {
+        for (size_t i = 0; i < points; ++i) {
+            ASSERT_EQUAL_VECTOR(obtainedControls[k].leftContactPointsControl[i].pointVelocityControl, controls[k].leftContactPointsControl[i].pointVelocityControl);
+            ASSERT_EQUAL_VECTOR(obtainedControls[k].rightContactPointsControl[i].pointForceControl, controls[k].rightContactPointsControl[i].pointForceControl);
+        }
+        ASSERT_EQUAL_VECTOR(obtainedControls[k].baseQuaternionDerivative, controls[k].baseQuaternionDerivative);
+        ASSERT_EQUAL_VECTOR(obtainedControls[k].jointsVelocity, controls[k].jointsVelocity);
+    }
+
+    states.push_back(State(dofs, points + 1));
+    ASSERT_IS_TRUE(!stateTrajectory.fromStates(states));
+
+    return EXIT_SUCCESS;
+}
@@ -6,6 +6,7 @@
  */
 
 #include <DynamicalPlannerPrivate/Utilities/VariablesLabeller.h>
+#include <DynamicalPlannerPrivate/Utilities/VariablesLayout.h>
 #include <iDynTree/Core/TestUtils.h>
 #include <iDynTree/Core/VectorDynSize.h>
 #include <iDynTree/Core/EigenHelpers.h>
@@ -58,8 +59,56 @@ int main()
     testVector = variables.values();
     ASSERT_EQUAL_VECTOR(testVector, fullVector);
 
+    iDynTree::VectorDynSize wrappedVector(9);
+    iDynTree::getRandomVector(wrappedVector);
+    range = variables.getIndexRange("part2");
+    VariablesLabeller copiedVariables;
+    {
+        VariablesLabeller::ScopedWrap wrappedVariables(variables, wrappedVector);
+        ASSERT_IS_TRUE(variables.isWrapping());
+        const VariablesLabeller& constVariables = variables;
+        testVector = constVariables.values();
+        ASSERT_EQUAL_VECTOR(testVector, wrappedVector);
+        testPart = wrappedVariables(range);
+        testVector.resize(3);
+        iDynTree::toEigen(testVector) = iDynTree::toEigen(wrappedVector).segment(range.offset, range.size);
+        ASSERT_EQUAL_VECTOR(testVector, testPart);
+        testPart = wrappedVariables("part2");
+        ASSERT_EQUAL_VECTOR(testVector, testPart);
+
+        copiedVariables = constVariables;
+        ASSERT_IS_TRUE(!copiedVariables.isWrapping());
+    }
+    ASSERT_IS_TRUE(!variables.isWrapping());
+    testVector.resize(9);
+    testVector = copiedVariables.values(); //the copy stored the wrapped values
+    ASSERT_EQUAL_VECTOR(testVector, wrappedVector);
+
+    //The labeller gets back its own values, and the writes through the non-const accessors are kept
+    testVector = variables.values();
+    ASSERT_EQUAL_VECTOR(testVector, fullVector);
+    iDynTree::toEigen(variables("part2")).setConstant(1.0);
+    testPart = variables(range);
+    testVector.resize(3);
+    iDynTree::toEigen(testVector).setConstant(1.0);
+    ASSERT_EQUAL_VECTOR(testVector, testPart);
+
     ASSERT_IS_TRUE(variables.listOfLabels().size() == 3);
 
+    VariablesLabeller stateVariables, controlVariables;
+    VariablesRanges addedRanges, obtainedRanges;
+    ASSERT_IS_TRUE(AddVariablesLayout(23, 4, stateVariables, controlVariables, addedRanges));
+    ASSERT_IS_TRUE(NumberOfFootPoints(stateVariables, "Left") == 4);
+    ASSERT_IS_TRUE(GetVariablesLayout(stateVariables, controlVariables, obtainedRanges));
+    ASSERT_IS_TRUE(obtainedRanges.right.forceControlPoints.size() == 4);
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_IS_TRUE(obtainedRanges.right.positionPoints[i].offset == addedRanges.right.positionPoints[i].offset);
+        ASSERT_IS_TRUE(obtainedRanges.left.velocityControlPoints[i].offset == addedRanges.left.velocityControlPoints[i].offset);
+    }
+    ASSERT_IS_TRUE(obtainedRanges.jointsPosition.offset == addedRanges.jointsPosition.offset);
+    ASSERT_IS_TRUE(obtainedRanges.jointsVelocity.size == 23);
+    ASSERT_IS_TRUE(stateVariables.size() == 4 * 2 * 6 + 16 + 23);
+
 
     return EXIT_SUCCESS;
 }
@@ -18,6 +18,7 @@
 #include <iDynTree/Core/Rotation.h>
 #include <iDynTree/ModelIO/ModelLoader.h>
 
+#include <algorithm>
 #include <cmath>
 #include <chrono>
 #include <iostream>
@@ -455,6 +456,50 @@ void validateQuaternionError(std::shared_ptr<TimelySharedKinDynComputations> tim
 
 }
 
+void validateServerReuse(std::shared_ptr<TimelySharedKinDynComputations> timelySharedKinDyn, double time) {
+    std::shared_ptr<ExpressionsServer> expressionsServer = std::make_shared<ExpressionsServer>(timelySharedKinDyn);
+    levi::Expression adjoint = expressionsServer->adjointTransform("root_link", "l_sole");
+
+    std::shared_ptr<TimelySharedKinDynComputations> newTimelySharedKinDyn = std::make_shared<TimelySharedKinDynComputations>();
+    configureSharedKinDyn(newTimelySharedKinDyn);
+    ASSERT_IS_TRUE(expressionsServer->setTimelySharedKinDyn(newTimelySharedKinDyn));
+
+    RobotState robotState = RandomRobotState(newTimelySharedKinDyn->model());
+    expressionsServer->updateRobotState(time, robotState);
+    iDynTree::Matrix6x6 evalBuffer;
+    iDynTree::toEigen(evalBuffer) = expressionsServer->adjointTransform("root_link", "l_sole").evaluate();
+    ASSERT_EQUAL_MATRIX(evalBuffer, newTimelySharedKinDyn->get(time)->getRelativeTransform(robotState, "root_link", "l_sole").asAdjointTransform());
+
+    const iDynTree::Model& model = newTimelySharedKinDyn->model();
+    std::shared_ptr<TimelySharedKinDynComputations> otherBaseKinDyn = std::make_shared<TimelySharedKinDynComputations>();
+    ASSERT_IS_TRUE(otherBaseKinDyn->loadRobotModel(model));
+    ASSERT_IS_TRUE(otherBaseKinDyn->setFloatingBase(model.getLinkName(model.getFrameLink(model.getFrameIndex("l_sole")))));
+    ASSERT_IS_TRUE(!expressionsServer->setTimelySharedKinDyn(otherBaseKinDyn));
+}
+
+void validateChainJoints(std::shared_ptr<TimelySharedKinDynComputations> timelySharedKinDyn, double time) {
+    RobotState robotState = RandomRobotState(timelySharedKinDyn->model());
+    ExpressionsServer expressionServer(timelySharedKinDyn);
+    expressionServer.updateRobotState(time, robotState);
+
+    iDynTree::FrameIndex baseFrame = timelySharedKinDyn->model().getFrameIndex("l_sole");
+    iDynTree::FrameIndex targetFrame = timelySharedKinDyn->model().getFrameIndex("r_sole");
+    const std::vector<size_t>& chain = expressionServer.chainJoints(baseFrame, targetFrame);
+    ASSERT_IS_TRUE(chain.size() > 0);
+    ASSERT_IS_TRUE(chain.size() < robotState.s.size());
+    ASSERT_IS_TRUE(expressionServer.chainJoints(baseFrame, baseFrame).empty());
+
+    iDynTree::MatrixDynSize relativeJacobian(6, robotState.s.size());
+    bool ok = timelySharedKinDyn->get(time)->getRelativeJacobian(robotState, baseFrame, targetFrame, relativeJacobian,
+                                                                 iDynTree::FrameVelocityRepresentation::MIXED_REPRESENTATION);
+    ASSERT_IS_TRUE(ok);
+
+    for (Eigen::Index joint = 0; joint < robotState.s.size(); ++joint) {
+        bool inChain = std::find(chain.begin(), chain.end(), static_cast<size_t>(joint)) != chain.end();
+        ASSERT_IS_TRUE(inChain || iDynTree::toEigen(relativeJacobian).col(joint).isZero());
+    }
+}
+
 int main() {
 
     std::shared_ptr<TimelySharedKinDynComputations> timelySharedKinDyn = std::make_shared<TimelySharedKinDynComputations>();
@@ -488,5 +533,9 @@ int main() {
 
     validateQuaternionError(timelySharedKinDyn, 0.0);
 
+    validateServerReuse(timelySharedKinDyn, 1.0);
+
+    validateChainJoints(timelySharedKinDyn, 0.0);
+
     return 0;
 }